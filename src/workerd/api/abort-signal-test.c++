@@ -0,0 +1,169 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/api/basics.h>
+#include <workerd/api/http.h>
+#include <workerd/io/observer.h>
+#include <workerd/tests/test-fixture.h>
+
+#include <kj/test.h>
+
+namespace workerd::api {
+namespace {
+
+kj::Exception disconnected() {
+  return JSG_KJ_EXCEPTION(DISCONNECTED, DOMAbortError, "The client has disconnected");
+}
+
+KJ_TEST("LazyAbortSignal aborted before use is allocated already aborted") {
+  TestFixture fixture;
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    auto lazy = kj::refcounted<LazyAbortSignal>(AbortSignal::Flag::NONE);
+
+    KJ_EXPECT(!lazy->needsLockToAbort());
+    lazy->abort(disconnected());
+
+    auto signal = lazy->get(js);
+    KJ_EXPECT(signal->getAborted(js));
+    KJ_EXPECT(js.exceptionToKj(signal->getReason(js))
+                  .getDescription()
+                  .contains("The client has disconnected"));
+    KJ_EXPECT(lazy->get(js).get() == signal.get());
+  });
+}
+
+KJ_TEST("LazyAbortSignal without listeners is aborted without the isolate lock") {
+  TestFixture fixture;
+  fixture.runInIoContext([&](const TestFixture::Environment& env) -> kj::Promise<void> {
+    auto& js = env.js;
+    auto lazy = kj::refcounted<LazyAbortSignal>(AbortSignal::Flag::NONE);
+    auto signal = lazy->get(js);
+    auto promise = signal->wrap(js, kj::Promise<void>(kj::NEVER_DONE));
+
+    KJ_EXPECT(!lazy->needsLockToAbort());
+    lazy->abort(disconnected());
+
+    // The reason is filled in when JavaScript looks at the signal.
+    KJ_EXPECT(signal->getAborted(js));
+    KJ_EXPECT(js.exceptionToKj(signal->getReason(js))
+                  .getDescription()
+                  .contains("The client has disconnected"));
+
+    return promise.then([]() { KJ_FAIL_EXPECT("wrapped promise should have been canceled"); },
+        [](kj::Exception&& e) {
+      KJ_EXPECT(e.getDescription().contains("The client has disconnected"));
+    });
+  });
+}
+
+KJ_TEST("LazyAbortSignal with listeners is aborted under the isolate lock") {
+  TestFixture fixture;
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    auto lazy = kj::refcounted<LazyAbortSignal>(AbortSignal::Flag::NONE);
+    auto signal = lazy->get(js);
+
+    uint called = 0;
+    auto handler = signal->newNativeHandler(
+        js, kj::str("abort"), [&](jsg::Lock&, jsg::Ref<Event>) { ++called; }, true);
+
+    KJ_EXPECT(lazy->needsLockToAbort());
+    lazy->abort(js, disconnected());
+    KJ_EXPECT(called == 1);
+    KJ_EXPECT(signal->getAborted(js));
+  });
+}
+
+KJ_TEST("Request allocates its lazy signal when it is first used") {
+  TestFixture fixture;
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    auto lazy = kj::refcounted<LazyAbortSignal>(AbortSignal::Flag::IGNORE_FOR_SUBREQUESTS);
+    auto request = js.alloc<Request>(js, kj::HttpMethod::GET, "https://example.com"_kj,
+        Request::Redirect::MANUAL, js.alloc<Headers>(), kj::none, kj::none, CfProperty(),
+        kj::none, kj::none);
+    request->setLazySignal(kj::addRef(*lazy));
+
+    auto signal = request->getThisSignal(js);
+    KJ_EXPECT(!signal->getNeverAborts());
+    KJ_EXPECT(lazy->get(js).get() == signal.get());
+    KJ_EXPECT(KJ_ASSERT_NONNULL(request->getSignal(js)).get() == signal.get());
+
+    // The incoming request's signal isn't passed on to subrequests.
+    request->clearSignalIfIgnoredForSubrequest(js);
+    KJ_EXPECT(request->getSignal(js) == kj::none);
+  });
+}
+
+struct NullSpanObserver final: public SpanObserver {
+  kj::Own<SpanObserver> newChild() override {
+    return kj::refcounted<NullSpanObserver>();
+  }
+  void report(const Span& span) override {}
+};
+
+// Counts the waitUntil() tasks that the request adds. These are only reported for a request
+// whose span is observed.
+struct WaitUntilCounter final: public RequestObserver {
+  explicit WaitUntilCounter(uint& count): count(count) {}
+
+  SpanParent getSpan() override {
+    return SpanParent(kj::Own<SpanObserver>(kj::refcounted<NullSpanObserver>()));
+  }
+  kj::Own<void> addedWaitUntilTask() override {
+    ++count;
+    return {};
+  }
+
+  uint& count;
+};
+
+// Runs a request to `module`, which never responds, and disconnects the client. Returns the
+// number of waitUntil() tasks that the request added.
+uint countWaitUntilTasksOnDisconnect(kj::StringPtr module) {
+  capnp::MallocMessageBuilder message;
+  auto flags = message.initRoot<CompatibilityFlags>();
+  flags.setEnableRequestSignal(true);
+
+  auto io = kj::setupAsyncIo();
+  TestFixture fixture(
+      {.waitScope = io.waitScope, .featureFlags = flags.asReader(), .mainModuleSource = module});
+
+  uint count = 0;
+  auto request =
+      fixture.startRequest("http://www.example.com", kj::refcounted<WaitUntilCounter>(count));
+  io.waitScope.poll();
+  KJ_EXPECT(count == 0);
+
+  request = nullptr;
+  io.waitScope.poll();
+  return count;
+}
+
+KJ_TEST("Disconnecting a request that never used its signal adds no waitUntil() task") {
+  auto count = countWaitUntilTasksOnDisconnect(R"SCRIPT(
+    export default {
+      fetch(request) {
+        return new Promise(() => setTimeout(() => {}, 60000));
+      },
+    };
+  )SCRIPT"_kj);
+  KJ_EXPECT(count == 0);
+}
+
+KJ_TEST("Disconnecting a request with an abort listener aborts its signal in a waitUntil() task") {
+  auto count = countWaitUntilTasksOnDisconnect(R"SCRIPT(
+    export default {
+      fetch(request) {
+        request.signal.addEventListener('abort', () => {});
+        return new Promise(() => setTimeout(() => {}, 60000));
+      },
+    };
+  )SCRIPT"_kj);
+  KJ_EXPECT(count == 1);
+}
+
+}  // namespace
+}  // namespace workerd::api
@@ -17,6 +17,7 @@
 #include <workerd/jsg/jsg.h>
 #include <workerd/jsg/ser.h>
 #include <workerd/jsg/util.h>
+#include <workerd/util/use-perfetto-categories.h>
 
 #include <v8.h>
 
@@ -598,6 +599,8 @@ jsg::Promise<int> DurableObjectStorageOperations::deleteMultiple(
 }
 
 ActorCacheOps& DurableObjectStorage::getCache(OpName op) {
+  TRACE_EVENT_INSTANT("workerd.storage", "DurableObjectStorage operation", "op", op.cStr(),
+      PERFETTO_FLOW_FROM_POINTER(IoContext::current().getPerfettoFlowId()));
   return *cache;
 }
 
@@ -785,6 +788,8 @@ jsg::Optional<jsg::Ref<DurableObject>> DurableObjectStorage::getPrimary(jsg::Loc
 }
 
 ActorCacheOps& DurableObjectTransaction::getCache(OpName op) {
+  TRACE_EVENT_INSTANT("workerd.storage", "DurableObjectTransaction operation", "op", op.cStr(),
+      PERFETTO_FLOW_FROM_POINTER(IoContext::current().getPerfettoFlowId()));
   JSG_REQUIRE(!rolledBack, Error, kj::str("Cannot ", op, " on rolled back transaction"));
   auto& result = *JSG_REQUIRE_NONNULL(cacheTxn, Error,
       kj::str("Cannot call ", op,
@@ -654,6 +654,7 @@ bool AbortSignal::getAborted(jsg::Lock& js) {
 }
 
 jsg::JsValue AbortSignal::getReason(jsg::Lock& js) {
+  fillInReason(js);
   KJ_IF_SOME(r, reason) {
     return r.getHandle(js);
   }
@@ -691,6 +692,7 @@ jsg::Ref<AbortSignal> AbortSignal::abort(jsg::Lock& js, jsg::Optional<jsg::JsVal
 
 void AbortSignal::throwIfAborted(jsg::Lock& js) {
   if (canceler->isCanceled()) {
+    fillInReason(js);
     KJ_IF_SOME(r, reason) {
       js.throwException(r.getHandle(js));
     } else {
@@ -782,6 +784,18 @@ RefcountedCanceler& AbortSignal::getCanceler() {
   return *canceler;
 }
 
+bool AbortSignal::hasAbortListeners() const {
+  return getHandlerCount("abort"_kj) > 0 || onAbortHandler != kj::none || !rpcClients.empty();
+}
+
+void AbortSignal::fillInReason(jsg::Lock& js) {
+  if (reason == kj::none) {
+    KJ_IF_SOME(exception, canceler->getReason()) {
+      reason = js.exceptionToJsValue(kj::cp(exception));
+    }
+  }
+}
+
 void AbortSignal::triggerAbort(
     jsg::Lock& js, jsg::Optional<kj::OneOf<kj::Exception, jsg::JsValue>> maybeReason) {
   KJ_ASSERT(flag != Flag::NEVER_ABORTS);
@@ -840,6 +854,7 @@ void AbortSignal::serialize(jsg::Lock& js, jsg::Serializer& serializer) {
   JSG_REQUIRE(
       externalHandler != nullptr, DOMDataCloneError, "AbortSignal can only be serialized for RPC.");
 
+  fillInReason(js);
   serializer.writeRawUint32(static_cast<uint>(canceler->isCanceled()));
   serializer.writeRawUint32(static_cast<uint>(flag));
   KJ_IF_SOME(r, reason) {
@@ -986,6 +1001,43 @@ void AbortController::abort(jsg::Lock& js, jsg::Optional<jsg::JsValue> maybeReas
   signal->triggerAbort(js, maybeReason);
 }
 
+jsg::Ref<AbortSignal> LazyAbortSignal::get(jsg::Lock& js) {
+  KJ_IF_SOME(s, signal) {
+    return s.addRef();
+  }
+
+  auto newSignal = js.alloc<AbortSignal>(kj::cp(abortedBeforeUse),
+      abortedBeforeUse.map([&](kj::Exception& e) { return js.exceptionToJsValue(kj::cp(e)); }),
+      flag);
+  canceler = kj::addRef(newSignal->getCanceler());
+  signal = newSignal.addRef();
+  return newSignal;
+}
+
+bool LazyAbortSignal::needsLockToAbort() const {
+  KJ_IF_SOME(s, signal) {
+    return s->hasAbortListeners();
+  }
+  return false;
+}
+
+void LazyAbortSignal::abort(kj::Exception exception) {
+  KJ_REQUIRE(!needsLockToAbort());
+  KJ_IF_SOME(c, canceler) {
+    c->cancel(exception);
+  } else if (abortedBeforeUse == kj::none) {
+    abortedBeforeUse = kj::mv(exception);
+  }
+}
+
+void LazyAbortSignal::abort(jsg::Lock& js, kj::Exception exception) {
+  KJ_IF_SOME(s, signal) {
+    s->triggerAbort(js, kj::mv(exception));
+  } else if (abortedBeforeUse == kj::none) {
+    abortedBeforeUse = kj::mv(exception);
+  }
+}
+
 void EventTarget::visitForGc(jsg::GcVisitor& visitor) {
   for (auto& entry: typeMap) {
     for (auto& handler: entry.value.handlers) {
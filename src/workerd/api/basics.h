@@ -549,6 +549,11 @@ class AbortSignal final: public EventTarget {
     return flag == Flag::NEVER_ABORTS;
   }
 
+  // True if aborting this signal would run JavaScript or notify an RPC peer: it has `abort`
+  // listeners or an `onabort` handler (AbortSignal.any() adds a listener to each signal it
+  // follows), or it has been sent over RPC.
+  bool hasAbortListeners() const;
+
   // The static abort() function here returns an AbortSignal that
   // has been pre-emptively aborted. It's useful when it might still
   // be desirable to kick off an async process while communicating
@@ -655,6 +660,10 @@ class AbortSignal final: public EventTarget {
   static kj::Exception abortException(
       jsg::Lock& js, jsg::Optional<kj::OneOf<kj::Exception, jsg::JsValue>> reason);
 
+  // If the canceler was canceled directly, without the isolate lock (see LazyAbortSignal), fills
+  // in `reason` from the canceler's exception.
+  void fillInReason(jsg::Lock& js);
+
   void visitForGc(jsg::GcVisitor& visitor);
 
   friend class AbortController;
@@ -731,6 +740,38 @@ class AbortController final: public jsg::Object {
   }
 };
 
+// The signal of an incoming request, which is only allocated once something asks for it. Most
+// fetch handlers never look at `request.signal`, so this saves allocating the signal and, when
+// the client disconnects, re-entering the isolate just to abort it.
+class LazyAbortSignal final: public kj::Refcounted {
+ public:
+  explicit LazyAbortSignal(AbortSignal::Flag flag): flag(flag) {}
+
+  // Returns the signal, allocating it on first use. If the signal was aborted before that, it is
+  // allocated already aborted.
+  jsg::Ref<AbortSignal> get(jsg::Lock& js);
+
+  // True if abort() has to be called with the isolate lock held, because the signal has been
+  // allocated and aborting it would run JavaScript. See AbortSignal::hasAbortListeners().
+  bool needsLockToAbort() const;
+
+  // Aborts the signal. Unless needsLockToAbort(), this doesn't touch the isolate: it cancels
+  // whatever the signal is wrapping, and the signal's `reason` is filled in when JavaScript next
+  // looks at it.
+  void abort(kj::Exception exception);
+  void abort(jsg::Lock& js, kj::Exception exception);
+
+ private:
+  AbortSignal::Flag flag;
+  kj::Maybe<jsg::Ref<AbortSignal>> signal;
+
+  // The allocated signal's canceler, which we can use outside of the IoContext.
+  kj::Maybe<kj::Own<RefcountedCanceler>> canceler;
+
+  // Set if the signal was aborted before it was allocated.
+  kj::Maybe<kj::Exception> abortedBeforeUse;
+};
+
 // The scheduler class is an emerging web platform standard API that is meant
 // to be global and provides task scheduling APIs. We currently only implement
 // a subset of the API that is being defined.
@@ -60,15 +60,22 @@ class HmacKey final: public CryptoKey::Impl {
     auto type = lookupDigestAlgorithm(keyAlgorithm.hash.name).second;
     auto messageDigest = jsg::BackingStore::alloc<v8::ArrayBuffer>(js, EVP_MD_size(type));
 
+    auto ctx = OSSL_NEW(HMAC_CTX);
+    schedule.init(ctx.get(), type, keyData);
     uint messageDigestSize = 0;
-    auto ptr = HMAC(type, keyData.begin(), keyData.size(), data.begin(), data.size(),
-        messageDigest.asArrayPtr().begin(), &messageDigestSize);
-    JSG_REQUIRE(ptr != nullptr, DOMOperationError, "HMAC computation failed.");
+    JSG_REQUIRE(HMAC_Update(ctx.get(), data.begin(), data.size()) == 1 &&
+            HMAC_Final(ctx.get(), messageDigest.asArrayPtr().begin(), &messageDigestSize) == 1,
+        DOMOperationError, "HMAC computation failed.");
 
     KJ_ASSERT(messageDigestSize == messageDigest.size());
     return jsg::BufferSource(js, kj::mv(messageDigest));
   }
 
+  bool initHmac(HMAC_CTX* ctx, const EVP_MD* md) const override {
+    schedule.init(ctx, md, keyData);
+    return true;
+  }
+
   SubtleCrypto::ExportKeyData exportKey(jsg::Lock& js, kj::StringPtr format) const override {
     JSG_REQUIRE(format == "raw" || format == "jwk", DOMNotSupportedError,
         "Unimplemented key export format \"", format, "\".");
@@ -121,6 +128,9 @@ class HmacKey final: public CryptoKey::Impl {
 
   ZeroOnFree keyData;
   CryptoKey::HmacKeyAlgorithm keyAlgorithm;
+
+  // Mutable because it is built on first use, by const operations.
+  mutable HmacKeySchedule schedule;
 };
 
 void zeroOutTrailingKeyBits(kj::Array<kj::byte>& keyDataArray, int keyBitLength) {
@@ -137,11 +147,12 @@ void zeroOutTrailingKeyBits(kj::Array<kj::byte>& keyDataArray, int keyBitLength)
 
 kj::Own<HMAC_CTX> initHmacContext(
     jsg::Lock& js, kj::StringPtr algorithm, HmacContext::KeyData& key) {
-  static constexpr auto handle = [](kj::StringPtr algorithm, kj::ArrayPtr<kj::byte> key) {
-    ClearErrorOnReturn clearErrorOnReturn;
+  ClearErrorOnReturn clearErrorOnReturn;
+  const EVP_MD* md = EVP_get_digestbyname(algorithm.begin());
+  JSG_REQUIRE(md != nullptr, Error, "Digest method not supported");
+
+  auto handle = [md](kj::ArrayPtr<kj::byte> key) {
     JSG_REQUIRE(key.size() <= INT_MAX, RangeError, "key is too long");
-    const EVP_MD* md = EVP_get_digestbyname(algorithm.begin());
-    JSG_REQUIRE(md != nullptr, Error, "Digest method not supported");
     static constexpr auto mt = ""_kjc;
     auto hmac_ctx = OSSL_NEW(HMAC_CTX);
     JSG_REQUIRE(HMAC_Init_ex(hmac_ctx.get(), key.size() ? key.asChars().begin() : mt.begin(),
@@ -152,15 +163,21 @@ kj::Own<HMAC_CTX> initHmacContext(
 
   KJ_SWITCH_ONEOF(key) {
     KJ_CASE_ONEOF(buf, kj::ArrayPtr<kj::byte>) {
-      return handle(algorithm, buf);
+      return handle(buf);
     }
     KJ_CASE_ONEOF(key2, CryptoKey::Impl*) {
+      // Keys that are reused for many HMACs keep a copy of the context with the key mixed in.
+      auto hmac_ctx = OSSL_NEW(HMAC_CTX);
+      if (key2->initHmac(hmac_ctx.get(), md)) {
+        return kj::mv(hmac_ctx);
+      }
+
       // We already checked that the key is a secret key, so the following should succeed.
       SubtleCrypto::ExportKeyData keyData = key2->exportKey(js, "raw"_kj);
 
       KJ_SWITCH_ONEOF(keyData) {
         KJ_CASE_ONEOF(key_data, jsg::BufferSource) {
-          return handle(algorithm, key_data);
+          return handle(key_data);
         }
         KJ_CASE_ONEOF(jwk, SubtleCrypto::JsonWebKey) {
           KJ_UNREACHABLE;
@@ -172,6 +189,21 @@ kj::Own<HMAC_CTX> initHmacContext(
 }
 }  // namespace
 
+void HmacKeySchedule::init(HMAC_CTX* ctx, const EVP_MD* md, kj::ArrayPtr<const kj::byte> key) {
+  if (this->md != md || keyed == kj::none) {
+    JSG_REQUIRE(key.size() <= INT_MAX, RangeError, "key is too long");
+    // HMAC_Init_ex() treats a null key as "keep the previous key", so an empty key still needs a
+    // non-null pointer.
+    static constexpr kj::byte empty = 0;
+    auto newKeyed = OSSL_NEW(HMAC_CTX);
+    OSSLCALL(
+        HMAC_Init_ex(newKeyed.get(), key.size() ? key.begin() : &empty, key.size(), md, nullptr));
+    keyed = kj::mv(newKeyed);
+    this->md = md;
+  }
+  OSSLCALL(HMAC_CTX_copy_ex(ctx, KJ_ASSERT_NONNULL(keyed).get()));
+}
+
 HmacContext::HmacContext(jsg::Lock& js, kj::StringPtr algorithm, KeyData key)
     : state(initHmacContext(js, algorithm, key)) {}
 
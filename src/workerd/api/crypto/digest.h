@@ -7,6 +7,21 @@
 KJ_DECLARE_NON_POLYMORPHIC(HMAC_CTX)
 
 namespace workerd::api {
+
+// Keeps an HMAC_CTX into which a key has already been mixed, so that each HMAC computed with the
+// same key can start from a copy instead of hashing the key into the inner and outer pads again.
+// Built on first use.
+class HmacKeySchedule final {
+ public:
+  // Sets up `ctx`, which must be newly allocated, to compute an HMAC of `md` keyed with `key`.
+  // `key` must be the same on every call. If `md` changes, the schedule is rebuilt for it.
+  void init(HMAC_CTX* ctx, const EVP_MD* md, kj::ArrayPtr<const kj::byte> key);
+
+ private:
+  const EVP_MD* md = nullptr;
+  kj::Maybe<kj::Own<HMAC_CTX>> keyed;
+};
+
 class HmacContext final {
  public:
   using KeyData = kj::OneOf<kj::ArrayPtr<kj::byte>, CryptoKey::Impl*>;
@@ -696,10 +696,10 @@ kj::Own<CryptoKey::Impl> CryptoKey::Impl::importEcdsa(jsg::Lock& js,
 
   auto [normalizedNamedCurve, curveId, rsSize] = lookupEllipticCurve(namedCurve);
 
-  auto importedKey = [&, curveId = curveId] {
+  auto importedKey = [&, curveId = curveId, normalizedNamedCurve = normalizedNamedCurve] {
     if (format != "raw") {
-      return importAsymmetricForWebCrypto(js, format, kj::mv(keyData), normalizedName, extractable,
-          keyUsages,
+      return importAsymmetricForWebCrypto(js, format, kj::mv(keyData), normalizedName,
+          normalizedNamedCurve, extractable, keyUsages,
           // Verbose lambda capture needed because: https://bugs.llvm.org/show_bug.cgi?id=35984
           [curveId = curveId, normalizedName = kj::str(normalizedName)](
               SubtleCrypto::JsonWebKey keyDataJwk) -> kj::Own<EVP_PKEY> {
@@ -754,13 +754,13 @@ kj::Own<CryptoKey::Impl> CryptoKey::Impl::importEcdh(jsg::Lock& js,
 
   auto [normalizedNamedCurve, curveId, rsSize] = lookupEllipticCurve(namedCurve);
 
-  auto importedKey = [&, curveId = curveId] {
+  auto importedKey = [&, curveId = curveId, normalizedNamedCurve = normalizedNamedCurve] {
     auto strictCrypto = FeatureFlags::get(js).getStrictCrypto();
     auto usageSet = strictCrypto ? CryptoKeyUsageSet() : CryptoKeyUsageSet::derivationKeyMask();
 
     if (format != "raw") {
-      return importAsymmetricForWebCrypto(js, format, kj::mv(keyData), normalizedName, extractable,
-          keyUsages,
+      return importAsymmetricForWebCrypto(js, format, kj::mv(keyData), normalizedName,
+          normalizedNamedCurve, extractable, keyUsages,
           // Verbose lambda capture needed because: https://bugs.llvm.org/show_bug.cgi?id=35984
           [curveId = curveId, normalizedName = kj::str(normalizedName)](
               SubtleCrypto::JsonWebKey keyDataJwk) -> kj::Own<EVP_PKEY> {
@@ -1165,8 +1165,8 @@ kj::Own<CryptoKey::Impl> CryptoKey::Impl::importEddsa(jsg::Lock& js,
   auto importedKey = [&] {
     auto nid = normalizedName == "X25519" ? NID_X25519 : NID_ED25519;
     if (format != "raw") {
-      return importAsymmetricForWebCrypto(js, format, kj::mv(keyData), normalizedName, extractable,
-          keyUsages,
+      return importAsymmetricForWebCrypto(js, format, kj::mv(keyData), normalizedName, nullptr,
+          extractable, keyUsages,
           [nid, normalizedName = kj::str(normalizedName)](
               SubtleCrypto::JsonWebKey keyDataJwk) -> kj::Own<EVP_PKEY> {
         return ellipticJwkReader(nid, kj::mv(keyDataJwk), normalizedName);
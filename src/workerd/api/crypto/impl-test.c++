@@ -3,9 +3,11 @@
 //     https://opensource.org/licenses/Apache-2.0
 
 #include "impl.h"
+#include "keys.h"
 
 #include <openssl/ec.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
 #include <openssl/rsa.h>
 
 #include <kj/test.h>
@@ -34,5 +36,61 @@ KJ_TEST("Crypto error conversion") {
   KJ_EXPECT_THROW_MESSAGE("jsg.DOMException(OperationError): Invalid point encoding.", OSSLCALL(0));
 }
 
+KJ_TEST("ImportedKeyCache reuses parsed keys") {
+  ImportedKeyCache cache;
+  uint parses = 0;
+  auto parse = [&]() {
+    ++parses;
+    return OSSL_NEW(EVP_PKEY);
+  };
+
+  auto key1 = cache.getOrParse(kj::str("spki RSA-PSS a"), parse);
+  auto key2 = cache.getOrParse(kj::str("spki RSA-PSS a"), parse);
+  KJ_EXPECT(parses == 1);
+  KJ_EXPECT(key1.get() == key2.get());
+
+  // Each caller holds its own reference, so dropping one doesn't affect the others.
+  key1 = nullptr;
+  auto key3 = cache.getOrParse(kj::str("spki RSA-PSS a"), parse);
+  KJ_EXPECT(key3.get() == key2.get());
+
+  auto other = cache.getOrParse(kj::str("spki RSA-PSS b"), parse);
+  KJ_EXPECT(parses == 2);
+  KJ_EXPECT(other.get() != key2.get());
+
+  // Failures aren't cached.
+  KJ_EXPECT_THROW_MESSAGE("bad key", cache.getOrParse(kj::str("spki RSA-PSS c"), [&]() {
+    ++parses;
+    return OSSLCALL_OWN(EVP_PKEY, nullptr, DOMDataError, "bad key");
+  }));
+  cache.getOrParse(kj::str("spki RSA-PSS c"), parse);
+  KJ_EXPECT(parses == 4);
+}
+
+KJ_TEST("ImportedKeyCache drops the least recently used key when full") {
+  ImportedKeyCache cache;
+  uint parses = 0;
+  auto parse = [&]() {
+    ++parses;
+    return OSSL_NEW(EVP_PKEY);
+  };
+
+  for (auto i: kj::zeroTo(ImportedKeyCache::MAX_ENTRIES)) {
+    cache.getOrParse(kj::str(i), parse);
+  }
+  KJ_EXPECT(parses == ImportedKeyCache::MAX_ENTRIES);
+
+  // Use the first key again, so that the second is now the least recently used.
+  cache.getOrParse(kj::str(0), parse);
+  cache.getOrParse(kj::str("new"), parse);
+  KJ_EXPECT(cache.size() == ImportedKeyCache::MAX_ENTRIES);
+  KJ_EXPECT(parses == ImportedKeyCache::MAX_ENTRIES + 1);
+
+  cache.getOrParse(kj::str(0), parse);
+  KJ_EXPECT(parses == ImportedKeyCache::MAX_ENTRIES + 1);
+  cache.getOrParse(kj::str(1), parse);
+  KJ_EXPECT(parses == ImportedKeyCache::MAX_ENTRIES + 2);
+}
+
 }  // namespace
 }  // namespace workerd::api
@@ -173,6 +173,13 @@ class CryptoKey::Impl {
         getAlgorithmName(), "\".");
   }
 
+  // If this key can be used as an HMAC secret, sets up `ctx` (newly allocated) to compute an HMAC
+  // of `md` with it and returns true. Otherwise returns false and the caller should export the
+  // key instead.
+  virtual bool initHmac(HMAC_CTX* ctx, const EVP_MD* md) const {
+    return false;
+  }
+
   virtual jsg::BufferSource deriveBits(jsg::Lock& js,
       SubtleCrypto::DeriveKeyAlgorithm&& algorithm,
       kj::Maybe<uint32_t> length) const {
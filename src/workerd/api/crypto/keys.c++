@@ -1,8 +1,11 @@
 #include "keys.h"
 
+#include <workerd/io/worker.h>
+
 #include <openssl/crypto.h>
 #include <openssl/ec_key.h>
 #include <openssl/pem.h>
+#include <openssl/sha.h>
 #include <openssl/x509.h>
 
 namespace workerd::api {
@@ -330,10 +333,100 @@ bool AsymmetricKeyCryptoKeyImpl::verifyX509Private(const X509* cert) const {
 
 // ======================================================================================
 
+kj::Own<EVP_PKEY> ImportedKeyCache::getOrParse(
+    kj::String cacheKey, kj::FunctionParam<kj::Own<EVP_PKEY>()> parse) {
+  auto addRef = [](EVP_PKEY* key) {
+    EVP_PKEY_up_ref(key);
+    return kj::Own<EVP_PKEY>(key, SslDisposer<EVP_PKEY, &EVP_PKEY_free>::INSTANCE);
+  };
+
+  KJ_IF_SOME(entry, entries.find(cacheKey)) {
+    entry.lastUsed = ++useCount;
+    return addRef(entry.key.get());
+  }
+
+  auto key = parse();
+
+  if (entries.size() >= MAX_ENTRIES) {
+    kj::Maybe<decltype(entries)::Entry&> victim;
+    for (auto& candidate: entries) {
+      KJ_IF_SOME(v, victim) {
+        if (candidate.value.lastUsed >= v.value.lastUsed) continue;
+      }
+      victim = candidate;
+    }
+    entries.erase(KJ_ASSERT_NONNULL(victim));
+  }
+
+  entries.insert(kj::mv(cacheKey), {addRef(key.get()), ++useCount});
+  return key;
+}
+
+namespace {
+
+// Hashes the members of a JWK which determine the key it describes, each prefixed with its length
+// so that different JWKs can't produce the same input. Members which are only checked against the
+// requested usages and extractability (`use`, `key_ops`, `ext`) are left out.
+void hashJwk(SHA256_CTX& ctx, const SubtleCrypto::JsonWebKey& jwk) {
+  auto add = [&](kj::StringPtr value) {
+    uint64_t size = value.size();
+    SHA256_Update(&ctx, &size, sizeof(size));
+    SHA256_Update(&ctx, value.begin(), value.size());
+  };
+  auto addOptional = [&](const kj::Maybe<kj::String>& member) {
+    KJ_IF_SOME(value, member) {
+      SHA256_Update(&ctx, "+", 1);
+      add(value);
+    } else {
+      SHA256_Update(&ctx, "-", 1);
+    }
+  };
+  add(jwk.kty);
+  addOptional(jwk.alg);
+  addOptional(jwk.crv);
+  addOptional(jwk.x);
+  addOptional(jwk.y);
+  addOptional(jwk.d);
+  addOptional(jwk.n);
+  addOptional(jwk.e);
+  addOptional(jwk.p);
+  addOptional(jwk.q);
+  addOptional(jwk.dp);
+  addOptional(jwk.dq);
+  addOptional(jwk.qi);
+  addOptional(jwk.k);
+}
+
+// Calls `parse()`, or reuses the key it returned for an earlier import of the same key data with
+// the same algorithm into this isolate. `hashKeyData` feeds the key data to `ctx`.
+kj::Own<EVP_PKEY> parseWithCache(jsg::Lock& js,
+    kj::StringPtr format,
+    kj::StringPtr normalizedName,
+    kj::StringPtr algorithmParams,
+    kj::FunctionParam<void(SHA256_CTX& ctx)> hashKeyData,
+    kj::FunctionParam<kj::Own<EVP_PKEY>()> parse) {
+  // Locks which don't belong to a Worker::Isolate, as in some unit tests, don't cache keys.
+  KJ_IF_SOME(isolate, Worker::Isolate::tryFrom(js)) {
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    hashKeyData(ctx);
+    kj::byte digest[SHA256_DIGEST_LENGTH];
+    SHA256_Final(digest, &ctx);
+
+    auto cacheKey =
+        kj::str(format, ' ', normalizedName, ' ', algorithmParams, ' ', kj::encodeHex(digest));
+    return isolate.getImportedKeyCache().getOrParse(kj::mv(cacheKey), [&]() { return parse(); });
+  }
+  return parse();
+}
+
+}  // namespace
+
 AsymmetricKeyData importAsymmetricForWebCrypto(jsg::Lock& js,
     kj::StringPtr format,
     SubtleCrypto::ImportKeyData keyData,
     kj::StringPtr normalizedName,
+    kj::StringPtr algorithmParams,
     bool extractable,
     kj::ArrayPtr<const kj::String> keyUsages,
     kj::FunctionParam<kj::Own<EVP_PKEY>(SubtleCrypto::JsonWebKey)> readJwk,
@@ -460,18 +553,26 @@ AsymmetricKeyData importAsymmetricForWebCrypto(jsg::Lock& js,
           "Cannot create an extractable CryptoKey from an unextractable JSON Web Key.");
     }
 
-    return {readJwk(kj::mv(keyDataJwk)), keyType, usages};
+    // Multi-prime keys are rejected above, so `oth` doesn't need to be part of the cache key.
+    auto evpPkey = parseWithCache(js, format, normalizedName, algorithmParams,
+        [&](SHA256_CTX& ctx) { hashJwk(ctx, keyDataJwk); },
+        [&]() { return readJwk(kj::mv(keyDataJwk)); });
+    return {kj::mv(evpPkey), keyType, usages};
   } else if (format == "spki") {
     kj::ArrayPtr<const kj::byte> keyBytes =
         JSG_REQUIRE_NONNULL(keyData.tryGet<kj::Array<kj::byte>>(), DOMDataError,
             "SPKI import requires an ArrayBuffer.");
-    const kj::byte* ptr = keyBytes.begin();
-    auto evpPkey = OSSLCALL_OWN(
-        EVP_PKEY, d2i_PUBKEY(nullptr, &ptr, keyBytes.size()), DOMDataError, "Invalid SPKI input.");
-    if (ptr != keyBytes.end()) {
-      JSG_FAIL_REQUIRE(
-          DOMDataError, "Invalid ", keyBytes.end() - ptr, " trailing bytes after SPKI input.");
-    }
+    auto evpPkey = parseWithCache(js, format, normalizedName, algorithmParams,
+        [&](SHA256_CTX& ctx) { SHA256_Update(&ctx, keyBytes.begin(), keyBytes.size()); }, [&]() {
+      const kj::byte* ptr = keyBytes.begin();
+      auto evpPkey = OSSLCALL_OWN(EVP_PKEY, d2i_PUBKEY(nullptr, &ptr, keyBytes.size()),
+          DOMDataError, "Invalid SPKI input.");
+      if (ptr != keyBytes.end()) {
+        JSG_FAIL_REQUIRE(
+            DOMDataError, "Invalid ", keyBytes.end() - ptr, " trailing bytes after SPKI input.");
+      }
+      return evpPkey;
+    });
 
     // usages must be empty for ECDH public keys, so use CryptoKeyUsageSet() when validating the
     // usage set.
@@ -484,13 +585,17 @@ AsymmetricKeyData importAsymmetricForWebCrypto(jsg::Lock& js,
     kj::ArrayPtr<const kj::byte> keyBytes =
         JSG_REQUIRE_NONNULL(keyData.tryGet<kj::Array<kj::byte>>(), DOMDataError,
             "PKCS8 import requires an ArrayBuffer.");
-    const kj::byte* ptr = keyBytes.begin();
-    auto evpPkey = OSSLCALL_OWN(EVP_PKEY, d2i_AutoPrivateKey(nullptr, &ptr, keyBytes.size()),
-        DOMDataError, "Invalid PKCS8 input.");
-    if (ptr != keyBytes.end()) {
-      JSG_FAIL_REQUIRE(
-          DOMDataError, "Invalid ", keyBytes.end() - ptr, " trailing bytes after PKCS8 input.");
-    }
+    auto evpPkey = parseWithCache(js, format, normalizedName, algorithmParams,
+        [&](SHA256_CTX& ctx) { SHA256_Update(&ctx, keyBytes.begin(), keyBytes.size()); }, [&]() {
+      const kj::byte* ptr = keyBytes.begin();
+      auto evpPkey = OSSLCALL_OWN(EVP_PKEY, d2i_AutoPrivateKey(nullptr, &ptr, keyBytes.size()),
+          DOMDataError, "Invalid PKCS8 input.");
+      if (ptr != keyBytes.end()) {
+        JSG_FAIL_REQUIRE(
+            DOMDataError, "Invalid ", keyBytes.end() - ptr, " trailing bytes after PKCS8 input.");
+      }
+      return evpPkey;
+    });
     usages = CryptoKeyUsageSet::validate(normalizedName, CryptoKeyUsageSet::Context::importPrivate,
         keyUsages, allowedUsages & CryptoKeyUsageSet::privateKeyMask());
     return {kj::mv(evpPkey), KeyType::PRIVATE, usages};
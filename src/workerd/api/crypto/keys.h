@@ -2,6 +2,8 @@
 
 #include "impl.h"
 
+#include <kj/map.h>
+
 namespace workerd::api {
 
 enum class KeyEncoding {
@@ -126,11 +128,45 @@ class AsymmetricKeyCryptoKeyImpl: public CryptoKey::Impl {
   KeyType keyType;
 };
 
+// Keys parsed by importAsymmetricForWebCrypto(), so that a Worker which imports the same key on
+// every request (typically to verify a token) only parses it once per isolate. Entries are keyed
+// by the import format, the algorithm and its parameters, and a SHA-256 digest of the key data.
+// They hold the parsed EVP_PKEY, which is never modified after import and so can be shared by any
+// number of CryptoKeys; usages and extractability are still validated for each import.
+//
+// Holds at most MAX_ENTRIES keys, dropping the least recently used. Not thread-safe: each isolate
+// has its own, which is only used under the isolate lock.
+class ImportedKeyCache {
+ public:
+  static constexpr uint MAX_ENTRIES = 64;
+
+  // Returns the key cached under `cacheKey`, or calls `parse()` and caches its result. Exceptions
+  // thrown by `parse()` are not cached.
+  kj::Own<EVP_PKEY> getOrParse(kj::String cacheKey, kj::FunctionParam<kj::Own<EVP_PKEY>()> parse);
+
+  size_t size() const {
+    return entries.size();
+  }
+
+ private:
+  struct Entry {
+    kj::Own<EVP_PKEY> key;
+    uint64_t lastUsed;
+  };
+
+  kj::HashMap<kj::String, Entry> entries;
+  uint64_t useCount = 0;
+};
+
 // Performs asymmetric key import per the Web Crypto spec.
+//
+// `algorithmParams` must describe any algorithm parameters which `readJwk` depends on, since the
+// parsed key may be reused for another import of the same key data with the same parameters.
 AsymmetricKeyData importAsymmetricForWebCrypto(jsg::Lock& js,
     kj::StringPtr format,
     SubtleCrypto::ImportKeyData keyData,
     kj::StringPtr normalizedName,
+    kj::StringPtr algorithmParams,
     bool extractable,
     kj::ArrayPtr<const kj::String> keyUsages,
     kj::FunctionParam<kj::Own<EVP_PKEY>(SubtleCrypto::JsonWebKey)> readJwk,
@@ -875,8 +875,12 @@ kj::Own<CryptoKey::Impl> CryptoKey::Impl::importRsa(jsg::Lock& js,
 
   auto [normalizedHashName, hashEvpMd] = lookupDigestAlgorithm(hash);
 
+  // The JWK reader below checks the key's "alg" against both the hash and the algorithm name as
+  // given, which may not be normalized.
+  auto algorithmParams = kj::str(algorithm.name, ' ', normalizedHashName);
+
   auto importedKey = importAsymmetricForWebCrypto(js, kj::mv(format), kj::mv(keyData),
-      normalizedName, extractable, keyUsages,
+      normalizedName, algorithmParams, extractable, keyUsages,
       // Verbose lambda capture needed because: https://bugs.llvm.org/show_bug.cgi?id=35984
       [hashEvpMd = hashEvpMd, &algorithm](
           SubtleCrypto::JsonWebKey keyDataJwk) -> kj::Own<EVP_PKEY> {
@@ -975,7 +979,7 @@ kj::Own<CryptoKey::Impl> CryptoKey::Impl::importRsaRaw(jsg::Lock& js,
   // data. Importing raw keys is currently not supported for this algorithm.
   CryptoKeyUsageSet allowedUsages = CryptoKeyUsageSet::sign() | CryptoKeyUsageSet::verify();
   auto importedKey = importAsymmetricForWebCrypto(js, kj::mv(format), kj::mv(keyData),
-      normalizedName, extractable, keyUsages,
+      normalizedName, nullptr, extractable, keyUsages,
       // Verbose lambda capture needed because: https://bugs.llvm.org/show_bug.cgi?id=35984
       [](SubtleCrypto::JsonWebKey keyDataJwk) -> kj::Own<EVP_PKEY> {
     JSG_REQUIRE(keyDataJwk.kty == "RSA", DOMDataError,
@@ -0,0 +1,246 @@
+// Copyright (c) 2017-2024 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "eventsource.h"
+
+#include <kj/test.h>
+
+namespace workerd::api {
+namespace {
+
+// Records everything the parser reports, one line per call, with each message's last event ID
+// as an EventSource would see it.
+struct Recorder final: public EventStreamParser::Listener {
+  kj::Vector<kj::String> log;
+  kj::String lastEventId = kj::str();
+
+  void onMessage(
+      kj::Maybe<kj::ArrayPtr<const char>> type, kj::ArrayPtr<const char> data) override {
+    KJ_IF_SOME(t, type) {
+      log.add(kj::str("message type=", t, " id=", lastEventId, " data=", data));
+    } else {
+      log.add(kj::str("message id=", lastEventId, " data=", data));
+    }
+  }
+
+  void onLastEventId(kj::ArrayPtr<const char> id) override {
+    lastEventId = kj::heapString(id);
+  }
+
+  void onReconnectionTime(uint32_t time) override {
+    log.add(kj::str("retry ", time));
+  }
+
+  kj::String result() {
+    return kj::str(kj::delimited(log.asPtr(), "\n"_kjc));
+  }
+};
+
+// The parser which EventSourceSink used before EventStreamParser, reporting to a Recorder in
+// place of an EventSource. Messages with empty data are skipped here, as they used to be by
+// EventSource::notifyMessages(). This has only ever been used on whole streams, as it does not
+// handle a CRLF or byte-order-mark split between writes.
+class ReferenceParser {
+ public:
+  explicit ReferenceParser(Recorder& recorder): recorder(recorder) {}
+
+  void write(kj::ArrayPtr<const char> input) {
+    if (!bomChecked) {
+      bomChecked = true;
+      if (input.size() >= 3 && input[0] == '\xEF' && input[1] == '\xBB' && input[2] == '\xBF') {
+        input = input.slice(3);
+      }
+    }
+
+    while (input != nullptr) {
+      KJ_IF_SOME(found, findEndOfLine(input)) {
+        auto prefix = kept.releaseAsArray();
+        feed(kj::str(prefix, input.first(found.pos)));
+        input = found.remaining;
+      } else {
+        kept.addAll(input.begin(), input.end());
+        input = nullptr;
+      }
+    }
+  }
+
+ private:
+  struct PendingMessage {
+    kj::Vector<kj::String> data;
+    kj::Maybe<kj::String> event;
+  };
+
+  Recorder& recorder;
+  kj::Vector<char> kept;
+  kj::Maybe<PendingMessage> currentPendingMessage;
+  bool bomChecked = false;
+
+  void feed(kj::String line) {
+    if (line.size() == 0) {
+      KJ_IF_SOME(pending, currentPendingMessage) {
+        auto data = kj::str(kj::delimited(kj::mv(pending.data), "\n"_kjc));
+        if (data.size() > 0) {
+          kj::Maybe<kj::ArrayPtr<const char>> type;
+          KJ_IF_SOME(event, pending.event) {
+            type = event.asArray();
+          }
+          recorder.onMessage(type, data);
+        }
+        currentPendingMessage = kj::none;
+      }
+    } else if (line[0] == ':') {
+      // Ignore the line.
+    } else {
+      auto handle = [&](kj::ArrayPtr<const char> field, kj::ArrayPtr<const char> value) {
+        auto& pending = [&]() -> PendingMessage& {
+          KJ_IF_SOME(p, currentPendingMessage) {
+            return p;
+          }
+          return currentPendingMessage.emplace();
+        }();
+        if (value.size() > 0 && value[0] == ' ') {
+          value = value.slice(1);
+        }
+        if (field == "data"_kjc) {
+          pending.data.add(kj::str(value));
+        } else if (field == "event"_kjc) {
+          pending.event = kj::str(value);
+        } else if (field == "id"_kjc) {
+          recorder.onLastEventId(value);
+        } else if (field == "retry"_kjc) {
+          KJ_IF_SOME(time, kj::str(value).tryParseAs<uint32_t>()) {
+            recorder.onReconnectionTime(time);
+          }
+        }
+      };
+
+      KJ_IF_SOME(pos, line.findFirst(':')) {
+        handle(line.first(pos), line.slice(pos + 1));
+      } else {
+        handle(line, ""_kjc);
+      }
+    }
+  }
+
+  struct EndOfLine {
+    size_t pos;
+    kj::ArrayPtr<const char> remaining;
+  };
+  kj::Maybe<EndOfLine> findEndOfLine(kj::ArrayPtr<const char> input) {
+    size_t pos = 0;
+    while (pos < input.size()) {
+      if (input[pos] == '\n') {
+        return EndOfLine{pos, input.slice(pos + 1)};
+      } else if (input[pos] == '\r') {
+        if (pos + 1 < input.size() && input[pos + 1] == '\n') {
+          return EndOfLine{pos, input.slice(pos + 2)};
+        }
+        return EndOfLine{pos, input.slice(pos + 1)};
+      }
+      pos++;
+    }
+    return kj::none;
+  }
+};
+
+// Feeds the stream in chunks of the given sizes, repeating the last size until the stream ends.
+kj::String parse(kj::StringPtr stream, kj::ArrayPtr<const size_t> chunkSizes = nullptr) {
+  Recorder recorder;
+  EventStreamParser parser(recorder);
+  auto input = stream.asArray();
+  size_t i = 0;
+  while (input.size() > 0) {
+    size_t size = chunkSizes.size() == 0 ? input.size()
+                                         : chunkSizes[kj::min(i++, chunkSizes.size() - 1)];
+    size = kj::min(size, input.size());
+    parser.feed(input.first(size));
+    input = input.slice(size);
+  }
+  return recorder.result();
+}
+
+kj::String parseWithReference(kj::StringPtr stream) {
+  Recorder recorder;
+  ReferenceParser parser(recorder);
+  parser.write(stream.asArray());
+  return recorder.result();
+}
+
+KJ_TEST("EventStreamParser parses messages") {
+  KJ_EXPECT(parse("data: a\ndata:b\n\nevent: e\ndata: c\nid: 1\n\n: comment\ndata\ndata\n\n"
+                  "data\n\nretry: 3000\nretry: x\nevent: ignored\n\n") ==
+      "message id= data=a\nb\n"
+      "message type=e id=1 data=c\n"
+      "message id=1 data=\n\n"
+      "retry 3000"_kj);
+}
+
+KJ_TEST("EventStreamParser accepts every end-of-line marker") {
+  auto expected = "message id= data=a\nb\nmessage id= data=c"_kj;
+  KJ_EXPECT(parse("data: a\ndata: b\n\ndata: c\n\n") == expected);
+  KJ_EXPECT(parse("data: a\rdata: b\r\rdata: c\r\r") == expected);
+  KJ_EXPECT(parse("data: a\r\ndata: b\r\n\r\ndata: c\r\n\r\n") == expected);
+}
+
+KJ_TEST("EventStreamParser joins lines split between chunks") {
+  auto stream = "\xEF\xBB\xBF"
+                "data: a long line which is split into several chunks\r\n"
+                "data: b\r\n\r\n"
+                "data: c\r\n\r\n"_kj;
+  auto expected = parse(stream);
+  KJ_EXPECT(expected ==
+      "message id= data=a long line which is split into several chunks\nb\n"
+      "message id= data=c");
+
+  // One byte at a time splits the byte-order-mark, and every CRLF.
+  const size_t one[] = {1};
+  KJ_EXPECT(parse(stream, one) == expected);
+
+  // Splits the first line in two, and ends a chunk at every CR.
+  const size_t chunks[] = {3, 17, 36, 9, 2, 9, 100};
+  KJ_EXPECT(parse(stream, chunks) == expected);
+}
+
+KJ_TEST("EventStreamParser drops the incomplete message at the end of the stream") {
+  KJ_EXPECT(parse("data: a\n\ndata: b\n") == "message id= data=a");
+  KJ_EXPECT(parse("data: a\n\ndata: b") == "message id= data=a");
+}
+
+KJ_TEST("EventStreamParser matches the previous parser on random streams") {
+  // Streams are built from pieces which are likely to interact: field names with and without
+  // values, every end-of-line marker, and long runs without one.
+  kj::StringPtr pieces[] = {"data", "data:", "data: ", "event:", "event: x", "id:", "id: 7",
+    "retry:", "retry: 1500", "retry: 1e3", ":", ": comment", " ", "x", "\r", "\n", "\r\n",
+    "\xEF\xBB\xBF", "0123456789abcdefghijklmnopqrstuvwxyz", "unknown: field"};
+
+  // A fixed linear congruential generator, so that any failure is reproducible.
+  uint64_t state = 12345;
+  auto next = [&](size_t bound) -> size_t {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return (state >> 33) % bound;
+  };
+
+  for (auto iteration: kj::zeroTo(2000)) {
+    kj::Vector<kj::StringPtr> parts;
+    for (auto i KJ_UNUSED: kj::zeroTo(next(80))) {
+      parts.add(pieces[next(kj::size(pieces))]);
+    }
+    auto stream = kj::str(kj::delimited(parts.asPtr(), ""_kjc));
+    auto expected = parseWithReference(stream);
+
+    KJ_EXPECT(parse(stream) == expected, iteration, stream);
+
+    const size_t one[] = {1};
+    KJ_EXPECT(parse(stream, one) == expected, iteration, stream);
+
+    kj::Vector<size_t> chunkSizes;
+    for (auto i KJ_UNUSED: kj::zeroTo(16)) {
+      chunkSizes.add(next(40) + 1);
+    }
+    KJ_EXPECT(parse(stream, chunkSizes.asPtr()) == expected, iteration, stream);
+  }
+}
+
+}  // namespace
+}  // namespace workerd::api
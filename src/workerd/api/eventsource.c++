@@ -11,52 +11,65 @@
 #include <workerd/jsg/exception.h>
 #include <workerd/util/mimetype.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace workerd::api {
 
 namespace {
-class EventSourceSink final: public WritableStreamSink {
+
+// Returns the position of the first CR or LF in `input`, or `input.size()` if there is none.
+// A `data` line often carries a whole JSON payload, so we compare 16 bytes at a time.
+size_t findEndOfLine(kj::ArrayPtr<const char> input) {
+  const char* ptr = input.begin();
+  const char* end = input.end();
+#if defined(__SSE2__)
+  const __m128i cr = _mm_set1_epi8('\r');
+  const __m128i lf = _mm_set1_epi8('\n');
+  for (; end - ptr >= 16; ptr += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    int mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, lf)));
+    if (mask != 0) {
+      return ptr - input.begin() + __builtin_ctz(mask);
+    }
+  }
+#elif defined(__aarch64__)
+  const uint8x16_t cr = vdupq_n_u8('\r');
+  const uint8x16_t lf = vdupq_n_u8('\n');
+  for (; end - ptr >= 16; ptr += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(ptr));
+    uint8x16_t matches = vorrq_u8(vceqq_u8(chunk, cr), vceqq_u8(chunk, lf));
+    // Narrow each byte of the comparison to a nibble, giving a 64-bit mask of the matches.
+    uint64_t mask =
+        vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+    if (mask != 0) {
+      return ptr - input.begin() + (__builtin_ctzll(mask) >> 2);
+    }
+  }
+#endif
+  // Whatever is left over, less than one vector's worth unless neither of the above is available.
+  for (; ptr < end; ++ptr) {
+    if (*ptr == '\r' || *ptr == '\n') break;
+  }
+  return ptr - input.begin();
+}
+
+class EventSourceSink final: public WritableStreamSink, private EventStreamParser::Listener {
  public:
-  EventSourceSink(EventSource& eventSource): eventSource(eventSource) {}
+  EventSourceSink(EventSource& eventSource): eventSource(eventSource), parser(*this) {}
 
   kj::Promise<void> write(kj::ArrayPtr<const kj::byte> buffer) override {
-    // The event stream is a new-line delimited format where each line represents an event.
-    // We need to scan the buffer for end-of-line characters. When we find one, everything before
-    // it is pushed into the event queue and we keep scanning. If we do not find an end-of-line
-    // sequence in the remaining input, we buffer it and wait for the next write to continue
-    // scanning, or until the stream is ended or aborted.
-
     if (eventSource == kj::none) {
       // Write was received after end() or abort() was called.
       // We'll just ignore the write.
       return kj::READY_NOW;
     }
 
-    auto input = buffer.asChars();
-
-    // The stream may or may not begin with the UTF-8 BOM (%xFEFF). If this is the
-    // first write, we need to check for it and skip it if it is present.
-    // The BOM is a 3-byte sequence (0xEF, 0xBB, 0xBF) that encodes the Unicode
-    // codepoint U+FEFF. We only want to check for this once.
-    if (!bomChecked) {
-      bomChecked = true;
-      if (input.size() >= 3 && input[0] == '\xEF' && input[1] == '\xBB' && input[2] == '\xBF') {
-        input = input.slice(3);
-      }
-    }
-
-    while (input != nullptr) {
-      KJ_IF_SOME(found, findEndOfLine(input)) {
-        auto prefix = kept.releaseAsArray();
-        // Feed the line into the processor.
-        feed(kj::str(prefix, input.first(found.pos)));
-        input = found.remaining;
-        // If we've reached the end of the input, input will == nullptr here.
-      } else {
-        // No end-of-line found, buffer the input.
-        kept.addAll(input.begin(), input.end());
-        input = nullptr;
-      }
-    }
+    parser.feed(buffer.asChars());
 
     // Release any buffered events to the EventSource
     release();
@@ -86,93 +99,28 @@ class EventSourceSink final: public WritableStreamSink {
  private:
   kj::Maybe<EventSource&> eventSource;
 
-  // Retained bytes to be processed in the next write.
-  kj::Vector<char> kept;
+  EventStreamParser parser;
 
   // The collected messages that are pending to be dispatched as events
   kj::Vector<EventSource::PendingMessage> pendingMessages;
 
-  // The message that is currently being processed.
-  kj::Maybe<EventSource::PendingMessage> currentPendingMessage;
-
-  // Set to true once the byte-order-mark has been checked
-  bool bomChecked = false;
-
-  EventSource::PendingMessage& getPendingMessage() {
-    KJ_IF_SOME(pending, currentPendingMessage) {
-      return pending;
-    }
-    return currentPendingMessage.emplace();
+  void onMessage(
+      kj::Maybe<kj::ArrayPtr<const char>> type, kj::ArrayPtr<const char> data) override {
+    // This message is done and ready to be dispatched. The next time release() is called, it
+    // will be passed off to the EventSource.
+    pendingMessages.add(EventSource::PendingMessage{
+      .data = kj::heapString(data),
+      .event = type.map([](kj::ArrayPtr<const char> name) { return kj::heapString(name); }),
+      .id = kj::str(KJ_ASSERT_NONNULL(eventSource).getLastEventId()),
+    });
   }
 
-  void feed(kj::String line) {
-    // Parse line according to the event stream format and dispatch the event.
-
-    // stream        = [ bom ] *event
-    // event         = *( comment / field ) end-of-line
-    // comment       = colon *any-char end-of-line
-    // field         = 1*name-char [ colon [ space ] *any-char ] end-of-line
-    // end-of-line   = ( cr lf / cr / lf )
-
-    // ; characters
-    // lf            = %x000A ; U+000A LINE FEED (LF)
-    // cr            = %x000D ; U+000D CARRIAGE RETURN (CR)
-    // space         = %x0020 ; U+0020 SPACE
-    // colon         = %x003A ; U+003A COLON (:)
-    // bom           = %xFEFF ; U+FEFF BYTE ORDER MARK
-    // name-char     = %x0000-0009 / %x000B-000C / %x000E-0039 / %x003B-10FFFF
-    //                 ; a scalar value other than U+000A LINE FEED (LF), U+000D CARRIAGE RETURN
-    //                   (CR), or U+003A COLON (:)
-    // any-char      = %x0000-0009 / %x000B-000C / %x000E-10FFFF
-    //                 ; a scalar value other than U+000A LINE FEED (LF) or U+000D CARRIAGE
-    //                   RETURN (CR)
-
-    // Note that the BOM (if present) is filtered out in the write() method.
-
-    if (line.size() == 0) {
-      // Dispatch the current pending message and clear it. If there is no
-      // pending message, we'll just ignore the line.
-      KJ_IF_SOME(pending, currentPendingMessage) {
-        // This message is done and ready to be dispatched. Add it to the
-        // pendingMessages list. The next time release() is called, it will
-        // be passed off to the EventSource.
-        pending.id = kj::str(KJ_ASSERT_NONNULL(eventSource).getLastEventId());
-        pendingMessages.add(kj::mv(pending));
-        currentPendingMessage = kj::none;
-      }
-    } else if (line[0] == ':') {
-      // Ignore the line.
-    } else {
-      static constexpr auto handle = [](auto& self, kj::ArrayPtr<const char> field,
-                                         kj::ArrayPtr<const char> value) {
-        auto& pending = self.getPendingMessage();
-        auto& ev = KJ_ASSERT_NONNULL(self.eventSource);
-        // Per the spec, only one space after the colon is optional and trimmed.
-        // Any other whitespace, or additional spaces aren't accounted for so would
-        // be part of the value.
-        if (value.size() > 0 && value[0] == ' ') {
-          value = value.slice(1);
-        }
-        if (field == "data"_kjc) {
-          pending.data.add(kj::str(value));
-        } else if (field == "event"_kjc) {
-          pending.event = kj::str(value);
-        } else if (field == "id"_kjc) {
-          ev.setLastEventId(kj::str(value));
-        } else if (field == "retry"_kjc) {
-          KJ_IF_SOME(time, kj::str(value).tryParseAs<uint32_t>()) {
-            KJ_ASSERT_NONNULL(self.eventSource).setReconnectionTime(time);
-          }
-          // Ignore the line if it cannot be successfully parsed as a uint32_t
-        }
-      };
+  void onLastEventId(kj::ArrayPtr<const char> id) override {
+    KJ_ASSERT_NONNULL(eventSource).setLastEventId(kj::heapString(id));
+  }
 
-      KJ_IF_SOME(pos, line.findFirst(':')) {
-        handle(*this, line.first(pos), line.slice(pos + 1));
-      } else {
-        handle(*this, line, ""_kjc);
-      }
-    }
+  void onReconnectionTime(uint32_t time) override {
+    KJ_ASSERT_NONNULL(eventSource).setReconnectionTime(time);
   }
 
   void release() {
@@ -186,30 +134,7 @@ class EventSourceSink final: public WritableStreamSink {
 
   void clear() {
     eventSource = kj::none;
-    kept.clear();
     pendingMessages.clear();
-    currentPendingMessage = kj::none;
-  }
-
-  struct EndOfLine {
-    size_t pos;
-    kj::ArrayPtr<const char> remaining;
-  };
-  kj::Maybe<EndOfLine> findEndOfLine(kj::ArrayPtr<const char> input) {
-    // The end-of-line marker is either \n, \r, or \r\n
-    size_t pos = 0;
-    while (pos < input.size()) {
-      if (input[pos] == '\n') {
-        return EndOfLine{pos, input.slice(pos + 1)};
-      } else if (input[pos] == '\r') {
-        if (pos + 1 < input.size() && input[pos + 1] == '\n') {
-          return EndOfLine{pos, input.slice(pos + 2)};
-        }
-        return EndOfLine{pos, input.slice(pos + 1)};
-      }
-      pos++;
-    }
-    return kj::none;
   }
 };
 
@@ -230,6 +155,133 @@ kj::Promise<void> processBody(IoContext& context, kj::Promise<DeferredProxy<void
 }
 }  // namespace
 
+void EventStreamParser::feed(kj::ArrayPtr<const char> input) {
+  // The event stream is a new-line delimited format where each line represents a field of an
+  // event. We scan the input for end-of-line characters, and process everything before each
+  // one as a line. If we do not find an end-of-line sequence in the remaining input, we keep it
+  // and wait for the next chunk to continue scanning.
+
+  if (skipLf && input.size() > 0) {
+    skipLf = false;
+    if (input[0] == '\n') {
+      input = input.slice(1);
+    }
+  }
+
+  while (input.size() > 0) {
+    size_t pos = findEndOfLine(input);
+    if (pos == input.size()) {
+      partialLine.addAll(input);
+      return;
+    }
+
+    if (partialLine.size() > 0) {
+      partialLine.addAll(input.first(pos));
+      processLine(partialLine.asPtr());
+      partialLine.clear();
+    } else {
+      processLine(input.first(pos));
+    }
+
+    // The end-of-line marker is either \n, \r, or \r\n
+    if (input[pos] == '\r') {
+      if (pos + 1 == input.size()) {
+        skipLf = true;
+      } else if (input[pos + 1] == '\n') {
+        ++pos;
+      }
+    }
+    input = input.slice(pos + 1);
+  }
+}
+
+void EventStreamParser::processLine(kj::ArrayPtr<const char> line) {
+  // Parse line according to the event stream format and dispatch the event.
+
+  // stream        = [ bom ] *event
+  // event         = *( comment / field ) end-of-line
+  // comment       = colon *any-char end-of-line
+  // field         = 1*name-char [ colon [ space ] *any-char ] end-of-line
+  // end-of-line   = ( cr lf / cr / lf )
+
+  // ; characters
+  // lf            = %x000A ; U+000A LINE FEED (LF)
+  // cr            = %x000D ; U+000D CARRIAGE RETURN (CR)
+  // space         = %x0020 ; U+0020 SPACE
+  // colon         = %x003A ; U+003A COLON (:)
+  // bom           = %xFEFF ; U+FEFF BYTE ORDER MARK
+  // name-char     = %x0000-0009 / %x000B-000C / %x000E-0039 / %x003B-10FFFF
+  //                 ; a scalar value other than U+000A LINE FEED (LF), U+000D CARRIAGE RETURN
+  //                   (CR), or U+003A COLON (:)
+  // any-char      = %x0000-0009 / %x000B-000C / %x000E-10FFFF
+  //                 ; a scalar value other than U+000A LINE FEED (LF) or U+000D CARRIAGE
+  //                   RETURN (CR)
+
+  // The stream may or may not begin with the UTF-8 BOM (%xFEFF), which is the 3-byte sequence
+  // (0xEF, 0xBB, 0xBF). We only want to check for this at the start of the first line, wherever
+  // the first chunk happened to end.
+  if (!bomChecked) {
+    bomChecked = true;
+    if (line.size() >= 3 && line.first(3) == "\xEF\xBB\xBF"_kjc) {
+      line = line.slice(3);
+    }
+  }
+
+  if (line.size() == 0) {
+    dispatch();
+    return;
+  }
+  if (line[0] == ':') {
+    // Ignore the comment.
+    return;
+  }
+
+  auto field = line;
+  auto value = kj::ArrayPtr<const char>();
+  auto colon = static_cast<const char*>(memchr(line.begin(), ':', line.size()));
+  if (colon != nullptr) {
+    field = kj::arrayPtr(line.begin(), colon);
+    value = kj::arrayPtr(colon + 1, line.end());
+    // Per the spec, only one space after the colon is optional and trimmed.
+    // Any other whitespace, or additional spaces aren't accounted for so would
+    // be part of the value.
+    if (value.size() > 0 && value[0] == ' ') {
+      value = value.slice(1);
+    }
+  }
+
+  if (field == "data"_kjc) {
+    data.addAll(value);
+    data.add('\n');
+  } else if (field == "event"_kjc) {
+    type.clear();
+    type.addAll(value);
+    hasType = true;
+  } else if (field == "id"_kjc) {
+    listener.onLastEventId(value);
+  } else if (field == "retry"_kjc) {
+    KJ_IF_SOME(time, kj::str(value).tryParseAs<uint32_t>()) {
+      listener.onReconnectionTime(time);
+    }
+    // Ignore the line if it cannot be successfully parsed as a uint32_t
+  }
+}
+
+void EventStreamParser::dispatch() {
+  // The data buffer ends with the LF which followed its last line, which is not part of the
+  // message. A message with no data (or only an empty `data` line) is not dispatched.
+  if (data.size() > 1) {
+    kj::Maybe<kj::ArrayPtr<const char>> eventType;
+    if (hasType) {
+      eventType = type.asPtr();
+    }
+    listener.onMessage(eventType, data.asPtr().first(data.size() - 1));
+  }
+  data.clear();
+  type.clear();
+  hasType = false;
+}
+
 jsg::Ref<EventSource> EventSource::constructor(
     jsg::Lock& js, kj::String url, jsg::Optional<EventSourceInit> init) {
   JSG_REQUIRE(IoContext::hasCurrent(), DOMNotSupportedError,
@@ -304,10 +356,8 @@ void EventSource::notifyMessages(jsg::Lock& js, kj::Array<PendingMessage> messag
   if (readyState == State::CLOSED) return;
   js.tryCatch([&] {
     for (auto& message: messages) {
-      auto data = kj::str(kj::delimited(kj::mv(message.data), "\n"_kjc));
-      if (data.size() == 0) continue;
       dispatchEventImpl(js,
-          js.alloc<MessageEvent>(kj::mv(message.event), kj::mv(data), kj::mv(message.id),
+          js.alloc<MessageEvent>(kj::mv(message.event), kj::mv(message.data), kj::mv(message.id),
               impl.map([](FetchImpl& i) -> jsg::Url& { return i.url; })));
     }
   }, [&](jsg::Value exception) {
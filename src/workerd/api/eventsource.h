@@ -8,6 +8,8 @@
 #include <workerd/jsg/jsg.h>
 #include <workerd/jsg/url.h>
 
+#include <kj/vector.h>
+
 namespace workerd::api {
 
 using kj::uint;
@@ -15,6 +17,61 @@ class Fetcher;
 class ReadableStream;
 class Response;
 
+// Incrementally parses the text/event-stream format received by an EventSource. The stream may be
+// split into chunks at any byte. Lines are parsed in place from each chunk; only a line which spans
+// two chunks is copied. The `data` of a message is collected in a buffer which is reused for the
+// next message, so a message costs no allocations beyond what the listener makes of it.
+// https://html.spec.whatwg.org/multipage/server-sent-events.html#event-stream-interpretation
+class EventStreamParser {
+ public:
+  class Listener {
+   public:
+    // Called once a message is complete. `data` is never empty. Both arguments point into the
+    // parser's buffers, and are only valid during the call.
+    virtual void onMessage(
+        kj::Maybe<kj::ArrayPtr<const char>> type, kj::ArrayPtr<const char> data) = 0;
+
+    // Called for each `id` field, immediately, as the spec sets the last event ID before the
+    // message is complete.
+    virtual void onLastEventId(kj::ArrayPtr<const char> id) = 0;
+
+    // Called for each `retry` field whose value is a valid reconnection time.
+    virtual void onReconnectionTime(uint32_t time) = 0;
+  };
+
+  explicit EventStreamParser(Listener& listener): listener(listener) {}
+  KJ_DISALLOW_COPY_AND_MOVE(EventStreamParser);
+
+  // Parses the next chunk of the stream, reporting each message completed by it to the listener.
+  // A partial line at the end of the chunk is kept until the next call. Any partial line or
+  // message which is still pending when the stream ends is dropped, per the spec.
+  void feed(kj::ArrayPtr<const char> input);
+
+ private:
+  Listener& listener;
+
+  // The start of a line which spans chunks. Cleared without releasing its buffer.
+  kj::Vector<char> partialLine;
+
+  // The `data` of the current message, with every line followed by LF, as in the spec's data
+  // buffer. Cleared without releasing its buffer after each message.
+  kj::Vector<char> data;
+
+  // The `event` type of the current message, valid if `hasType` is set.
+  kj::Vector<char> type;
+  bool hasType = false;
+
+  // Set once the first line has been seen, after which there can be no byte-order-mark.
+  bool bomChecked = false;
+
+  // Set if the last chunk ended with CR, in which case an LF at the start of the next chunk is the
+  // rest of the same end-of-line.
+  bool skipLf = false;
+
+  void processLine(kj::ArrayPtr<const char> line);
+  void dispatch();
+};
+
 // Implements the web standard EventSource API
 // https://developer.mozilla.org/en-US/docs/Web/API/EventSource
 class EventSource: public EventTarget {
@@ -184,7 +241,7 @@ class EventSource: public EventTarget {
   }
 
   struct PendingMessage {
-    kj::Vector<kj::String> data;
+    kj::String data;
     kj::Maybe<kj::String> event;
     kj::String id;
   };
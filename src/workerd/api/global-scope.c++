@@ -144,7 +144,7 @@ kj::Promise<DeferredProxy<void>> ServiceWorkerGlobalScope::request(kj::HttpMetho
     kj::Maybe<kj::StringPtr> cfBlobJson,
     Worker::Lock& lock,
     kj::Maybe<ExportedHandler&> exportedHandler,
-    kj::Maybe<jsg::Ref<AbortSignal>> abortSignal) {
+    kj::Maybe<kj::Own<LazyAbortSignal>> abortSignal) {
   TRACE_EVENT("workerd", "ServiceWorkerGlobalScope::request()");
   // To construct a ReadableStream object, we're supposed to pass in an Own<AsyncInputStream>, so
   // that it can drop the reference whenever it gets GC'ed. But in this case the stream's lifetime
@@ -213,8 +213,11 @@ kj::Promise<DeferredProxy<void>> ServiceWorkerGlobalScope::request(kj::HttpMetho
 
   auto jsRequest = js.alloc<Request>(js, method, url, Request::Redirect::MANUAL, kj::mv(jsHeaders),
       jsg::alloc<Fetcher>(IoContext::NEXT_CLIENT_CHANNEL, Fetcher::RequiresHostAndProtocol::YES),
-      /* signal */ kj::mv(abortSignal), kj::mv(cf), kj::mv(body),
+      /* signal */ kj::none, kj::mv(cf), kj::mv(body),
       /* thisSignal */ kj::none, Request::CacheMode::NONE);
+  KJ_IF_SOME(s, abortSignal) {
+    jsRequest->setLazySignal(kj::mv(s));
+  }
 
   // signal vs thisSignal
   // --------------------
@@ -484,7 +484,7 @@ class ServiceWorkerGlobalScope: public WorkerGlobalScope {
       kj::Maybe<kj::StringPtr> cfBlobJson,
       Worker::Lock& lock,
       kj::Maybe<ExportedHandler&> exportedHandler,
-      kj::Maybe<jsg::Ref<AbortSignal>> abortSignal);
+      kj::Maybe<kj::Own<LazyAbortSignal>> abortSignal);
   // TODO(cleanup): Factor out the shared code used between old-style event listeners vs. module
   //   exports and move that code somewhere more appropriate.
 
@@ -83,8 +83,54 @@ struct HeadersContext: public jsg::Object, public jsg::ContextGlobal {
     return true;
   }
 
+  bool testIncoming(jsg::Lock& js) {
+    kj::HttpHeaderTable::Builder builder;
+    auto kFoo = builder.add("Foo");
+    auto headersTable = builder.build();
+    kj::HttpHeaders kjHeaders(*headersTable);
+    kjHeaders.set(kFoo, "1");
+    kjHeaders.addPtrPtr("X-Bar", "a");
+    kjHeaders.addPtrPtr("Content-Type", "text/plain");
+    kjHeaders.addPtrPtr("x-bar", "b");
+
+    auto headers =
+        js.alloc<workerd::api::Headers>(js, kjHeaders, workerd::api::Headers::Guard::REQUEST);
+
+    // Lookups are answered from the incoming headers.
+    KJ_ASSERT(KJ_ASSERT_NONNULL(headers->getNoChecks(js, "foo"_kj)) == "1");
+    KJ_ASSERT(KJ_ASSERT_NONNULL(headers->getNoChecks(js, "X-BAR"_kj)) == "a, b");
+    KJ_ASSERT(headers->getNoChecks(js, "x-baz"_kj) == kj::none);
+    KJ_ASSERT(headers->hasLowerCase("content-type"_kj));
+    KJ_ASSERT(!headers->hasLowerCase("x-ba"_kj));
+
+    // Forwarding produces the same order and names as the fully built table.
+    auto forwarded = [&](workerd::api::Headers& h) {
+      kj::HttpHeaders out(*headersTable);
+      h.shallowCopyTo(out);
+      return out.serializeResponse(200, "OK");
+    };
+    auto built = js.alloc<workerd::api::Headers>();
+    kjHeaders.forEach([&](kj::StringPtr name, kj::StringPtr value) {
+      built->appendUnguarded(js, name, jsg::ByteString(kj::str(value)));
+    });
+    auto expected = forwarded(*built);
+    auto copy = js.alloc<workerd::api::Headers>(js, *headers);
+    copy->setUnguarded(js, "x-qux"_kj, jsg::ByteString(kj::str("c")));
+    copy->delete_(js, jsg::ByteString(kj::str("x-qux")));
+    KJ_ASSERT(forwarded(*headers) == forwarded(*copy));
+    KJ_ASSERT(forwarded(*headers) == expected, forwarded(*headers), expected);
+
+    // Modifying a copy leaves the original untouched.
+    copy->setUnguarded(js, "foo"_kj, jsg::ByteString(kj::str("2")));
+    KJ_ASSERT(KJ_ASSERT_NONNULL(copy->getNoChecks(js, "foo"_kj)) == "2");
+    KJ_ASSERT(KJ_ASSERT_NONNULL(headers->getNoChecks(js, "foo"_kj)) == "1");
+
+    return true;
+  }
+
   JSG_RESOURCE_TYPE(HeadersContext) {
     JSG_METHOD(test);
+    JSG_METHOD(testIncoming);
   }
 };
 
@@ -98,6 +144,11 @@ KJ_TEST("Header memory is accounted for") {
   e.expectEval("test()", "boolean", "true");
 }
 
+KJ_TEST("Headers from kj::HttpHeaders behave the same before and after they are modified") {
+  jsg::test::Evaluator<HeadersContext, HeadersIsolate, CompatibilityFlags::Reader> e(v8System);
+  e.expectEval("testIncoming()", "boolean", "true");
+}
+
 KJ_TEST("Header::hashCode test") {
   // The Headers::hashCode function generates a case-insensitive hash code.
   // It should be stable across runs and platforms and should match the hash
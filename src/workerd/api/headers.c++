@@ -7,6 +7,8 @@
 
 #include <kj/parse/char.h>
 
+#include <algorithm>
+
 namespace workerd::api {
 namespace {
 void warnIfBadHeaderString(const jsg::ByteString& byteString) {
@@ -96,6 +98,14 @@ constexpr bool requireValidHeaderValue(kj::StringPtr value) {
   }
   return true;
 }
+
+bool headerNameEquals(kj::StringPtr a, kj::StringPtr b) {
+  return a.size() == b.size() && strcasecmp(a.cStr(), b.cStr()) == 0;
+}
+
+// Returns the name under which `Header` would store `name`. Defined below, with the list of
+// common header names.
+kj::StringPtr getStoredName(kj::StringPtr name);
 }  // namespace
 
 Headers::Headers(jsg::Lock& js, jsg::Dict<jsg::ByteString, jsg::ByteString> dict)
@@ -107,6 +117,10 @@ Headers::Headers(jsg::Lock& js, jsg::Dict<jsg::ByteString, jsg::ByteString> dict
 }
 
 Headers::Headers(jsg::Lock& js, const Headers& other, Guard guard): guard(guard) {
+  KJ_IF_SOME(in, other.incoming) {
+    incoming = in.clone(js);
+    return;
+  }
   headers.reserve(other.headers.size() + 16);
   for (const auto& header: other.headers) {
     headers.insert(header.clone(js));
@@ -114,10 +128,93 @@ Headers::Headers(jsg::Lock& js, const Headers& other, Guard guard): guard(guard)
 }
 
 Headers::Headers(jsg::Lock& js, const kj::HttpHeaders& other, Guard guard): guard(guard) {
-  headers.reserve(other.size() + 16);
-  other.forEach([this, &js](auto name, auto value) {
-    appendUnguarded(js, name, jsg::ByteString(kj::str(value)));
+  kj::Vector<Incoming::Entry> entries(other.size());
+  other.forEach([&entries](kj::StringPtr name, kj::StringPtr value) {
+    entries.add(Incoming::Entry{.name = name, .value = value});
   });
+  incoming = Incoming::copy(js, entries.releaseAsArray());
+}
+
+Headers::Incoming Headers::Incoming::copy(jsg::Lock& js, kj::Array<Entry> entries) {
+  size_t textSize = 0;
+  for (auto& entry: entries) {
+    textSize += entry.name.size() + entry.value.size() + 2;
+  }
+
+  auto text = kj::heapArray<char>(textSize);
+  char* pos = text.begin();
+  auto copyString = [&pos](kj::StringPtr str) {
+    memcpy(pos, str.begin(), str.size());
+    pos[str.size()] = '\0';
+    kj::StringPtr result(pos, str.size());
+    pos += str.size() + 1;
+    return result;
+  };
+  for (auto& entry: entries) {
+    entry.name = copyString(entry.name);
+    entry.value = copyString(entry.value);
+  }
+
+  // Account for the same bytes that the equivalent `Header`s would.
+  auto memoryAdjustment = js.getExternalMemoryAdjustment(0);
+  memoryAdjustment.adjustNow(js, textSize - 2 * entries.size());
+
+  return Incoming{
+    .entries = kj::mv(entries),
+    .text = kj::mv(text),
+    .memoryAdjustment = kj::mv(memoryAdjustment),
+  };
+}
+
+Headers::Incoming Headers::Incoming::clone(jsg::Lock& js) const {
+  return copy(js, KJ_MAP(entry, entries) { return entry; });
+}
+
+kj::Maybe<jsg::ByteString> Headers::Incoming::get(kj::StringPtr name) const {
+  kj::Maybe<kj::StringPtr> first;
+  bool repeated = false;
+  for (auto& entry: entries) {
+    if (headerNameEquals(entry.name, name)) {
+      if (first == kj::none) {
+        first = entry.value;
+      } else {
+        repeated = true;
+        break;
+      }
+    }
+  }
+
+  KJ_IF_SOME(value, first) {
+    if (!repeated) return jsg::ByteString(kj::str(value));
+  } else {
+    return kj::none;
+  }
+
+  kj::Vector<kj::StringPtr> values;
+  for (auto& entry: entries) {
+    if (headerNameEquals(entry.name, name)) values.add(entry.value);
+  }
+  return jsg::ByteString(kj::strArray(values, ", "));
+}
+
+bool Headers::Incoming::has(kj::StringPtr name) const {
+  for (auto& entry: entries) {
+    if (headerNameEquals(entry.name, name)) return true;
+  }
+  return false;
+}
+
+void Headers::materialize(jsg::Lock& js) {
+  KJ_IF_SOME(in, incoming) {
+    auto entries = kj::mv(in.entries);
+    auto text = kj::mv(in.text);
+    incoming = kj::none;
+
+    headers.reserve(entries.size() + 16);
+    for (auto& entry: entries) {
+      appendUnguarded(js, entry.name, jsg::ByteString(kj::str(entry.value)));
+    }
+  }
 }
 
 jsg::Ref<Headers> Headers::clone(jsg::Lock& js) const {
@@ -127,6 +224,27 @@ jsg::Ref<Headers> Headers::clone(jsg::Lock& js) const {
 // Fill in the given HttpHeaders with these headers. Note that strings are inserted by
 // reference, so the output must be consumed immediately.
 void Headers::shallowCopyTo(kj::HttpHeaders& out) {
+  KJ_IF_SOME(in, incoming) {
+    // Produce the same output as the table would have: sorted by name, with repeated headers in
+    // the order they were received and all named like the first of them.
+    KJ_STACK_ARRAY(const Incoming::Entry*, sorted, in.entries.size(), 32, 128);
+    for (auto i: kj::indices(in.entries)) {
+      sorted[i] = &in.entries[i];
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](auto a, auto b) {
+      return strcasecmp(a->name.cStr(), b->name.cStr()) < 0;
+    });
+
+    kj::StringPtr name;
+    for (auto entry: sorted) {
+      if (name == nullptr || !headerNameEquals(name, entry->name)) {
+        name = getStoredName(entry->name);
+      }
+      out.add(name, entry->value);
+    }
+    return;
+  }
+
   for (const auto& entry: headers.ordered<1>()) {
     for (const auto& value: entry.values) {
       out.add(entry.getName(), value);
@@ -140,11 +258,16 @@ bool Headers::hasLowerCase(kj::StringPtr name) {
     KJ_DREQUIRE(!('A' <= c && c <= 'Z'));
   }
 #endif
+  KJ_IF_SOME(in, incoming) {
+    return in.has(name);
+  }
   return headers.find(name) != kj::none;
 }
 
 kj::Array<Headers::DisplayedHeader> Headers::getDisplayedHeaders(
     jsg::Lock& js, DisplayedHeaderOption option) {
+  materialize(js);
+
   // The fetch spec requires that iterators over Headers remain stable across mutations.
   // So we need to make a copy of the headers to pass off to the iterators.
   // The list is also required to be sorted by header name, with all header names lower-cased.
@@ -230,17 +353,21 @@ kj::Maybe<jsg::ByteString> Headers::get(jsg::Lock& js, jsg::ByteString name) {
 }
 
 kj::Maybe<jsg::ByteString> Headers::getNoChecks(jsg::Lock& js, kj::StringPtr name) {
+  KJ_IF_SOME(in, incoming) {
+    return in.get(name);
+  }
   return headers.find(name).map([](const auto& entry) { return kj::strArray(entry.values, ", "); });
 }
 
-kj::ArrayPtr<jsg::ByteString> Headers::getSetCookie() {
+kj::ArrayPtr<jsg::ByteString> Headers::getSetCookie(jsg::Lock& js) {
+  materialize(js);
   KJ_IF_SOME(found, headers.find("set-cookie"_kj)) {
     return found.values.asPtr();
   }
   return nullptr;
 }
 
-kj::ArrayPtr<jsg::ByteString> Headers::getAll(jsg::ByteString name) {
+kj::ArrayPtr<jsg::ByteString> Headers::getAll(jsg::Lock& js, jsg::ByteString name) {
   JSG_REQUIRE(requireValidHeaderName(name), TypeError, "Invalid header name.");
 
   if (strcasecmp(name.cStr(), "set-cookie") != 0) {
@@ -250,11 +377,14 @@ kj::ArrayPtr<jsg::ByteString> Headers::getAll(jsg::ByteString name) {
   // getSetCookie() is the standard API here. getAll(...) is our legacy non-standard extension
   // for the same use case. We continue to support getAll for backwards compatibility but moving
   // forward users really should be using getSetCookie.
-  return getSetCookie();
+  return getSetCookie(js);
 }
 
 bool Headers::has(jsg::ByteString name) {
   JSG_REQUIRE(requireValidHeaderName(name), TypeError, "Invalid header name.");
+  KJ_IF_SOME(in, incoming) {
+    return in.has(name);
+  }
   return headers.find(name) != kj::none;
 }
 
@@ -271,6 +401,7 @@ void Headers::setValueChecked(jsg::Lock& js, kj::StringPtr name, jsg::ByteString
 }
 
 void Headers::setUnguarded(jsg::Lock& js, kj::StringPtr name, jsg::ByteString value) {
+  materialize(js);
   kj::uint hash = hashCode(name);
   headers.findOrCreate(hash, [&]() { return Header(js, hash, name); }).set(js, kj::mv(value));
 }
@@ -288,13 +419,15 @@ void Headers::appendValueChecked(jsg::Lock& js, kj::StringPtr name, jsg::ByteStr
 }
 
 void Headers::appendUnguarded(jsg::Lock& js, kj::StringPtr name, jsg::ByteString value) {
+  materialize(js);
   auto hash = hashCode(name);
   headers.findOrCreate(hash, [&]() { return Header(js, hash, name); }).add(js, kj::mv(value));
 }
 
-void Headers::delete_(jsg::ByteString name) {
+void Headers::delete_(jsg::Lock& js, jsg::ByteString name) {
   JSG_REQUIRE(guard == Guard::NONE, TypeError, "Can't modify immutable headers.");
   JSG_REQUIRE(requireValidHeaderName(name), TypeError, "Invalid header name.");
+  materialize(js);
   headers.eraseMatch(name);
 }
 
@@ -452,6 +585,13 @@ kj::OneOf<uint, kj::String> getNameOrIdx(uint hash, kj::StringPtr name) {
   }
   return kj::str(name);
 }
+
+kj::StringPtr getStoredName(kj::StringPtr name) {
+  KJ_IF_SOME(idx, getCommonHeaderMap().find(Headers::hashCode(name))) {
+    return getCommonHeaderList()[idx];
+  }
+  return name;
+}
 }  // namespace
 
 void Headers::serialize(jsg::Lock& js, jsg::Serializer& serializer) {
@@ -459,6 +599,8 @@ void Headers::serialize(jsg::Lock& js, jsg::Serializer& serializer) {
   // is a common header ID, or the value zero to indicate an uncommon header, which is then
   // followed by a length-delimited name.
 
+  materialize(js);
+
   serializer.writeRawUint32(static_cast<uint>(guard));
 
   // Write the count of headers.
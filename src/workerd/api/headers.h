@@ -38,6 +38,10 @@ public:
   }
   explicit Headers(jsg::Lock& js, jsg::Dict<jsg::ByteString, jsg::ByteString> dict);
   explicit Headers(jsg::Lock& js, const Headers& other, Guard guard = Guard::NONE);
+  // Headers created from a kj::HttpHeaders are kept as a flat copy of the incoming names and
+  // values until they are modified or iterated. Lookups scan the copy, which is cheaper than
+  // building the hash and tree indexes for the common case of a worker that reads a handful of
+  // headers, or none, or forwards them unchanged.
   explicit Headers(jsg::Lock& js, const kj::HttpHeaders& other, Guard guard);
 
   Headers(Headers&&) = delete;
@@ -88,11 +92,11 @@ public:
   // getAll is a legacy non-standard extension API that we introduced before
   // getSetCookie() was defined. We continue to support it for backwards
   // compatibility but users really ought to be using getSetCookie() now.
-  kj::ArrayPtr<jsg::ByteString> getAll(jsg::ByteString name);
+  kj::ArrayPtr<jsg::ByteString> getAll(jsg::Lock& js, jsg::ByteString name);
 
   // The Set-Cookie header is special in that it is the only HTTP header that
   // is not permitted to be combined into a single instance.
-  kj::ArrayPtr<jsg::ByteString> getSetCookie();
+  kj::ArrayPtr<jsg::ByteString> getSetCookie(jsg::Lock& js);
 
   bool has(jsg::ByteString name);
 
@@ -111,7 +115,7 @@ public:
   void appendValueChecked(jsg::Lock& js, kj::StringPtr name, jsg::ByteString value);
   void appendUnguarded(jsg::Lock& js, kj::StringPtr name, jsg::ByteString value);
 
-  void delete_(jsg::ByteString name);
+  void delete_(jsg::Lock& js, jsg::ByteString name);
 
   void forEach(jsg::Lock& js,
                jsg::Function<void(jsg::JsString, jsg::JsString, jsg::Ref<Headers>)>,
@@ -174,6 +178,9 @@ public:
   JSG_SERIALIZABLE(rpc::SerializationTag::HEADERS);
 
   void visitForMemoryInfo(jsg::MemoryTracker& tracker) const {
+    KJ_IF_SOME(in, incoming) {
+      tracker.trackFieldWithSize("incoming", in.text.size());
+    }
     for (const auto& entry : headers) {
       tracker.trackField("header", entry);
     }
@@ -256,6 +263,37 @@ private:
   kj::Table<Header, kj::HashIndex<HeaderCallbacks>,
                     kj::TreeIndex<HeaderTreeCallbacks>> headers;
 
+  // The headers this object was created from, if `headers` has not been built from them yet. When
+  // set, `headers` is empty.
+  struct Incoming {
+    struct Entry {
+      kj::StringPtr name;
+      kj::StringPtr value;
+    };
+
+    // Points into `text`, in the order the headers were received.
+    kj::Array<Entry> entries;
+
+    // All names and values, each NUL-terminated.
+    kj::Array<char> text;
+
+    jsg::ExternalMemoryAdjustment memoryAdjustment;
+
+    // Copies the strings referenced by `entries` into a single buffer, and repoints `entries`
+    // at the copy.
+    static Incoming copy(jsg::Lock& js, kj::Array<Entry> entries);
+
+    Incoming clone(jsg::Lock& js) const;
+
+    kj::Maybe<jsg::ByteString> get(kj::StringPtr name) const;
+    bool has(kj::StringPtr name) const;
+  };
+  kj::Maybe<Incoming> incoming;
+
+  // Moves `incoming`, if any, into `headers`. Must be called before `headers` is modified or
+  // iterated.
+  void materialize(jsg::Lock& js);
+
   Guard guard;
 
   static kj::Maybe<kj::Array<jsg::JsRef<jsg::JsString>>> entryIteratorNext(
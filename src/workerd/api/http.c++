@@ -466,7 +466,7 @@ jsg::Ref<Request> Request::constructor(
       cacheMode = oldRequest->getCacheMode();
       redirect = oldRequest->getRedirectEnum();
       fetcher = oldRequest->getFetcher();
-      signal = oldRequest->getSignal();
+      signal = oldRequest->getSignal(js);
     }
   }
 
@@ -576,7 +576,7 @@ jsg::Ref<Request> Request::constructor(
         cacheMode = otherRequest->cacheMode;
         responseBodyEncoding = otherRequest->responseBodyEncoding;
         fetcher = otherRequest->getFetcher();
-        signal = otherRequest->getSignal();
+        signal = otherRequest->getSignal(js);
         headers = js.alloc<Headers>(js, *otherRequest->headers);
         cf = otherRequest->cf.deepClone(js);
         KJ_IF_SOME(b, otherRequest->getBody()) {
@@ -606,7 +606,7 @@ jsg::Ref<Request> Request::clone(jsg::Lock& js) {
   auto bodyClone = Body::clone(js);
 
   return js.alloc<Request>(js, method, url, redirect, kj::mv(headersClone), getFetcher(),
-      /* signal */ getSignal(), kj::mv(cfClone), kj::mv(bodyClone), /* thisSignal */ kj::none,
+      /* signal */ getSignal(js), kj::mv(cfClone), kj::mv(bodyClone), /* thisSignal */ kj::none,
       cacheMode, responseBodyEncoding);
 }
 
@@ -635,7 +635,8 @@ kj::StringPtr Request::getRedirect() {
 kj::Maybe<jsg::Ref<Fetcher>> Request::getFetcher() {
   return fetcher.map([](jsg::Ref<Fetcher>& f) { return f.addRef(); });
 }
-kj::Maybe<jsg::Ref<AbortSignal>> Request::getSignal() {
+kj::Maybe<jsg::Ref<AbortSignal>> Request::getSignal(jsg::Lock& js) {
+  allocateLazySignal(js);
   return signal.map([](jsg::Ref<AbortSignal>& s) { return s.addRef(); });
 }
 
@@ -652,6 +653,7 @@ jsg::Optional<jsg::JsObject> Request::getCf(jsg::Lock& js) {
 // The name "thisSignal" is derived from the fetch spec, which draws a
 // distinction between the "signal" and "this' signal".
 jsg::Ref<AbortSignal> Request::getThisSignal(jsg::Lock& js) {
+  allocateLazySignal(js);
   KJ_IF_SOME(s, signal) {
     return s.addRef();
   }
@@ -664,6 +666,7 @@ jsg::Ref<AbortSignal> Request::getThisSignal(jsg::Lock& js) {
 }
 
 void Request::clearSignalIfIgnoredForSubrequest(jsg::Lock& js) {
+  allocateLazySignal(js);
   KJ_IF_SOME(s, signal) {
     if (s->isIgnoredForSubrequests(js)) {
       signal = kj::none;
@@ -671,6 +674,13 @@ void Request::clearSignalIfIgnoredForSubrequest(jsg::Lock& js) {
   }
 }
 
+void Request::allocateLazySignal(jsg::Lock& js) {
+  KJ_IF_SOME(lazy, lazySignal) {
+    signal = lazy->get(js);
+    lazySignal = kj::none;
+  }
+}
+
 kj::Maybe<Request::Redirect> Request::tryParseRedirect(kj::StringPtr redirect) {
   if (strcasecmp(redirect.cStr(), "follow") == 0) {
     return Redirect::FOLLOW;
@@ -1339,7 +1349,7 @@ jsg::Promise<jsg::Ref<Response>> fetchImplNoOutputLock(jsg::Lock& js,
 
   auto& ioContext = IoContext::current();
 
-  auto signal = jsRequest->getSignal();
+  auto signal = jsRequest->getSignal(js);
   KJ_IF_SOME(s, signal) {
     // If the AbortSignal has already been triggered, then we need to stop here.
     if (s->getAborted(js)) {
@@ -1512,7 +1522,7 @@ jsg::Promise<jsg::Ref<Response>> handleHttpResponse(jsg::Lock& js,
     jsg::Ref<Request> jsRequest,
     kj::Vector<kj::Url> urlList,
     kj::HttpClient::Response&& response) {
-  auto signal = jsRequest->getSignal();
+  auto signal = jsRequest->getSignal(js);
 
   KJ_IF_SOME(s, signal) {
     // If the AbortSignal has already been triggered, then we need to stop here.
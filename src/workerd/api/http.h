@@ -683,9 +683,15 @@ class Request final: public Body {
   // used only on the JavaScript side to conform to the spec, which requires
   // request.signal to always return an AbortSignal even if one is not actively
   // used on this request.
-  kj::Maybe<jsg::Ref<AbortSignal>> getSignal();
+  kj::Maybe<jsg::Ref<AbortSignal>> getSignal(jsg::Lock& js);
   jsg::Ref<AbortSignal> getThisSignal(jsg::Lock& js);
 
+  // Gives an incoming request a signal which is only allocated when one of the above is first
+  // called.
+  void setLazySignal(kj::Own<LazyAbortSignal> signal) {
+    lazySignal = kj::mv(signal);
+  }
+
   // Clear the request's signal if the 'ignoreForSubrequests' flag is set. This happens when
   // a request from an incoming fetch is passed-through to another fetch. We want to avoid
   // aborting the subrequest in that case.
@@ -848,11 +854,17 @@ class Request final: public Body {
   // used explicitly, thisSignal will not be.
   kj::Maybe<jsg::Ref<AbortSignal>> thisSignal;
 
+  // If set, `signal` hasn't been allocated yet. See setLazySignal().
+  kj::Maybe<kj::Own<LazyAbortSignal>> lazySignal;
+
   CfProperty cf;
 
   // Controls how to handle Content-Encoding headers in the response
   Response_BodyEncoding responseBodyEncoding = Response_BodyEncoding::AUTO;
 
+  // Moves the lazy signal, if any, into `signal`, allocating it.
+  void allocateLazySignal(jsg::Lock& js);
+
   void visitForGc(jsg::GcVisitor& visitor) {
     visitor.visit(headers, fetcher, signal, thisSignal, cf);
   }
@@ -0,0 +1,245 @@
+// Copyright (c) 2017-2024 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+import assert from 'node:assert';
+
+// The requests received by the stub KV service, when this module is running as it.
+let requests = [];
+
+export default {
+  // Stub KV service (from `env.KV` and `env.SMALL_KV`), which records each request. Also the
+  // handler of the concurrent requests made by the tests, through `env.SELF`.
+  async fetch(request, env) {
+    const { pathname } = new URL(request.url);
+    if (pathname === '/concurrent/a') {
+      // Batch a put, and let request B write to the same binding before deleting the key.
+      const put = env.WINDOWED_KV.put('key', 'from-a');
+      await env.SELF.fetch('http://self/concurrent/b');
+      await Promise.all([put, env.WINDOWED_KV.delete('key')]);
+      return new Response(null);
+    } else if (pathname === '/concurrent/b') {
+      await Promise.all([
+        env.WINDOWED_KV.put('b-key', 'from-b'),
+        env.WINDOWED_KV.delete('b-key'),
+      ]);
+      return new Response(null);
+    } else if (pathname === '/requests') {
+      const result = Response.json(requests);
+      requests = [];
+      return result;
+    } else if (pathname === '/bulk/put') {
+      const puts = await request.json();
+      requests.push({ method: request.method, path: pathname, puts });
+      return Response.json(
+        puts.map((put) =>
+          put.key === 'too-large'
+            ? { status: 413, statusText: 'Payload Too Large' }
+            : null
+        )
+      );
+    } else {
+      requests.push({
+        method: request.method,
+        path: pathname,
+        value: await request.text(),
+      });
+      return new Response(null, { status: 200 });
+    }
+  },
+};
+
+async function takeRequests(env) {
+  const response = await env.STUB.fetch('http://stub/requests');
+  return await response.json();
+}
+
+export const batchesPutsInTheSameTurn = {
+  async test(ctrl, env) {
+    await Promise.all([
+      env.KV.put('a', 'value-a'),
+      env.KV.put('b', new Uint8Array([1, 2, 3]), {
+        expirationTtl: 60,
+        metadata: { some: 'metadata' },
+      }),
+      env.KV.put('c', 'value-c', { expiration: 2000000000 }),
+    ]);
+
+    assert.deepStrictEqual(await takeRequests(env), [
+      {
+        method: 'POST',
+        path: '/bulk/put',
+        puts: [
+          { key: 'a', value: 'value-a' },
+          {
+            key: 'b',
+            value: 'AQID',
+            base64: true,
+            expiration_ttl: 60,
+            metadata: { some: 'metadata' },
+          },
+          { key: 'c', value: 'value-c', expiration: 2000000000 },
+        ],
+      },
+    ]);
+  },
+};
+
+export const sendsPutsInLaterTurnsSeparately = {
+  async test(ctrl, env) {
+    await env.KV.put('a', 'value-a');
+    await env.KV.put('b', 'value-b');
+
+    const requests = await takeRequests(env);
+    assert.strictEqual(requests.length, 2);
+    assert.deepStrictEqual(requests[0].puts, [{ key: 'a', value: 'value-a' }]);
+    assert.deepStrictEqual(requests[1].puts, [{ key: 'b', value: 'value-b' }]);
+  },
+};
+
+export const rejectsOnlyTheFailedPut = {
+  async test(ctrl, env) {
+    const results = await Promise.allSettled([
+      env.KV.put('a', 'value-a'),
+      env.KV.put('too-large', 'value'),
+      env.KV.put('c', 'value-c'),
+    ]);
+
+    assert.strictEqual(results[0].status, 'fulfilled');
+    assert.strictEqual(results[1].status, 'rejected');
+    assert.strictEqual(
+      results[1].reason.message,
+      'KV PUT failed: 413 Payload Too Large'
+    );
+    assert.strictEqual(results[2].status, 'fulfilled');
+    assert.strictEqual((await takeRequests(env)).length, 1);
+  },
+};
+
+export const putsStreamsAndLargeValuesOnTheirOwn = {
+  async test(ctrl, env) {
+    const { readable, writable } = new TransformStream();
+    const writer = writable.getWriter();
+    writer.write(new TextEncoder().encode('streamed'));
+    writer.close();
+
+    await Promise.all([
+      env.SMALL_KV.put('a', 'value-a'),
+      env.SMALL_KV.put('stream', readable),
+      env.SMALL_KV.put('large', 'x'.repeat(200)),
+    ]);
+
+    // The requests are made concurrently, so may arrive in any order.
+    const requests = await takeRequests(env);
+    const byPath = Object.fromEntries(requests.map((r) => [r.path, r]));
+    assert.strictEqual(requests.length, 3);
+    assert.strictEqual(byPath['/stream'].value, 'streamed');
+    assert.strictEqual(byPath['/large'].value, 'x'.repeat(200));
+    assert.deepStrictEqual(byPath['/bulk/put'].puts, [
+      { key: 'a', value: 'value-a' },
+    ]);
+  },
+};
+
+export const sendsFullBatchesEarly = {
+  async test(ctrl, env) {
+    // Each put is sent as `{"key":"k1","value":"vvv..."}`, 53 bytes with 30 bytes of value, and
+    // is followed by a comma or the closing `]`, so only two fit in a batch of 128 bytes.
+    const value = 'v'.repeat(30);
+    await Promise.all(
+      ['k1', 'k2', 'k3', 'k4', 'k5'].map((key) => env.SMALL_KV.put(key, value))
+    );
+
+    const requests = await takeRequests(env);
+    assert.deepStrictEqual(
+      requests.map((r) => r.puts.map((put) => put.key).join()).sort(),
+      ['k1,k2', 'k3,k4', 'k5']
+    );
+  },
+};
+
+export const countsEncodedSizeTowardsTheBatchLimit = {
+  async test(ctrl, env) {
+    // 30 bytes are 40 once base64-encoded, and a quote or backslash takes two bytes once escaped,
+    // so each of these puts is too large to share a batch of 128 bytes, though its raw key and
+    // value would fit twice.
+    await Promise.all([
+      env.SMALL_KV.put('b1', new Uint8Array(30)),
+      env.SMALL_KV.put('b2', new Uint8Array(30)),
+      env.SMALL_KV.put('q1', '"'.repeat(30)),
+      env.SMALL_KV.put('q2', '\\'.repeat(30)),
+    ]);
+
+    const requests = await takeRequests(env);
+    assert.deepStrictEqual(
+      requests.map((r) => r.puts.map((put) => put.key).join()).sort(),
+      ['b1', 'b2', 'q1', 'q2']
+    );
+  },
+};
+
+export const sendsBatchedPutsBeforeLaterWritesOfTheSameKey = {
+  async test(ctrl, env) {
+    // The large put can't be batched, so is sent on its own, but only once the batched put of the
+    // same key before it has completed, so it isn't overwritten by it.
+    await Promise.all([
+      env.SMALL_KV.put('key', 'batched'),
+      env.SMALL_KV.put('key', 'x'.repeat(200)),
+    ]);
+    // Likewise, the put isn't sent after the delete that follows it.
+    await Promise.all([env.KV.put('key', 'batched'), env.KV.delete('key')]);
+
+    const requests = await takeRequests(env);
+    assert.deepStrictEqual(
+      requests.map((r) => [r.method, r.path]),
+      [
+        ['POST', '/bulk/put'],
+        ['PUT', '/key'],
+        ['POST', '/bulk/put'],
+        ['DELETE', '/key'],
+      ]
+    );
+    assert.deepStrictEqual(requests[0].puts, [{ key: 'key', value: 'batched' }]);
+    assert.strictEqual(requests[1].value, 'x'.repeat(200));
+    assert.deepStrictEqual(requests[2].puts, [{ key: 'key', value: 'batched' }]);
+  },
+};
+
+export const batchesPutsAcrossTurnsWithinTheWindow = {
+  async test(ctrl, env) {
+    const first = env.WINDOWED_KV.put('a', 'value-a');
+    // Yield to the event loop, so that the next put is made in a later turn.
+    await new Promise((resolve) => setTimeout(resolve, 0));
+    await Promise.all([first, env.WINDOWED_KV.put('b', 'value-b')]);
+
+    assert.deepStrictEqual(await takeRequests(env), [
+      {
+        method: 'POST',
+        path: '/bulk/put',
+        puts: [
+          { key: 'a', value: 'value-a' },
+          { key: 'b', value: 'value-b' },
+        ],
+      },
+    ]);
+  },
+};
+
+export const ordersEachRequestsWritesSeparately = {
+  async test(ctrl, env) {
+    // Request A's batched put is still waiting out its window when request B puts and deletes. B
+    // mustn't take over A's batch, so A's delete still waits for A's put.
+    const response = await env.SELF.fetch('http://self/concurrent/a');
+    assert.strictEqual(response.status, 200);
+
+    const requests = await takeRequests(env);
+    assert.deepStrictEqual(
+      requests.map((r) =>
+        r.path === '/bulk/put'
+          ? r.puts.map((put) => put.key).join()
+          : `${r.method} ${r.path}`
+      ),
+      ['b-key', 'DELETE /b-key', 'key', 'DELETE /key']
+    );
+  },
+};
@@ -21,13 +21,20 @@ namespace workerd::api {
 // As documented in Cloudflare's Worker KV limits.
 static constexpr size_t kMaxKeyLength = 512;
 
+// As documented in Cloudflare's Worker KV limits.
+static constexpr size_t kMaxBulkPutKeys = 10000;
+
+static kj::Exception kvError(kj::StringPtr method, kj::StringPtr status) {
+  // Manually construct exception so that we can incorporate method and status into the text
+  // that JavaScript sees.
+  return kj::Exception(kj::Exception::Type::FAILED, __FILE__, __LINE__,
+      kj::str(JSG_EXCEPTION(Error) ": KV ", method, " failed: ", status));
+}
+
 static void checkForErrorStatus(kj::StringPtr method, const kj::HttpClient::Response& response) {
   if (response.statusCode < 200 || response.statusCode >= 300) {
-    // Manually construct exception so that we can incorporate method and status into the text
-    // that JavaScript sees.
-    kj::throwFatalException(kj::Exception(kj::Exception::Type::FAILED, __FILE__, __LINE__,
-        kj::str(JSG_EXCEPTION(Error) ": KV ", method, " failed: ", response.statusCode, ' ',
-            response.statusText)));
+    kj::throwFatalException(
+        kvError(method, kj::str(response.statusCode, ' ', response.statusText)));
   }
 }
 
@@ -494,27 +501,11 @@ jsg::Promise<void> KvNamespace::put(jsg::Lock& js,
 
     auto& context = IoContext::current();
 
-    kj::Url url;
-    url.scheme = kj::str("https");
-    url.host = kj::str("fake-host");
-    url.path.add(kj::mv(name));
-    url.query.add(kj::Url::QueryParam{kj::str("urlencoded"), kj::str("true")});
-
-    kj::HttpHeaders headers(context.getHeaderTable());
-
-    // If any optional parameters were specified by the client, append them to
-    // the URL's query parameters.
+    kj::Maybe<kj::String> metadataJson;
     KJ_IF_SOME(o, options) {
-      KJ_IF_SOME(expiration, o.expiration) {
-        url.query.add(kj::Url::QueryParam{kj::str("expiration"), kj::str(expiration)});
-      }
-      KJ_IF_SOME(expirationTtl, o.expirationTtl) {
-        url.query.add(kj::Url::QueryParam{kj::str("expiration_ttl"), kj::str(expirationTtl)});
-      }
       KJ_IF_SOME(maybeMetadata, o.metadata) {
         KJ_IF_SOME(metadata, maybeMetadata) {
-          kj::String json = metadata.getHandle(js).toJson(js);
-          headers.set(context.getHeaderIds().cfKvMetadata, kj::mv(json));
+          metadataJson = metadata.getHandle(js).toJson(js);
         }
       }
     }
@@ -536,6 +527,64 @@ jsg::Promise<void> KvNamespace::put(jsg::Lock& js,
       }
     }
 
+    KJ_IF_SOME(wb, writeBehind) {
+      // Streams are written as they're read, so are never batched.
+      if (!supportedBody.is<jsg::Ref<ReadableStream>>()) {
+        kj::Maybe<int> expiration;
+        kj::Maybe<int> expirationTtl;
+        KJ_IF_SOME(o, options) {
+          expiration = o.expiration;
+          expirationTtl = o.expirationTtl;
+        }
+        auto metadata = metadataJson.map([](kj::String& json) -> kj::StringPtr { return json; });
+        size_t size = bulkPutEntrySize(name, supportedBody, metadata, expiration, expirationTtl);
+
+        // A value too large to share a batch is put on its own.
+        if (PutBatch::EMPTY_BYTES + size <= wb.maxBatchBytes) {
+          kj::OneOf<kj::String, kj::Array<byte>> value;
+          KJ_IF_SOME(text, supportedBody.tryGet<kj::String>()) {
+            value = kj::mv(text);
+          } else {
+            value = kj::mv(supportedBody.get<kj::Array<byte>>());
+          }
+
+          auto paf = js.newPromiseAndResolver<void>();
+          PutBatch::Entry entry{
+            .key = kj::mv(name),
+            .value = kj::mv(value),
+            .expiration = expiration,
+            .expirationTtl = expirationTtl,
+            .metadata = kj::mv(metadataJson),
+            .resolver = kj::mv(paf.resolver),
+          };
+          addToPutBatch(js, context, wb, kj::mv(entry), size);
+          return kj::mv(paf.promise);
+        }
+      }
+    }
+
+    kj::Url url;
+    url.scheme = kj::str("https");
+    url.host = kj::str("fake-host");
+    url.path.add(kj::mv(name));
+    url.query.add(kj::Url::QueryParam{kj::str("urlencoded"), kj::str("true")});
+
+    kj::HttpHeaders headers(context.getHeaderTable());
+
+    // If any optional parameters were specified by the client, append them to
+    // the URL's query parameters.
+    KJ_IF_SOME(o, options) {
+      KJ_IF_SOME(expiration, o.expiration) {
+        url.query.add(kj::Url::QueryParam{kj::str("expiration"), kj::str(expiration)});
+      }
+      KJ_IF_SOME(expirationTtl, o.expirationTtl) {
+        url.query.add(kj::Url::QueryParam{kj::str("expiration_ttl"), kj::str(expirationTtl)});
+      }
+    }
+    KJ_IF_SOME(json, metadataJson) {
+      headers.set(context.getHeaderIds().cfKvMetadata, kj::mv(json));
+    }
+
     kj::Maybe<uint64_t> expectedBodySize;
 
     KJ_SWITCH_ONEOF(supportedBody) {
@@ -556,7 +605,7 @@ jsg::Promise<void> KvNamespace::put(jsg::Lock& js,
     auto client =
         getHttpClient(context, headers, LimitEnforcer::KvOpType::PUT, urlStr, kj::mv(options));
 
-    auto promise = context.waitForOutputLocks().then(
+    auto promise = waitToWrite(js, context).then(
         [&context, client = kj::mv(client), urlStr = kj::mv(urlStr), headers = kj::mv(headers),
             expectedBodySize, supportedBody = kj::mv(supportedBody)]() mutable {
       auto innerReq = client->request(kj::HttpMethod::PUT, urlStr, headers, expectedBodySize);
@@ -600,6 +649,266 @@ jsg::Promise<void> KvNamespace::put(jsg::Lock& js,
   });
 }
 
+// Whether `weakContext` still refers to `context`.
+static bool isContext(WeakRef<IoContext>& weakContext, IoContext& context) {
+  KJ_IF_SOME(c, weakContext.tryGet()) {
+    return &c == &context;
+  }
+  return false;
+}
+
+// The size of `text` once encoded as a JSON string, including its quotes.
+static size_t jsonStringSize(kj::StringPtr text) {
+  size_t size = 2;
+  for (char c: text) {
+    if (c == '"' || c == '\\' || c == '\b' || c == '\f' || c == '\n' || c == '\r' || c == '\t') {
+      size += 2;
+    } else if (static_cast<byte>(c) < 0x20) {
+      // Other control characters are written as \u00XX.
+      size += 6;
+    } else {
+      size += 1;
+    }
+  }
+  return size;
+}
+
+size_t KvNamespace::bulkPutEntrySize(kj::StringPtr key,
+    const PutSupportedTypes& value,
+    kj::Maybe<kj::StringPtr> metadata,
+    kj::Maybe<int> expiration,
+    kj::Maybe<int> expirationTtl) {
+  // This must match the object that sendPuts() writes for the entry: `{"key":...,"value":...}`,
+  // with the optional fields in between, and a comma separating it from the entry before.
+  size_t size = "{\"key\":,\"value\":},"_kj.size() + jsonStringSize(key);
+  KJ_SWITCH_ONEOF(value) {
+    KJ_CASE_ONEOF(text, kj::String) {
+      size += jsonStringSize(text);
+    }
+    KJ_CASE_ONEOF(data, kj::Array<byte>) {
+      size += 2 + (data.size() + 2) / 3 * 4;
+      size += ",\"base64\":true"_kj.size();
+    }
+    KJ_CASE_ONEOF(stream, jsg::Ref<ReadableStream>) {
+      KJ_UNREACHABLE;
+    }
+  }
+  KJ_IF_SOME(e, expiration) {
+    size += ",\"expiration\":"_kj.size() + kj::str(e).size();
+  }
+  KJ_IF_SOME(e, expirationTtl) {
+    size += ",\"expiration_ttl\":"_kj.size() + kj::str(e).size();
+  }
+  KJ_IF_SOME(json, metadata) {
+    size += ",\"metadata\":"_kj.size() + json.size();
+  }
+  return size;
+}
+
+KvNamespace::ContextPuts& KvNamespace::getContextPuts(IoContext& context) {
+  for (auto& puts: contextPuts) {
+    if (isContext(*puts.context, context)) {
+      return puts;
+    }
+  }
+
+  kj::Vector<ContextPuts> live(contextPuts.size() + 1);
+  for (auto& puts: contextPuts) {
+    if (puts.context->isValid()) {
+      live.add(kj::mv(puts));
+    }
+  }
+  contextPuts = kj::mv(live);
+  return contextPuts.add(ContextPuts{.context = context.getWeakRef()});
+}
+
+kj::Promise<void> KvNamespace::whenPutsDone(IoContext& context) {
+  KJ_IF_SOME(done, getContextPuts(context).lastSentDone) {
+    return done->addBranch();
+  }
+  return kj::READY_NOW;
+}
+
+kj::Promise<void> KvNamespace::waitToWrite(jsg::Lock& js, IoContext& context) {
+  if (writeBehind == kj::none) {
+    return context.waitForOutputLocks();
+  }
+
+  // A write mustn't overtake a put that was made before it, but is still waiting in a batch. So
+  // the batch is sent now, and the write waits for it to complete.
+  KJ_IF_SOME(batch, getContextPuts(context).pending) {
+    auto pending = kj::addRef(*batch);
+    sendPuts(js, kj::mv(pending));
+  }
+  return context.waitForOutputLocks().then(
+      [putsDone = whenPutsDone(context)]() mutable { return kj::mv(putsDone); });
+}
+
+void KvNamespace::addToPutBatch(jsg::Lock& js,
+    IoContext& context,
+    const WriteBehindOptions& options,
+    PutBatch::Entry entry,
+    size_t size) {
+  // Each put counts against the KV usage limits as it would if sent on its own. (This will throw
+  // if we've hit them.)
+  context.getLimitEnforcer().newKvRequest(LimitEnforcer::KvOpType::PUT);
+
+  KJ_IF_SOME(batch, getContextPuts(context).pending) {
+    if (batch->bytes + size > options.maxBatchBytes || batch->entries.size() == kMaxBulkPutKeys) {
+      // The batch is full, so send it now rather than at the end of its window.
+      auto full = kj::addRef(*batch);
+      sendPuts(js, kj::mv(full));
+    }
+  }
+
+  auto& puts = getContextPuts(context);
+  if (puts.pending == kj::none) {
+    auto batch = kj::refcounted<PutBatch>();
+    auto sendLater = JSG_VISITABLE_LAMBDA((self = JSG_THIS, batch = kj::addRef(*batch)), (self),
+        (jsg::Lock & js) mutable { self->sendPuts(js, kj::mv(batch)); });
+    if (options.window == 0 * kj::MILLISECONDS) {
+      // Send the batch once the code which is running now yields, having made all of the puts
+      // that it's going to make in this turn.
+      js.resolvedPromise().then(js, kj::mv(sendLater));
+    } else {
+      context.awaitIo(js, context.afterLimitTimeout(options.window))
+          .then(js, kj::mv(sendLater),
+              [batch = kj::addRef(*batch)](jsg::Lock& js, jsg::Value error) mutable {
+        batch->rejectAll(js, error.getHandle(js));
+      });
+    }
+    puts.pending = kj::mv(batch);
+  }
+
+  auto& batch = *KJ_ASSERT_NONNULL(puts.pending);
+  batch.entries.add(kj::mv(entry));
+  batch.bytes += size;
+}
+
+void KvNamespace::sendPuts(jsg::Lock& js, kj::Own<PutBatch> pending) {
+  if (pending->sent) {
+    // It was sent early, because it was full.
+    return;
+  }
+  pending->sent = true;
+  for (auto& puts: contextPuts) {
+    KJ_IF_SOME(p, puts.pending) {
+      if (p.get() == pending.get()) {
+        puts.pending = kj::none;
+      }
+    }
+  }
+
+  // Once sent, the batch is no longer visited by visitForGc(). So its entries move to a batch of
+  // their own, as moving a resolver makes its handle strong again.
+  auto batch = kj::refcounted<PutBatch>();
+  batch->entries.reserve(pending->entries.size());
+  for (auto& entry: pending->entries) {
+    batch->entries.add(kj::mv(entry));
+  }
+  pending->entries.clear();
+
+  js.tryCatch([&] {
+    auto& context = IoContext::current();
+
+    // Batches are sent one after another, so that a put in one can't overtake a put of the same
+    // key in the batch before.
+    auto previousPutsDone = whenPutsDone(context);
+
+    auto entries = js.arr(
+        batch->entries.asPtr(), [](jsg::Lock& js, const PutBatch::Entry& entry) -> jsg::JsValue {
+      auto object = js.obj();
+      object.set(js, "key", js.str(entry.key));
+      KJ_SWITCH_ONEOF(entry.value) {
+        KJ_CASE_ONEOF(text, kj::String) {
+          object.set(js, "value", js.str(text));
+        }
+        KJ_CASE_ONEOF(data, kj::Array<byte>) {
+          object.set(js, "value", js.str(kj::encodeBase64(data)));
+          object.set(js, "base64", js.boolean(true));
+        }
+      }
+      KJ_IF_SOME(expiration, entry.expiration) {
+        object.set(js, "expiration", js.num(expiration));
+      }
+      KJ_IF_SOME(expirationTtl, entry.expirationTtl) {
+        object.set(js, "expiration_ttl", js.num(expirationTtl));
+      }
+      KJ_IF_SOME(metadata, entry.metadata) {
+        object.set(js, "metadata", jsg::JsValue::fromJson(js, metadata));
+      }
+      return object;
+    });
+    kj::String body = jsg::JsValue(entries).toJson(js);
+    kj::Maybe<uint64_t> expectedBodySize = uint64_t(body.size());
+
+    auto headers = kj::HttpHeaders(context.getHeaderTable());
+    headers.set(kj::HttpHeaderId::CONTENT_TYPE, MimeType::JSON.toString());
+
+    auto urlStr = kj::str("https://fake-host/bulk/put");
+
+    auto client = getHttpClient(context, headers, "kv_put_bulk"_kjc, urlStr, kj::none);
+
+    auto promise = context.waitForOutputLocks()
+                       .then([previousPutsDone = kj::mv(previousPutsDone)]() mutable {
+      return kj::mv(previousPutsDone);
+    }).then([client = kj::mv(client), urlStr = kj::mv(urlStr), headers = kj::mv(headers),
+                expectedBodySize, body = kj::mv(body)]() mutable {
+      auto innerReq = client->request(kj::HttpMethod::POST, urlStr, headers, expectedBodySize);
+      struct RefcountedWrapper: public kj::Refcounted {
+        explicit RefcountedWrapper(kj::Own<kj::HttpClient> client): client(kj::mv(client)) {}
+        kj::Own<kj::HttpClient> client;
+      };
+      auto rcClient = kj::refcounted<RefcountedWrapper>(kj::mv(client));
+      auto req = attachToRequest(kj::mv(innerReq), kj::mv(rcClient));
+
+      auto writePromise = req.body->write(body.asBytes()).attach(kj::mv(body));
+
+      return writePromise.attach(kj::mv(req.body)).then([resp = kj::mv(req.response)]() mutable {
+        return resp.then([](kj::HttpClient::Response&& response) mutable {
+          checkForErrorStatus("PUT", response);
+          return response.body->readAllText().attach(kj::mv(response.body));
+        });
+      });
+    });
+
+    // Later writes wait until this batch's request has completed, whether or not it succeeded.
+    auto done = kj::newPromiseAndFulfiller<void>();
+    promise = promise.attach(
+        kj::defer([fulfiller = kj::mv(done.fulfiller)]() mutable { fulfiller->fulfill(); }));
+    getContextPuts(context).lastSentDone = context.addObject(kj::heap(done.promise.fork()));
+
+    // The response is a JSON array with one result per put, in order: null if the put succeeded,
+    // or otherwise an object with the `status` and `statusText` it failed with.
+    context.awaitIo(js, kj::mv(promise))
+        .then(js, [batch = kj::addRef(*batch)](jsg::Lock& js, kj::String text) mutable {
+      js.tryCatch([&] {
+        auto& entries = batch->entries;
+        auto results = JSG_REQUIRE_NONNULL(jsg::JsValue::fromJson(js, text).tryCast<jsg::JsArray>(),
+            Error, "KV PUT failed: the bulk response is not an array.");
+        JSG_REQUIRE(results.size() == entries.size(), Error,
+            "KV PUT failed: the bulk response has ", results.size(), " results for ",
+            entries.size(), " puts.");
+        for (auto i: kj::indices(entries)) {
+          auto result = results.get(js, i);
+          if (result.isNullOrUndefined()) {
+            entries[i].resolver.resolve(js);
+          } else {
+            auto error = JSG_REQUIRE_NONNULL(result.tryCast<jsg::JsObject>(), Error,
+                "KV PUT failed: the bulk response has a malformed result.");
+            entries[i].resolver.reject(js,
+                kvError("PUT",
+                    kj::str(error.get(js, "status").toString(js), ' ',
+                        error.get(js, "statusText").toString(js))));
+          }
+        }
+      }, [&](jsg::Value error) { batch->rejectAll(js, error.getHandle(js)); });
+    }, [batch = kj::addRef(*batch)](jsg::Lock& js, jsg::Value error) mutable {
+      batch->rejectAll(js, error.getHandle(js));
+    });
+  }, [&](jsg::Value error) { batch->rejectAll(js, error.getHandle(js)); });
+}
+
 jsg::Promise<void> KvNamespace::delete_(jsg::Lock& js, kj::String name) {
   return js.evalNow([&] {
     validateKeyName("DELETE", name);
@@ -613,7 +922,7 @@ jsg::Promise<void> KvNamespace::delete_(jsg::Lock& js, kj::String name) {
     auto client =
         getHttpClient(context, headers, LimitEnforcer::KvOpType::DELETE, urlStr, kj::none);
 
-    auto promise = context.waitForOutputLocks().then(
+    auto promise = waitToWrite(js, context).then(
         [headers = kj::mv(headers), client = kj::mv(client), urlStr = kj::mv(urlStr)]() mutable {
       return client->request(kj::HttpMethod::DELETE, urlStr, headers, uint64_t(0))
           .response
@@ -6,8 +6,10 @@
 
 #include <workerd/api/streams/readable.h>
 #include <workerd/api/worker-rpc.h>
+#include <workerd/io/io-own.h>
 #include <workerd/io/limit-enforcer.h>
 #include <workerd/jsg/jsg.h>
+#include <workerd/util/weak-refs.h>
 
 namespace kj {
 class HttpClient;
@@ -31,12 +33,26 @@ class KvNamespace: public jsg::Object {
     }
   };
 
+  // With write-behind, put()s aren't sent one at a time. Puts made within `window` of the first
+  // one (or within the same turn of the event loop, if `window` is zero) are collected and sent to
+  // the namespace together, as one request to `/bulk/put`. A batch is sent early once its request
+  // body would exceed `maxBatchBytes`. Each put's promise still settles from that put's own result
+  // in the bulk response. Streamed values are never batched, and a write that isn't batched waits
+  // for the puts that its request batched before it. Each request's puts are batched separately.
+  struct WriteBehindOptions {
+    kj::Duration window;
+    size_t maxBatchBytes;
+  };
+
   // `subrequestChannel` is what to pass to IoContext::getHttpClient() to get an HttpClient
   // representing this namespace. It is also used to construct fetcher for JSRPC methods.
   // `additionalHeaders` is what gets appended to every outbound request.
-  explicit KvNamespace(kj::Array<AdditionalHeader> additionalHeaders, uint subrequestChannel)
+  explicit KvNamespace(kj::Array<AdditionalHeader> additionalHeaders,
+      uint subrequestChannel,
+      kj::Maybe<WriteBehindOptions> writeBehind = kj::none)
       : additionalHeaders(kj::mv(additionalHeaders)),
-        subrequestChannel(subrequestChannel) {}
+        subrequestChannel(subrequestChannel),
+        writeBehind(writeBehind) {}
 
   struct GetOptions {
     jsg::Optional<kj::String> type;
@@ -258,8 +274,90 @@ class KvNamespace: public jsg::Object {
       kj::Maybe<kj::OneOf<ListOptions, kj::OneOf<kj::String, GetOptions>, PutOptions>> options);
 
  private:
+  // Puts collected for one write-behind request to `/bulk/put`.
+  struct PutBatch: public kj::Refcounted {
+    struct Entry {
+      kj::String key;
+      kj::OneOf<kj::String, kj::Array<byte>> value;
+      kj::Maybe<int> expiration;
+      kj::Maybe<int> expirationTtl;
+      kj::Maybe<kj::String> metadata;
+      jsg::Promise<void>::Resolver resolver;
+    };
+
+    // The size of the body of a request with no puts: `[]`, less the comma before the first put,
+    // which bulkPutEntrySize() counts.
+    static constexpr size_t EMPTY_BYTES = 1;
+
+    kj::Vector<Entry> entries;
+    // The size of the JSON request body that the batch will be sent as.
+    size_t bytes = EMPTY_BYTES;
+
+    // Set once the batch has been sent, possibly before its window ended, as it was full.
+    bool sent = false;
+
+    void rejectAll(jsg::Lock& js, v8::Local<v8::Value> error) {
+      for (auto& entry: entries) {
+        entry.resolver.reject(js, error);
+      }
+    }
+
+    void visitForGc(jsg::GcVisitor& visitor) {
+      for (auto& entry: entries) {
+        visitor.visit(entry.resolver);
+      }
+    }
+  };
+
+  // The write-behind state of one IoContext. Concurrent requests share this object, but each one's
+  // puts are batched, and its writes ordered, apart from the others'.
+  struct ContextPuts {
+    kj::Own<WeakRef<IoContext>> context;
+
+    // The batch that new puts are added to, if it isn't full or sent yet.
+    kj::Maybe<kj::Own<PutBatch>> pending;
+
+    // Resolves once the batch sent last has completed. Later writes wait for it before they're
+    // sent.
+    kj::Maybe<IoOwn<kj::ForkedPromise<void>>> lastSentDone;
+  };
+
   kj::Array<AdditionalHeader> additionalHeaders;
   uint subrequestChannel;
+  kj::Maybe<WriteBehindOptions> writeBehind;
+
+  // One entry for each IoContext that has used write-behind. Entries of IoContexts which have
+  // ended are dropped when a new one is added.
+  kj::Vector<ContextPuts> contextPuts;
+
+  // The number of bytes that a put adds to the body of a request to `/bulk/put`.
+  static size_t bulkPutEntrySize(kj::StringPtr key,
+      const PutSupportedTypes& value,
+      kj::Maybe<kj::StringPtr> metadata,
+      kj::Maybe<int> expiration,
+      kj::Maybe<int> expirationTtl);
+
+  ContextPuts& getContextPuts(IoContext& context);
+  // Resolves once the last batch sent from `context` has completed.
+  kj::Promise<void> whenPutsDone(IoContext& context);
+  // Resolves once a write that isn't batched may be sent: after the output locks, and after any
+  // puts batched before it.
+  kj::Promise<void> waitToWrite(jsg::Lock& js, IoContext& context);
+
+  void addToPutBatch(jsg::Lock& js,
+      IoContext& context,
+      const WriteBehindOptions& options,
+      PutBatch::Entry entry,
+      size_t size);
+  void sendPuts(jsg::Lock& js, kj::Own<PutBatch> pending);
+
+  void visitForGc(jsg::GcVisitor& visitor) {
+    for (auto& puts: contextPuts) {
+      KJ_IF_SOME(batch, puts.pending) {
+        batch->visitForGc(visitor);
+      }
+    }
+  }
 };
 
 #define EW_KV_ISOLATE_TYPES                                                                        \
@@ -85,6 +85,11 @@ class SecretKey final: public CryptoKey::Impl {
     return jsg::BufferSource(js, kj::mv(backing));
   }
 
+  bool initHmac(HMAC_CTX* ctx, const EVP_MD* md) const override {
+    hmacSchedule.init(ctx, md, rawKeyData());
+    return true;
+  }
+
   kj::StringPtr jsgGetMemoryName() const override {
     return "SecretKey";
   }
@@ -105,6 +110,9 @@ class SecretKey final: public CryptoKey::Impl {
 
  private:
   jsg::BufferSource keyData;
+
+  // Mutable because it is built on first use, by const operations.
+  mutable HmacKeySchedule hmacSchedule;
 };
 
 CryptoKey::AsymmetricKeyDetails getRsaKeyDetails(jsg::Lock& js, const ncrypto::EVPKeyPointer& key) {
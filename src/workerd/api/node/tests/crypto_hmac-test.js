@@ -550,3 +550,56 @@ export const hmac_misc_tests = {
     }
   },
 };
+
+export const hmac_key_reuse_tests = {
+  async test(ctrl, env, ctx) {
+    // Keys keep a precomputed key schedule that is reused across HMACs. The results must match
+    // HMACs computed from the raw key bytes each time.
+    const data = Buffer.alloc(64, 'x');
+
+    for (const size of [0, 16, 64, 200]) {
+      const raw = Buffer.alloc(size, 'k');
+      const keyObject = crypto.createSecretKey(raw);
+      // Switching digests rebuilds the schedule; switching back must not reuse a stale one.
+      for (const algorithm of ['sha256', 'sha256', 'sha512', 'sha256', 'sha1']) {
+        assert.deepStrictEqual(
+          crypto.createHmac(algorithm, keyObject).update(data).digest(),
+          crypto.createHmac(algorithm, raw).update(data).digest()
+        );
+      }
+    }
+
+    const { subtle } = globalThis.crypto;
+    for (const [hash, algorithm] of [
+      ['SHA-256', 'sha256'],
+      ['SHA-512', 'sha512'],
+    ]) {
+      const raw = Buffer.alloc(32, 'k');
+      const key = await subtle.importKey('raw', raw, { name: 'HMAC', hash }, true, [
+        'sign',
+        'verify',
+      ]);
+      for (let i = 0; i < 3; i++) {
+        const message = Buffer.from(`message ${i}`);
+        const signature = Buffer.from(await subtle.sign('HMAC', key, message));
+        assert.deepStrictEqual(
+          signature,
+          crypto.createHmac(algorithm, raw).update(message).digest()
+        );
+        assert.ok(await subtle.verify('HMAC', key, signature, message));
+        signature[0] ^= 1;
+        assert.ok(!(await subtle.verify('HMAC', key, signature, message)));
+      }
+
+      // The same key used through node:crypto with a different digest, then through Web Crypto.
+      assert.deepStrictEqual(
+        crypto.createHmac('sha1', crypto.KeyObject.from(key)).update(data).digest(),
+        crypto.createHmac('sha1', raw).update(data).digest()
+      );
+      assert.deepStrictEqual(
+        Buffer.from(await subtle.sign('HMAC', key, data)),
+        crypto.createHmac(algorithm, raw).update(data).digest()
+      );
+    }
+  },
+};
@@ -797,6 +797,26 @@ export const copyAndRenameSyncTest = {
   },
 };
 
+export const copyFromBundleSyncTest = {
+  test() {
+    const original = readFileSync('/bundle/worker').toString();
+    copyFileSync('/bundle/worker', '/tmp/worker-copy.js');
+    strictEqual(readFileSync('/tmp/worker-copy.js').toString(), original);
+
+    // The copy is writable, and writing to it leaves the bundle file unchanged.
+    const fd = openSync('/tmp/worker-copy.js', 'r+');
+    writeSync(fd, 'changed');
+    closeSync(fd);
+    strictEqual(
+      readFileSync('/tmp/worker-copy.js').toString(),
+      'changed' + original.slice('changed'.length)
+    );
+    strictEqual(readFileSync('/bundle/worker').toString(), original);
+
+    unlinkSync('/tmp/worker-copy.js');
+  },
+};
+
 export const copyAndRenameAsyncCallbackTest = {
   async test() {
     ok(!existsSync('/tmp/test.txt'));
@@ -94,6 +94,10 @@ export default {
     assert.deepStrictEqual(batch.messages[4].body, new Map([['key', 'value']]));
     assert.strictEqual(batch.messages[4].attempts, 5);
 
+    // The messages array and each deserialized body are created once and then reused.
+    assert.strictEqual(batch.messages, batch.messages);
+    assert.strictEqual(batch.messages[2].body, batch.messages[2].body);
+
     batch.ackAll();
   },
 
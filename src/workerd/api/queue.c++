@@ -131,8 +131,9 @@ struct SerializedWithOptions {
   kj::Maybe<int> delaySeconds;
 };
 
+// Leaves `body` intact unless deserialization succeeds, so that a failed attempt can be repeated.
 jsg::JsValue deserialize(
-    jsg::Lock& js, kj::Array<kj::byte> body, kj::Maybe<kj::StringPtr> contentType) {
+    jsg::Lock& js, kj::Array<kj::byte>& body, kj::Maybe<kj::StringPtr> contentType) {
   auto type = contentType.orDefault(IncomingQueueMessage::ContentType::V8);
 
   if (type == IncomingQueueMessage::ContentType::TEXT) {
@@ -147,27 +148,6 @@ jsg::JsValue deserialize(
     JSG_FAIL_REQUIRE(TypeError, kj::str("Unsupported queue message content type: ", type));
   }
 }
-
-jsg::JsValue deserialize(jsg::Lock& js, rpc::QueueMessage::Reader message) {
-  kj::StringPtr type = message.getContentType();
-  if (type == "") {
-    // default to v8 format
-    type = IncomingQueueMessage::ContentType::V8;
-  }
-
-  if (type == IncomingQueueMessage::ContentType::TEXT) {
-    return js.str(message.getData().asChars());
-  } else if (type == IncomingQueueMessage::ContentType::BYTES) {
-    kj::Array<kj::byte> bytes = kj::heapArray(message.getData().asBytes());
-    return jsg::JsValue(js.bytes(kj::mv(bytes)).getHandle(js));
-  } else if (type == IncomingQueueMessage::ContentType::JSON) {
-    return jsg::JsValue::fromJson(js, message.getData().asChars());
-  } else if (type == IncomingQueueMessage::ContentType::V8) {
-    return jsg::JsValue(jsg::Deserializer(js, message.getData()).readValue(js));
-  } else {
-    JSG_FAIL_REQUIRE(TypeError, kj::str("Unsupported queue message content type: ", type));
-  }
-}
 }  // namespace
 
 kj::Promise<void> WorkerQueue::send(
@@ -343,7 +323,12 @@ QueueMessage::QueueMessage(
     jsg::Lock& js, rpc::QueueMessage::Reader message, IoPtr<QueueEventResult> result)
     : id(kj::str(message.getId())),
       timestamp(message.getTimestampNs() * kj::NANOSECONDS + kj::UNIX_EPOCH),
-      body(deserialize(js, message).addRef(js)),
+      body(SerializedBody{
+        .data = kj::heapArray(message.getData().asBytes()),
+        .contentType = message.hasContentType() && message.getContentType().size() > 0
+            ? kj::Maybe(kj::str(message.getContentType()))
+            : kj::none,
+      }),
       attempts(message.getAttempts()),
       result(result) {}
 // Note that we must make deep copies of all data here since the incoming Reader may be
@@ -353,12 +338,25 @@ QueueMessage::QueueMessage(
     jsg::Lock& js, IncomingQueueMessage message, IoPtr<QueueEventResult> result)
     : id(kj::mv(message.id)),
       timestamp(message.timestamp),
-      body(deserialize(js, kj::mv(message.body), message.contentType).addRef(js)),
+      body(SerializedBody{
+        .data = kj::mv(message.body),
+        .contentType = kj::mv(message.contentType),
+      }),
       attempts(message.attempts),
       result(result) {}
 
 jsg::JsValue QueueMessage::getBody(jsg::Lock& js) {
-  return body.getHandle(js);
+  KJ_SWITCH_ONEOF(body) {
+    KJ_CASE_ONEOF(value, jsg::JsRef<jsg::JsValue>) {
+      return value.getHandle(js);
+    }
+    KJ_CASE_ONEOF(serialized, SerializedBody) {
+      auto value = deserialize(js, serialized.data, serialized.contentType);
+      body = value.addRef(js);
+      return value;
+    }
+  }
+  KJ_UNREACHABLE;
 }
 
 void QueueMessage::retry(jsg::Optional<QueueRetryOptions> options) {
@@ -435,6 +433,22 @@ QueueEvent::QueueEvent(jsg::Lock& js, Params params, IoPtr<QueueEventResult> res
   messages = messagesBuilder.finish();
 }
 
+jsg::JsArray QueueEvent::getMessages(
+    jsg::Lock& js, const jsg::TypeHandler<jsg::Ref<QueueMessage>>& messageHandler) {
+  KJ_IF_SOME(array, messagesArray) {
+    return array.getHandle(js);
+  }
+
+  v8::LocalVector<v8::Value> values(js.v8Isolate);
+  values.reserve(messages.size());
+  for (auto& message: messages) {
+    values.push_back(messageHandler.wrap(js, message.addRef()));
+  }
+  auto array = jsg::JsArray(v8::Array::New(js.v8Isolate, values.data(), values.size()));
+  messagesArray = array.addRef(js);
+  return array;
+}
+
 void QueueEvent::retryAll(jsg::Optional<QueueRetryOptions> options) {
   if (result->ackAll) {
     IoContext::current().logWarning(
@@ -552,8 +566,9 @@ kj::Promise<WorkerInterface::CustomEvent::Result> QueueCustomEventImpl::run(
   }
 
   KJ_IF_SOME(t, incomingRequest->getWorkerTracer()) {
-    t.setEventInfo(context.getInvocationSpanContext(), context.now(),
-        tracing::QueueEventInfo(kj::str(queueName), batchSize));
+    t.setEventInfo(context.getInvocationSpanContext(), context.now(), [&]() -> tracing::EventInfo {
+      return tracing::QueueEventInfo(kj::str(queueName), batchSize);
+    });
   }
 
   // Create a custom refcounted type for holding the queueEvent so that we can pass it to the
@@ -187,19 +187,35 @@ class QueueMessage final: public jsg::Object {
 
   void visitForMemoryInfo(jsg::MemoryTracker& tracker) const {
     tracker.trackField("id", id);
-    tracker.trackField("body", body);
+    KJ_SWITCH_ONEOF(body) {
+      KJ_CASE_ONEOF(serialized, SerializedBody) {
+        tracker.trackField("body", serialized.data);
+      }
+      KJ_CASE_ONEOF(value, jsg::JsRef<jsg::JsValue>) {
+        tracker.trackField("body", value);
+      }
+    }
     tracker.trackFieldWithSize("IoPtr<QueueEventResult>", sizeof(IoPtr<QueueEventResult>));
   }
 
  private:
+  // The body as received. Consumers often ack or retry based on the message metadata alone, so
+  // the body is only deserialized when it is first accessed.
+  struct SerializedBody {
+    kj::Array<kj::byte> data;
+    kj::Maybe<kj::String> contentType;
+  };
+
   kj::String id;
   kj::Date timestamp;
-  jsg::JsRef<jsg::JsValue> body;
+  kj::OneOf<SerializedBody, jsg::JsRef<jsg::JsValue>> body;
   uint16_t attempts;
   IoPtr<QueueEventResult> result;
 
   void visitForGc(jsg::GcVisitor& visitor) {
-    visitor.visit(body);
+    KJ_IF_SOME(value, body.tryGet<jsg::JsRef<jsg::JsValue>>()) {
+      visitor.visit(value);
+    }
   }
 };
 
@@ -219,7 +235,11 @@ class QueueEvent final: public ExtendableEvent {
 
   static jsg::Ref<QueueEvent> constructor(kj::String type) = delete;
 
-  kj::ArrayPtr<jsg::Ref<QueueMessage>> getMessages() {
+  // Returns the same array every time, built on first access.
+  jsg::JsArray getMessages(
+      jsg::Lock& js, const jsg::TypeHandler<jsg::Ref<QueueMessage>>& messageHandler);
+  // The messages, for C++ callers that don't need them as a JS array.
+  kj::ArrayPtr<jsg::Ref<QueueMessage>> getMessageRefs() {
     return messages;
   }
   kj::StringPtr getQueueName() {
@@ -248,6 +268,7 @@ class QueueEvent final: public ExtendableEvent {
     for (auto& message: messages) {
       tracker.trackField("message", message);
     }
+    tracker.trackField("messagesArray", messagesArray);
     tracker.trackField("queueName", queueName);
     tracker.trackFieldWithSize("IoPtr<QueueEventResult>", sizeof(IoPtr<QueueEventResult>));
   }
@@ -268,15 +289,17 @@ class QueueEvent final: public ExtendableEvent {
   }
 
  private:
-  // TODO(perf): Should we store these in a v8 array directly rather than this intermediate kj
-  // array to avoid one intermediate copy?
   kj::Array<jsg::Ref<QueueMessage>> messages;
+
+  // `messages` as a JS array, shared by `event.messages` and `batch.messages`.
+  kj::Maybe<jsg::JsRef<jsg::JsArray>> messagesArray;
   kj::String queueName;
   IoPtr<QueueEventResult> result;
   CompletionStatus completionStatus = Incomplete{};
 
   void visitForGc(jsg::GcVisitor& visitor) {
     visitor.visitAll(messages);
+    visitor.visit(messagesArray);
   }
 };
 
@@ -285,8 +308,9 @@ class QueueController final: public jsg::Object {
  public:
   QueueController(jsg::Ref<QueueEvent> event): event(kj::mv(event)) {}
 
-  kj::ArrayPtr<jsg::Ref<QueueMessage>> getMessages() {
-    return event->getMessages();
+  jsg::JsArray getMessages(
+      jsg::Lock& js, const jsg::TypeHandler<jsg::Ref<QueueMessage>>& messageHandler) {
+    return event->getMessages(js, messageHandler);
   }
   kj::StringPtr getQueueName() {
     return event->getQueueName();
@@ -230,6 +230,62 @@ async function test(state) {
     sql.exec(`DROP TABLE streaming;`);
   }
 
+  // Test batch execution of a single statement with many sets of bindings
+  {
+    sql.exec(`CREATE TABLE batched(id INTEGER PRIMARY KEY, val TEXT, data BLOB);`);
+
+    const rows = [];
+    for (let i = 0; i < 10000; i++) {
+      rows.push([
+        i,
+        `value ${i}`,
+        i % 2 ? null : new Uint8Array([i % 256]).buffer,
+      ]);
+    }
+    const result = sql.execBatch(`INSERT INTO batched VALUES (?, ?, ?)`, rows);
+    assert.equal(result.rowsWritten, 10000);
+    assert.equal(result.statementCount, 10000);
+
+    assert.deepEqual(Array.from(sql.exec(`SELECT count(*) FROM batched`)), [
+      { 'count(*)': 10000 },
+    ]);
+    assert.deepEqual(
+      Array.from(sql.exec(`SELECT id, val FROM batched WHERE id = 1234`)),
+      [{ id: 1234, val: 'value 1234' }]
+    );
+
+    // Rows returned by the statement are consumed and discarded.
+    const selected = sql.execBatch(`SELECT * FROM batched WHERE id < ?`, [
+      [10],
+      [20],
+    ]);
+    assert.equal(selected.statementCount, 2);
+    assert.equal(selected.rowsWritten, 0);
+
+    // While a cursor over the same statement is still open, the batch runs on its own copy.
+    const cursor = sql.exec(`SELECT * FROM batched WHERE id < ?`, 3);
+    assert.equal(cursor.next().value.id, 0);
+    sql.execBatch(`SELECT * FROM batched WHERE id < ?`, [[5]]);
+    assert.deepEqual([...cursor].map((row) => row.id), [1, 2]);
+
+    // The batch stops at the first failing run, leaving earlier runs applied.
+    assert.throws(
+      () =>
+        sql.execBatch(`INSERT INTO batched(id, val) VALUES (?, ?)`, [
+          [20000, 'new'],
+          [1, 'duplicate'],
+          [20001, 'never inserted'],
+        ]),
+      /UNIQUE constraint failed/
+    );
+    assert.deepEqual(
+      Array.from(sql.exec(`SELECT id FROM batched WHERE id >= 20000`)),
+      [{ id: 20000 }]
+    );
+
+    sql.exec(`DROP TABLE batched;`);
+  }
+
   // Test count
   {
     const result = [
@@ -31,6 +31,54 @@ jsg::Ref<SqlStorage::Cursor> SqlStorage::exec(
   querySql = querySql.internalize(js);
 
   auto& db = getDb(js);
+
+  KJ_IF_SOME(cached, getCachedStatement(js, db, querySql)) {
+    auto result = js.alloc<Cursor>(js, kj::mv(cached), kj::mv(bindings));
+    trimStatementCache(js);
+    return result;
+  } else {
+    SqliteDatabase::Regulator& regulator = *this;
+    return js.alloc<Cursor>(js, db, regulator, js.toString(querySql), kj::mv(bindings));
+  }
+}
+
+SqlStorage::ExecBatchResult SqlStorage::execBatch(
+    jsg::Lock& js, jsg::JsString querySql, kj::Array<kj::Array<BindingValue>> bindingsList) {
+  querySql = querySql.internalize(js);
+
+  auto& db = getDb(js);
+
+  auto cached = getCachedStatement(js, db, querySql);
+  kj::Maybe<SqliteDatabase::Statement> oneOff;
+  SqliteDatabase::Statement* statement;
+  KJ_IF_SOME(c, cached) {
+    statement = &c->statement;
+  } else {
+    statement = &oneOff.emplace(db.prepareMulti(*this, js.toString(querySql)));
+  }
+
+  uint64_t rowsRead = 0;
+  uint64_t rowsWritten = 0;
+  for (auto& bindings: bindingsList) {
+    auto query = statement->run(Cursor::mapBindings(bindings).asPtr());
+    while (!query.isDone()) {
+      query.nextRow();
+    }
+    rowsRead += query.getRowsRead();
+    rowsWritten += query.getRowsWritten();
+  }
+
+  trimStatementCache(js);
+
+  return {
+    .rowsRead = static_cast<double>(rowsRead),
+    .rowsWritten = static_cast<double>(rowsWritten),
+    .statementCount = static_cast<double>(bindingsList.size()),
+  };
+}
+
+kj::Maybe<kj::Rc<SqlStorage::CachedStatement>> SqlStorage::getCachedStatement(
+    jsg::Lock& js, SqliteDatabase& db, jsg::JsString querySql) {
   auto& statementCache = *this->statementCache;
 
   kj::Rc<CachedStatement>& slot = statementCache.map.findOrCreate(querySql, [&]() {
@@ -53,11 +101,14 @@ jsg::Ref<SqlStorage::Cursor> SqlStorage::exec(
     //
     // In theory we could try to cache multiple copies of the statement, but as this is probably
     // exceedingly rare, it is not worth the added code complexity.
-    SqliteDatabase::Regulator& regulator = *this;
-    return js.alloc<Cursor>(js, db, regulator, js.toString(querySql), kj::mv(bindings));
+    return kj::none;
   }
 
-  auto result = js.alloc<Cursor>(js, slot.addRef(), kj::mv(bindings));
+  return slot.addRef();
+}
+
+void SqlStorage::trimStatementCache(jsg::Lock& js) {
+  auto& statementCache = *this->statementCache;
 
   // If the statement cache grew too big, drop the least-recently-used entry.
   while (statementCache.totalSize > SQL_STATEMENT_CACHE_MAX_SIZE) {
@@ -67,8 +118,6 @@ jsg::Ref<SqlStorage::Cursor> SqlStorage::exec(
     statementCache.lru.remove(toRemove);
     KJ_ASSERT(statementCache.map.eraseMatch(oldQuery));
   }
-
-  return result;
 }
 
 SqlStorage::IngestResult SqlStorage::ingest(jsg::Lock& js, kj::String querySql) {
@@ -22,6 +22,7 @@ class SqlStorage final: public jsg::Object, private SqliteDatabase::Regulator {
   class Cursor;
   class Statement;
   struct IngestResult;
+  struct ExecBatchResult;
 
   // One value returned from SQL. Note that we intentionally return StringPtr instead of String
   // because we know that the underlying buffer returned by SQLite will be valid long enough to be
@@ -30,6 +31,13 @@ class SqlStorage final: public jsg::Object, private SqliteDatabase::Regulator {
   using SqlValue = kj::Maybe<kj::OneOf<kj::Array<byte>, kj::StringPtr, double>>;
 
   jsg::Ref<Cursor> exec(jsg::Lock& js, jsg::JsString query, jsg::Arguments<BindingValue> bindings);
+
+  // Runs `query` once for each set of bindings in `bindingsList`, without creating a Cursor for
+  // each run. Any rows returned by the query are discarded. Runs stop at the first error, which is
+  // thrown; like a loop over `exec()`, earlier runs are not undone unless the caller is inside a
+  // transaction.
+  ExecBatchResult execBatch(
+      jsg::Lock& js, jsg::JsString query, kj::Array<kj::Array<BindingValue>> bindingsList);
   IngestResult ingest(jsg::Lock& js, kj::String query);
   void setMaxPageCountForTest(jsg::Lock& js, int count);
 
@@ -48,6 +56,8 @@ class SqlStorage final: public jsg::Object, private SqliteDatabase::Regulator {
       // 'ingest' functionality is still experimental-only
       JSG_METHOD(ingest);
 
+      JSG_METHOD(execBatch);
+
       JSG_METHOD(setMaxPageCountForTest);
     }
 
@@ -138,6 +148,15 @@ class SqlStorage final: public jsg::Object, private SqliteDatabase::Regulator {
   };
   IoOwn<StatementCache> statementCache;
 
+  // Finds `query` in the statement cache, adding it if needed, and marks it most-recently-used.
+  // Returns none if the cached statement is currently in use by a Cursor, in which case the
+  // caller must compile a one-off copy instead. `query` must already be internalized.
+  kj::Maybe<kj::Rc<CachedStatement>> getCachedStatement(
+      jsg::Lock& js, SqliteDatabase& db, jsg::JsString query);
+
+  // Drops least-recently-used statements until the cache is back under its size limit.
+  void trimStatementCache(jsg::Lock& js);
+
   template <size_t size, typename... Params>
   SqliteDatabase::Query execMemoized(SqliteDatabase& db,
       kj::Maybe<IoOwn<SqliteDatabase::Statement>>& slot,
@@ -296,6 +315,7 @@ class SqlStorage::Cursor final: public jsg::Object {
   static kj::Maybe<v8::LocalVector<v8::Value>> iteratorImpl(jsg::Lock& js, jsg::Ref<Cursor>& obj);
 
   friend class Statement;
+  friend class SqlStorage;
 
   void visitForGc(jsg::GcVisitor& visitor) {
     visitor.visit(columnNames);
@@ -347,9 +367,18 @@ struct SqlStorage::IngestResult {
   JSG_STRUCT(remainder, rowsRead, rowsWritten, statementCount);
 };
 
+struct SqlStorage::ExecBatchResult {
+  double rowsRead;
+  double rowsWritten;
+  double statementCount;
+
+  JSG_STRUCT(rowsRead, rowsWritten, statementCount);
+};
+
 #define EW_SQL_ISOLATE_TYPES                                                                       \
   api::SqlStorage, api::SqlStorage::Statement, api::SqlStorage::Cursor,                            \
-      api::SqlStorage::IngestResult, api::SqlStorage::Cursor::RowIterator,                         \
+      api::SqlStorage::IngestResult, api::SqlStorage::ExecBatchResult,                             \
+      api::SqlStorage::Cursor::RowIterator,                                                        \
       api::SqlStorage::Cursor::RowIterator::Next, api::SqlStorage::Cursor::RawIterator,            \
       api::SqlStorage::Cursor::RawIterator::Next
 // The list of sql.h types that are added to worker.c++'s JSG_DECLARE_ISOLATE_TYPE
@@ -27,3 +27,44 @@ export const customthenable = {
     strictEqual(result2, 123);
   },
 };
+
+export const nestedStores = {
+  // Frames share their parents' storage, and long chains of frames are periodically flattened.
+  // Either way, every store must see the value from its innermost run().
+  async test() {
+    const stores = [];
+    for (let i = 0; i < 5; i++) {
+      stores.push(new AsyncLocalStorage());
+    }
+
+    const check = (depth) => {
+      for (let i = 0; i < stores.length; i++) {
+        // Store `i` was last set at the deepest level congruent to `i`.
+        const expected = depth < i ? undefined : depth - ((depth - i) % 5);
+        strictEqual(stores[i].getStore(), expected);
+      }
+    };
+
+    const nest = async (depth) => {
+      if (depth === 40) return;
+      await stores[depth % 5].run(depth, async () => {
+        check(depth);
+        await Promise.resolve();
+        check(depth);
+        await nest(depth + 1);
+        check(depth);
+      });
+    };
+    await nest(0);
+
+    // Overwriting the same store many times over still yields the innermost value.
+    const als = stores[0];
+    const deep = (n) => (n === 0 ? als.getStore() : als.run(n, () => deep(n - 1)));
+    strictEqual(deep(50), 1);
+    strictEqual(stores[1].run('outer', () => deep(50)), 1);
+    strictEqual(
+      stores[1].run('outer', () => als.run(7, () => stores[1].getStore())),
+      'outer'
+    );
+  },
+};
@@ -94,3 +94,103 @@ export const ecdhJwkTest = {
     );
   },
 };
+
+export const repeatedImportTest = {
+  async test() {
+    // Parsed keys are reused when the same key data is imported again. Each import must still get
+    // its own usages and extractability, and must still be validated against its own algorithm.
+    const { publicKey, privateKey } = await crypto.subtle.generateKey(
+      { name: 'ECDSA', namedCurve: 'P-256' },
+      true,
+      ['sign', 'verify']
+    );
+    const spki = await crypto.subtle.exportKey('spki', publicKey);
+    const pkcs8 = await crypto.subtle.exportKey('pkcs8', privateKey);
+    const jwk = await crypto.subtle.exportKey('jwk', publicKey);
+    const algorithm = { name: 'ECDSA', namedCurve: 'P-256' };
+    const signAlgorithm = { name: 'ECDSA', hash: 'SHA-256' };
+    const data = new TextEncoder().encode('hello');
+
+    const signer = await crypto.subtle.importKey(
+      'pkcs8',
+      pkcs8,
+      algorithm,
+      false,
+      ['sign']
+    );
+    const extractableSigner = await crypto.subtle.importKey(
+      'pkcs8',
+      pkcs8,
+      algorithm,
+      true,
+      ['sign']
+    );
+    assert.strictEqual(signer.extractable, false);
+    assert.strictEqual(extractableSigner.extractable, true);
+    await assert.rejects(crypto.subtle.exportKey('pkcs8', signer), {
+      name: 'InvalidAccessError',
+    });
+    await crypto.subtle.exportKey('pkcs8', extractableSigner);
+    const signature = await crypto.subtle.sign(signAlgorithm, signer, data);
+
+    const noUsages = await crypto.subtle.importKey(
+      'spki',
+      spki,
+      algorithm,
+      true,
+      []
+    );
+    const verifier = await crypto.subtle.importKey(
+      'spki',
+      spki,
+      algorithm,
+      true,
+      ['verify']
+    );
+    assert.deepStrictEqual(noUsages.usages, []);
+    assert.deepStrictEqual(verifier.usages, ['verify']);
+    await assert.rejects(
+      crypto.subtle.verify(signAlgorithm, noUsages, signature, data),
+      { name: 'InvalidAccessError' }
+    );
+    assert.ok(
+      await crypto.subtle.verify(signAlgorithm, verifier, signature, data)
+    );
+
+    // The same key data with different algorithm parameters is checked again.
+    await assert.rejects(
+      crypto.subtle.importKey(
+        'spki',
+        spki,
+        { name: 'ECDSA', namedCurve: 'P-384' },
+        true,
+        ['verify']
+      ),
+      { name: 'DataError' }
+    );
+
+    // A JWK's usage and extractability members are checked on every import.
+    const jwkVerifier = await crypto.subtle.importKey(
+      'jwk',
+      jwk,
+      algorithm,
+      true,
+      ['verify']
+    );
+    assert.ok(
+      await crypto.subtle.verify(signAlgorithm, jwkVerifier, signature, data)
+    );
+    await assert.rejects(
+      crypto.subtle.importKey('jwk', { ...jwk, ext: false }, algorithm, true, [
+        'verify',
+      ]),
+      { name: 'DataError' }
+    );
+    await assert.rejects(
+      crypto.subtle.importKey('jwk', { ...jwk, use: 'enc' }, algorithm, true, [
+        'verify',
+      ]),
+      { name: 'DataError' }
+    );
+  },
+};
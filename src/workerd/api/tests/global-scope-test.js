@@ -692,6 +692,34 @@ export const webSocketPairIterable = {
   },
 };
 
+export const webSocketPairManyMessages = {
+  async test() {
+    // Messages sent in a burst may be delivered under a single lock, but each is still its own
+    // event: they arrive in order, and microtasks queued by one run before the next arrives.
+    const [a, b] = new WebSocketPair();
+    a.accept();
+    b.accept();
+
+    const log = [];
+    const { promise, resolve } = Promise.withResolvers();
+    b.addEventListener('message', (event) => {
+      log.push(event.data);
+      queueMicrotask(() => log.push(`after ${event.data}`));
+      if (event.data === '99') resolve();
+    });
+    for (let i = 0; i < 100; i++) {
+      a.send(`${i}`);
+    }
+    await promise;
+
+    const expected = [];
+    for (let i = 0; i < 100; i++) {
+      expected.push(`${i}`, `after ${i}`);
+    }
+    deepStrictEqual(log, expected);
+  },
+};
+
 export const queueMicrotaskError = {
   async test() {
     const als = new AsyncLocalStorage();
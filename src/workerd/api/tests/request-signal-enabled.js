@@ -116,6 +116,38 @@ export class Server extends WorkerEntrypoint {
   }
 }
 
+// Unlike Server, doesn't add an abort listener to every request's signal. Records what each
+// request's signal looks like some time after the client has disconnected.
+let signalStates = {};
+let followingSignalAborted = false;
+export class QuietServer extends WorkerEntrypoint {
+  async fetch(req) {
+    const key = new URL(req.url).pathname.slice(1);
+    this.ctx.waitUntil(this.recordSignalState(key, req));
+
+    if (key == 'polled') {
+      // Looks at the signal, but doesn't listen for aborts.
+      assert.ok(!req.signal.aborted);
+    } else if (key == 'followed') {
+      AbortSignal.any([req.signal]).onabort = () => {
+        followingSignalAborted = true;
+      };
+    }
+
+    for (;;) {
+      await scheduler.wait(86400);
+    }
+  }
+
+  async recordSignalState(key, req) {
+    await scheduler.wait(300);
+    signalStates[key] = {
+      aborted: req.signal.aborted,
+      reason: req.signal.reason?.message,
+    };
+  }
+}
+
 export const noAbortOnSimpleResponse = {
   async test(ctrl, env, ctx) {
     let abortTracker = env.AbortTracker.get(
@@ -238,3 +270,30 @@ export const requestPassedOverRpcDoesNotIncludeSignal = {
     assert.strictEqual(rpcSignalReason, undefined);
   },
 };
+
+export const abortIfClientDisconnectsWithoutListeners = {
+  async test(ctrl, env, ctx) {
+    // Whether the signal was first used after the client disconnected, was used without listening
+    // for aborts, or was followed by another signal, it ends up aborted the same way.
+    const keys = ['untouched', 'polled', 'followed'];
+    for (const key of keys) {
+      await assert.rejects(
+        () =>
+          env.QuietServer.fetch(`http://example.com/${key}`, {
+            signal: AbortSignal.timeout(100),
+          }),
+        { name: 'TimeoutError' }
+      );
+    }
+
+    await scheduler.wait(500);
+
+    for (const key of keys) {
+      assert.deepStrictEqual(signalStates[key], {
+        aborted: true,
+        reason: 'The client has disconnected',
+      });
+    }
+    assert.ok(followingSignalAborted);
+  },
+};
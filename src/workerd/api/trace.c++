@@ -660,8 +660,8 @@ kj::Promise<void> sendTracesToExportedHandler(kj::Own<IoContext::IncomingRequest
   auto& metrics = incomingRequest->getMetrics();
 
   KJ_IF_SOME(t, incomingRequest->getWorkerTracer()) {
-    t.setEventInfo(
-        context.getInvocationSpanContext(), context.now(), tracing::TraceEventInfo(traces));
+    t.setEventInfo(context.getInvocationSpanContext(), context.now(),
+        [&]() -> tracing::EventInfo { return tracing::TraceEventInfo(traces); });
   }
 
   auto nonEmptyTraces = kj::Vector<kj::Own<Trace>>(kj::size(traces));
@@ -15,6 +15,7 @@
 #include <workerd/util/sentry.h>
 
 #include <kj/compat/url.h>
+#include <kj/vector.h>
 
 namespace workerd::api {
 
@@ -480,6 +481,16 @@ void WebSocket::startReadLoop(jsg::Lock& js, kj::Maybe<kj::Own<InputGate::Critic
     maxMessageSize = 128u << 20;
   }
 
+  auto& context = IoContext::current();
+
+  // An actor's input gate may be locked by the handler for one message, which must hold back the
+  // next message, so actors get one message per lock.
+  size_t maxBatchMessages = RECEIVE_BATCH_MAX_MESSAGES;
+  if (context.getActor() != kj::none ||
+      FeatureFlags::get(js).getWebSocketReceivePerMessage()) {
+    maxBatchMessages = 1;
+  }
+
   // If the kj::WebSocket happens to be an AbortableWebSocket (see util/abortable.h), then
   // calling readLoop here could throw synchronously if the canceler has already been tripped.
   // Using kj::evalNow() here let's us capture that and handle correctly.
@@ -487,9 +498,8 @@ void WebSocket::startReadLoop(jsg::Lock& js, kj::Maybe<kj::Own<InputGate::Critic
   // We catch exceptions and return Maybe<Exception> instead since we want to handle the exceptions
   // in awaitIo() below, but we don't want the KJ exception converted to JavaScript before we can
   // examine it.
-  kj::Promise<kj::Maybe<kj::Exception>> promise = readLoop(kj::mv(cs), maxMessageSize);
-
-  auto& context = IoContext::current();
+  kj::Promise<kj::Maybe<kj::Exception>> promise =
+      readLoop(kj::mv(cs), maxMessageSize, maxBatchMessages, RECEIVE_BATCH_MAX_BYTES);
 
   auto hasLocalPeer = [&]() {
     KJ_IF_SOME(p, peer) {
@@ -969,52 +979,102 @@ kj::Array<kj::StringPtr> WebSocket::getHibernatableTags() {
 }
 
 kj::Promise<kj::Maybe<kj::Exception>> WebSocket::readLoop(
-    kj::Maybe<kj::Own<InputGate::CriticalSection>> cs, size_t maxMessageSize) {
+    kj::Maybe<kj::Own<InputGate::CriticalSection>> cs,
+    size_t maxMessageSize,
+    size_t maxBatchMessages,
+    size_t maxBatchBytes) {
   try {
     // Note that we'll throw if the websocket has enabled hibernation.
     auto& ws = *KJ_REQUIRE_NONNULL(
         KJ_ASSERT_NONNULL(farNative->state.tryGet<Accepted>()).ws.getIfNotHibernatable());
     auto& context = IoContext::current();
+
+    // The next message is always being received into `received`, including while the previous
+    // batch is being delivered. A receive can't be canceled without losing its message, so we
+    // only ever wait on branches of `receiving`.
+    kj::Maybe<kj::WebSocket::Message> received;
+    auto receiveNext = [&]() {
+      return ws.receive(maxMessageSize)
+          .then([&received](kj::WebSocket::Message message) { received = kj::mv(message); })
+          .fork();
+    };
+    auto receiving = receiveNext();
+
     while (true) {
-      auto message = co_await ws.receive(maxMessageSize);
+      co_await receiving.addBranch();
+
+      // Collect every message that is already buffered, so that they can all be delivered under
+      // one lock. A message counts as buffered if it arrives before the event loop runs out of
+      // other work to do.
+      kj::Vector<kj::WebSocket::Message> batch;
+      size_t batchBytes = 0;
+      while (true) {
+        auto message = kj::mv(KJ_ASSERT_NONNULL(received));
+        received = kj::none;
+
+        auto size = countBytesFromMessage(message);
+        KJ_IF_SOME(o, observer) {
+          o->receivedMessage(size);
+        }
 
-      auto size = countBytesFromMessage(message);
-      KJ_IF_SOME(o, observer) {
-        o->receivedMessage(size);
-      }
+        context.getLimitEnforcer().topUpActor();
+        KJ_IF_SOME(a, context.getActor()) {
+          a.getMetrics().receivedWebSocketMessage(size);
+        }
 
-      context.getLimitEnforcer().topUpActor();
-      KJ_IF_SOME(a, context.getActor()) {
-        a.getMetrics().receivedWebSocketMessage(size);
+        // Nothing follows a Close, so don't try to receive past it.
+        bool isClose = message.is<kj::WebSocket::Close>();
+        batch.add(kj::mv(message));
+        batchBytes += size;
+        if (isClose) break;
+
+        receiving = receiveNext();
+        if (batch.size() >= maxBatchMessages || batchBytes >= maxBatchBytes) break;
+
+        // A failed receive ends the batch too; the error is rethrown at the top of the loop, after
+        // the messages before it have been delivered.
+        bool arrived = co_await receiving.addBranch()
+                           .then([]() { return true; }, [](kj::Exception&&) { return true; })
+                           .exclusiveJoin(kj::yieldUntilQueueEmpty().then([]() { return false; }));
+        if (!arrived || received == kj::none) break;
       }
 
       // Re-enter the context with context.run(). This is arguably a bit unusual compared to other
       // I/O which is delivered by return from context.awaitIo(), but the difference here is that we
-      // have a long stream of events over time. It makes sense to use context.run() each time a new
-      // event arrives.
+      // have a long stream of events over time. It makes sense to use context.run() each time new
+      // events arrive.
       // TODO(cleanup): The way context.run is defined, a capturing lambda is required here, which
       // is a bit unfortunate. We could simply things somewhat with a variation that would allow
       // something like context.run(handleMessage, *this, kj::mv(message)) where the acquired lock,
       // and the additional arguments are passed into handleMessage, avoiding the need for the
       // lambda here entirely.
-      auto result = co_await context.run([this, message = kj::mv(message)](auto& wLock) mutable {
+      auto result = co_await context.run(
+          [this, batch = batch.releaseAsArray()](auto& wLock) mutable {
         auto& native = *farNative;
         jsg::Lock& js = wLock;
-        KJ_SWITCH_ONEOF(message) {
-          KJ_CASE_ONEOF(text, kj::String) {
-            dispatchEventImpl(js, js.alloc<MessageEvent>(js, js.str(text)));
-          }
-          KJ_CASE_ONEOF(data, kj::Array<byte>) {
-            dispatchEventImpl(js,
-                js.alloc<MessageEvent>(
-                    js, jsg::JsValue(js.arrayBuffer(kj::mv(data)).getHandle(js))));
+        for (auto i: kj::indices(batch)) {
+          if (i > 0) {
+            // Each message is its own event, so the previous event's microtasks run first, just as
+            // if the messages had been delivered under separate locks.
+            js.runMicrotasks();
           }
-          KJ_CASE_ONEOF(close, kj::WebSocket::Close) {
-            native.closedIncoming = true;
-            dispatchEventImpl(js, js.alloc<CloseEvent>(close.code, kj::mv(close.reason), true));
-            // Native WebSocket no longer needed; release.
-            tryReleaseNative(js);
-            return false;
+
+          KJ_SWITCH_ONEOF(batch[i]) {
+            KJ_CASE_ONEOF(text, kj::String) {
+              dispatchEventImpl(js, js.alloc<MessageEvent>(js, js.str(text)));
+            }
+            KJ_CASE_ONEOF(data, kj::Array<byte>) {
+              dispatchEventImpl(js,
+                  js.alloc<MessageEvent>(
+                      js, jsg::JsValue(js.arrayBuffer(kj::mv(data)).getHandle(js))));
+            }
+            KJ_CASE_ONEOF(close, kj::WebSocket::Close) {
+              native.closedIncoming = true;
+              dispatchEventImpl(js, js.alloc<CloseEvent>(close.code, kj::mv(close.reason), true));
+              // Native WebSocket no longer needed; release.
+              tryReleaseNative(js);
+              return false;
+            }
           }
         }
 
@@ -484,6 +484,10 @@ class WebSocket: public EventTarget {
   // Maximum size of a WebSocket attachment.
   inline static const size_t MAX_ATTACHMENT_SIZE = 1024 * 2;
 
+  // Limits on how many already-buffered incoming messages are delivered under one lock.
+  inline static const size_t RECEIVE_BATCH_MAX_MESSAGES = 128;
+  inline static const size_t RECEIVE_BATCH_MAX_BYTES = 1u << 20;
+
   struct AwaitingConnection {
     // A canceler associated with the pending websocket connection for `new Websocket()`.
     kj::Canceler canceler;
@@ -687,8 +691,12 @@ class WebSocket: public EventTarget {
       AutoResponse& autoResponse,
       kj::Maybe<kj::Own<WebSocketObserver>>& observer);
 
-  kj::Promise<kj::Maybe<kj::Exception>> readLoop(
-      kj::Maybe<kj::Own<InputGate::CriticalSection>> cs, size_t maxMessageSize);
+  // Incoming messages that are already buffered are delivered together, as separate events under
+  // a single isolate lock, up to `maxBatchMessages` messages or until `maxBatchBytes` is reached.
+  kj::Promise<kj::Maybe<kj::Exception>> readLoop(kj::Maybe<kj::Own<InputGate::CriticalSection>> cs,
+      size_t maxMessageSize,
+      size_t maxBatchMessages,
+      size_t maxBatchBytes);
 
   void reportError(jsg::Lock& js, kj::Exception&& e);
   void reportError(jsg::Lock& js, jsg::JsRef<jsg::JsValue> err);
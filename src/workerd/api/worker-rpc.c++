@@ -9,6 +9,7 @@
 #include <workerd/io/tracer.h>
 #include <workerd/jsg/ser.h>
 #include <workerd/util/completion-membrane.h>
+#include <workerd/util/use-perfetto-categories.h>
 
 #include <capnp/membrane.h>
 
@@ -440,6 +441,9 @@ JsRpcPromiseAndPipeline callImpl(jsg::Lock& js,
       auto client = parent.getClientForOneCall(js, path);
 
       auto& ioContext = IoContext::current();
+      TRACE_EVENT("workerd.rpc", "JsRpc call", "method",
+          name.map([](const kj::String& n) { return n.cStr(); }).orDefault("<call>"),
+          PERFETTO_FLOW_FROM_POINTER(ioContext.getPerfettoFlowId()));
 
       KJ_IF_SOME(lock, ioContext.waitForOutputLocksIfNecessary()) {
         // Replace the client with a promise client that will delay the call until the output gate
@@ -993,6 +997,8 @@ class JsRpcTargetBase: public rpc::JsRpcTarget::Server {
         tryGetProperty(lock, targetInfo.target, params, targetInfo.allowInstanceProperties);
 
     addTrace(js, ctx, methodNameForTrace);
+    TRACE_EVENT("workerd.rpc", "JsRpcTarget call", "method", methodNameForTrace.cStr(),
+        PERFETTO_FLOW_FROM_POINTER(ctx.getPerfettoFlowId()));
 
     auto op = params.getOperation();
 
@@ -1812,7 +1818,7 @@ class EntrypointJsRpcTarget final: public JsRpcTargetBase {
   void addTrace(jsg::Lock& js, IoContext& ioctx, kj::StringPtr methodName) override {
     KJ_IF_SOME(t, tracer) {
       t->setEventInfo(ioctx.getInvocationSpanContext(), ioctx.now(),
-          tracing::JsRpcEventInfo(kj::str(methodName)));
+          [&]() -> tracing::EventInfo { return tracing::JsRpcEventInfo(kj::str(methodName)); });
     }
   }
 };
@@ -9,6 +9,7 @@
 #include <workerd/jsg/exception.h>
 #include <workerd/util/duration-exceeded-logger.h>
 #include <workerd/util/sentry.h>
+#include <workerd/util/use-perfetto-categories.h>
 
 #include <kj/debug.h>
 
@@ -2190,6 +2191,8 @@ void ActorCache::ensureFlushScheduled(const WriteOptions& options) {
 
   if (!flushScheduled) {
     flushScheduled = true;
+    TRACE_EVENT_INSTANT(
+        "workerd.storage", "ActorCache::ensureFlushScheduled()", PERFETTO_FLOW_FROM_POINTER(this));
     auto flushPromise = lastFlush.addBranch()
                             .attach(kj::defer([this]() {
       flushScheduled = false;
@@ -2531,6 +2534,9 @@ kj::Promise<void> ActorCache::startFlushTransaction() {
 }
 
 kj::Promise<void> ActorCache::flushImpl(uint retryCount) {
+  TRACE_EVENT("workerd.storage", "ActorCache::flushImpl()", "retryCount", retryCount,
+      PERFETTO_TERMINATING_FLOW_FROM_POINTER(this));
+
   KJ_IF_SOME(e, maybeTerminalException) {
     // If we have a terminal exception, throw here to break the output gate and prevent any calls
     // to storage. This does not use `requireNotTerminal()` so that we don't recursively schedule
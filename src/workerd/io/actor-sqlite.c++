@@ -9,6 +9,7 @@
 
 #include <workerd/jsg/exception.h>
 #include <workerd/util/sentry.h>
+#include <workerd/util/use-perfetto-categories.h>
 
 #include <sqlite3.h>
 
@@ -170,6 +171,8 @@ kj::Maybe<kj::Promise<void>> ActorSqlite::ExplicitTxn::commit() {
 
     // We committed the root transaction, so it's time to signal any replication layer and lock
     // the output gate in the meantime.
+    TRACE_EVENT_INSTANT("workerd.storage", "ActorSqlite: transaction committed",
+        PERFETTO_FLOW_FROM_POINTER(&actorSqlite));
     actorSqlite.commitTasks.add(actorSqlite.outputGate.lockWhile(
         actorSqlite.commitImpl(kj::mv(KJ_ASSERT_NONNULL(precommitAlarmState)))));
   }
@@ -217,6 +220,8 @@ void ActorSqlite::onWrite() {
   requireNotBroken();
   if (currentTxn.is<NoTxn>()) {
     auto txn = kj::heap<ImplicitTxn>(*this);
+    TRACE_EVENT_INSTANT(
+        "workerd.storage", "ActorSqlite: implicit transaction", PERFETTO_FLOW_FROM_POINTER(this));
 
     commitTasks.add(outputGate.lockWhile(
         kj::evalLater([this, txn = kj::mv(txn)]() mutable -> kj::Promise<void> {
@@ -284,6 +289,9 @@ ActorSqlite::PrecommitAlarmState ActorSqlite::startPrecommitAlarmScheduling() {
 }
 
 kj::Promise<void> ActorSqlite::commitImpl(ActorSqlite::PrecommitAlarmState precommitAlarmState) {
+  TRACE_EVENT_INSTANT(
+      "workerd.storage", "ActorSqlite::commitImpl()", PERFETTO_TERMINATING_FLOW_FROM_POINTER(this));
+
   // We assume that exceptions thrown during commit will propagate to the caller, such that they
   // will ensure cancelDeferredAlarmDeletion() is called, if necessary.
 
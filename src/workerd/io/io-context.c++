@@ -11,6 +11,7 @@
 #include <workerd/jsg/setup.h>
 #include <workerd/util/sentry.h>
 #include <workerd/util/uncaught-exception-source.h>
+#include <workerd/util/use-perfetto-categories.h>
 
 #include <kj/debug.h>
 
@@ -213,6 +214,8 @@ IoContext::IncomingRequest::IoContext_IncomingRequest(kj::Own<IoContext> context
 // context->incomingRequests, which implies taking responsibility for draining on the way out.
 void IoContext::IncomingRequest::delivered(kj::SourceLocation location) {
   KJ_REQUIRE(!wasDelivered, "delivered() can only be called once");
+  TRACE_EVENT("workerd.io", "IoContext::IncomingRequest::delivered()",
+      PERFETTO_FLOW_FROM_POINTER(this));
   if (!context->incomingRequests.empty()) {
     // There is already an IncomingRequest running in this context, and we're going to make it no
     // longer current. Make sure to attribute accumulated CPU time to it.
@@ -854,6 +857,9 @@ kj::Own<WorkerInterface> IoContext::getSubrequestNoChecks(
     userSpan = makeUserTraceSpan(kj::ConstString(kj::mv(n)));
   }
 
+  TRACE_EVENT("workerd.subrequest", "IoContext::getSubrequest()", "inHouse", options.inHouse,
+      PERFETTO_FLOW_FROM_POINTER(getPerfettoFlowId()));
+
   TraceContext tracing(kj::mv(span), kj::mv(userSpan));
   auto ret = func(tracing, getIoChannelFactory());
 
@@ -1117,6 +1123,9 @@ void IoContext::runImpl(Runnable& runnable,
   getIoChannelFactory().getTimer().syncTime();
 
   runInContextScope(lockType, kj::mv(inputLock), [&](Worker::Lock& workerLock) {
+    TRACE_EVENT("workerd.io", "IoContext::runImpl()",
+        PERFETTO_FLOW_FROM_POINTER(getPerfettoFlowId()));
+
     if (!allowPermanentException) {
       workerLock.requireNoPermanentException();
     }
@@ -1411,6 +1420,25 @@ jsg::JsObject IoContext::getPromiseContextTag(jsg::Lock& js) {
   return KJ_REQUIRE_NONNULL(promiseContextTag).getHandle(js);
 }
 
+kj::Promise<Worker::AsyncLock> IoContext::traceAsyncLockWait(
+    kj::Promise<Worker::AsyncLock> promise) {
+#if defined(WORKERD_USE_PERFETTO)
+  if (TRACE_EVENT_CATEGORY_ENABLED("workerd.lock")) {
+    // The wait spans several turns of the event loop, so it's recorded on its own track rather
+    // than as a slice on the thread's track.
+    return [](kj::Promise<Worker::AsyncLock> promise,
+               const void* flowId) -> kj::Promise<Worker::AsyncLock> {
+      char track;
+      TRACE_EVENT_BEGIN("workerd.lock", "IoContext: waiting for isolate lock",
+          PERFETTO_TRACK_FROM_POINTER(&track), PERFETTO_FLOW_FROM_POINTER(flowId));
+      KJ_DEFER(TRACE_EVENT_END("workerd.lock", PERFETTO_TRACK_FROM_POINTER(&track)));
+      co_return co_await promise;
+    }(kj::mv(promise), getPerfettoFlowId());
+  }
+#endif
+  return kj::mv(promise);
+}
+
 kj::Promise<void> IoContext::startDeleteQueueSignalTask(IoContext* context) {
   // The promise that is returned is held by the IoContext itself, so when the
   // IoContext is destroyed, the promise will be canceled and the loop will
@@ -262,6 +262,14 @@ class IoContext final: public kj::Refcounted, private kj::TaskSet::ErrorHandler
     return getCurrentIncomingRequest().getWorkerTracer();
   }
 
+  // Identifies the current incoming request's flow in Perfetto traces. Pass to
+  // PERFETTO_FLOW_FROM_POINTER() so that lock waits, JavaScript execution, subrequests, RPC calls
+  // and storage operations made on behalf of the request are linked together.
+  const void* getPerfettoFlowId() {
+    if (incomingRequests.empty()) return this;
+    return &incomingRequests.front();
+  }
+
   LimitEnforcer& getLimitEnforcer() {
     return *limitEnforcer;
   }
@@ -1062,6 +1070,9 @@ class IoContext final: public kj::Refcounted, private kj::TaskSet::ErrorHandler
   kj::Promise<void> deleteQueueSignalTask;
   static kj::Promise<void> startDeleteQueueSignalTask(IoContext* context);
 
+  // Records the time spent waiting for the isolate lock in Perfetto traces, if enabled.
+  kj::Promise<Worker::AsyncLock> traceAsyncLockWait(kj::Promise<Worker::AsyncLock> promise);
+
   friend class Finalizeable;
   friend class DeleteQueue;
   template <typename T>
@@ -1123,6 +1134,7 @@ kj::PromiseForResult<Func, Worker::Lock&> IoContext::run(
   } else {
     asyncLockPromise = worker->takeAsyncLock(getMetrics());
   }
+  asyncLockPromise = traceAsyncLockWait(kj::mv(asyncLockPromise));
 
   return asyncLockPromise.then([this, inputLock = kj::mv(inputLock), func = kj::fwd<Func>(func)](
                                    Worker::AsyncLock lock) mutable {
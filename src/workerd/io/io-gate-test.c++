@@ -5,6 +5,7 @@
 #include "io-gate.h"
 
 #include <kj/test.h>
+#include <kj/vector.h>
 
 namespace workerd {
 namespace {
@@ -571,5 +572,130 @@ KJ_TEST("OutputGate canceled") {
   KJ_EXPECT_THROW_MESSAGE("output lock was canceled before completion", onBroken.wait(ws));
 }
 
+KJ_TEST("OutputGate waits only for locks taken before them") {
+  kj::EventLoop loop;
+  kj::WaitScope ws(loop);
+
+  OutputGate gate;
+
+  // Take a lock and then wait, ten times over, and release the locks newest first.
+  kj::Vector<kj::Own<kj::PromiseFulfiller<void>>> fulfillers;
+  kj::Vector<kj::Promise<void>> blockers;
+  kj::Vector<kj::Promise<void>> waits;
+  for (auto i KJ_UNUSED: kj::zeroTo(10)) {
+    auto paf = kj::newPromiseAndFulfiller<void>();
+    fulfillers.add(kj::mv(paf.fulfiller));
+    blockers.add(gate.lockWhile(kj::mv(paf.promise)));
+    waits.add(gate.wait());
+  }
+
+  for (auto i = fulfillers.size(); i-- > 1;) {
+    fulfillers[i]->fulfill();
+    blockers[i].wait(ws);
+    for (auto& wait: waits) {
+      KJ_EXPECT(!wait.poll(ws));
+    }
+  }
+
+  // Releasing the oldest lock releases everyone.
+  fulfillers[0]->fulfill();
+  blockers[0].wait(ws);
+  for (auto& wait: waits) {
+    KJ_EXPECT(wait.poll(ws));
+    wait.wait(ws);
+  }
+
+  // Release them oldest first instead: each wait becomes ready as soon as its own lock has been
+  // released, even though later locks are still held.
+  fulfillers.clear();
+  blockers.clear();
+  waits.clear();
+  for (auto i KJ_UNUSED: kj::zeroTo(10)) {
+    auto paf = kj::newPromiseAndFulfiller<void>();
+    fulfillers.add(kj::mv(paf.fulfiller));
+    blockers.add(gate.lockWhile(kj::mv(paf.promise)));
+    waits.add(gate.wait());
+  }
+
+  for (auto i: kj::indices(fulfillers)) {
+    fulfillers[i]->fulfill();
+    blockers[i].wait(ws);
+    for (auto j: kj::indices(waits)) {
+      KJ_EXPECT(waits[j].poll(ws) == (j <= i));
+    }
+  }
+
+  KJ_EXPECT(gate.wait().poll(ws));
+  KJ_EXPECT(!gate.onBroken().poll(ws));
+}
+
+KJ_TEST("OutputGate waits fail with the earliest failed lock") {
+  kj::EventLoop loop;
+  kj::WaitScope ws(loop);
+
+  OutputGate gate;
+  auto onBroken = gate.onBroken();
+
+  auto paf1 = kj::newPromiseAndFulfiller<void>();
+  auto blocker1 = gate.lockWhile(kj::mv(paf1.promise));
+  auto promise1 = gate.wait();
+
+  auto paf2 = kj::newPromiseAndFulfiller<void>();
+  auto blocker2 = gate.lockWhile(kj::mv(paf2.promise));
+  auto promise2 = gate.wait();
+
+  auto paf3 = kj::newPromiseAndFulfiller<void>();
+  auto blocker3 = gate.lockWhile(kj::mv(paf3.promise));
+  auto promise3 = gate.wait();
+
+  // The newest lock fails first, then an older one.
+  paf3.fulfiller->reject(KJ_EXCEPTION(FAILED, "bar"));
+  KJ_EXPECT_THROW_MESSAGE("bar", blocker3.wait(ws));
+  KJ_ASSERT(onBroken.poll(ws));
+  KJ_EXPECT_THROW_MESSAGE("bar", onBroken.wait(ws));
+
+  paf2.fulfiller->reject(KJ_EXCEPTION(FAILED, "foo"));
+  KJ_EXPECT_THROW_MESSAGE("foo", blocker2.wait(ws));
+  KJ_EXPECT(!promise1.poll(ws));
+  KJ_EXPECT(!promise2.poll(ws));
+  KJ_EXPECT(!promise3.poll(ws));
+
+  paf1.fulfiller->fulfill();
+  blocker1.wait(ws);
+
+  // A wait which only covered the successful lock succeeds. Later ones fail with the exception
+  // of the earliest lock that failed, regardless of which failed first.
+  promise1.wait(ws);
+  KJ_EXPECT_THROW_MESSAGE("foo", promise2.wait(ws));
+  KJ_EXPECT_THROW_MESSAGE("foo", promise3.wait(ws));
+
+  // Every future wait fails too, even once later locks succeed.
+  KJ_EXPECT_THROW_MESSAGE("foo", gate.wait().wait(ws));
+  auto blocker4 = gate.lockWhile(kj::Promise<void>(kj::READY_NOW));
+  auto promise4 = gate.wait();
+  blocker4.wait(ws);
+  KJ_EXPECT_THROW_MESSAGE("foo", promise4.wait(ws));
+}
+
+KJ_TEST("OutputGate waits can be canceled") {
+  kj::EventLoop loop;
+  kj::WaitScope ws(loop);
+
+  OutputGate gate;
+
+  auto paf = kj::newPromiseAndFulfiller<void>();
+  auto blocker = gate.lockWhile(kj::mv(paf.promise));
+
+  auto promise1 = gate.wait();
+  auto promise2 = gate.wait();
+  auto promise3 = gate.wait();
+  promise2 = nullptr;
+
+  paf.fulfiller->fulfill();
+  blocker.wait(ws);
+  promise1.wait(ws);
+  promise3.wait(ws);
+}
+
 }  // namespace
 }  // namespace workerd
@@ -304,24 +304,95 @@ InputGate& InputGate::CriticalSection::parentAsInputGate() {
 
 // =======================================================================================
 
-OutputGate::OutputGate(Hooks& hooks)
-    : hooks(hooks),
-      pastLocksPromise(kj::Promise<void>(kj::READY_NOW).fork()) {}
-OutputGate::~OutputGate() noexcept(false) {}
+OutputGate::OutputGate(Hooks& hooks): hooks(hooks) {}
+OutputGate::~OutputGate() noexcept(false) {
+  // Nothing will release the remaining waiters now.
+  while (!waiters.empty()) {
+    auto& waiter = waiters.front();
+    waiters.remove(waiter);
+    waiter.gate = kj::none;
+    hooks.outputGateWaiterRemoved();
+    waiter.fulfiller.reject(KJ_EXCEPTION(DISCONNECTED, "output gate was destroyed"));
+  }
+
+  // lockWhile() coroutines refer to the gate, so none should still be running. Just make sure the
+  // list doesn't point into them.
+  while (!locks.empty()) {
+    locks.remove(locks.front());
+  }
+}
 
 const OutputGate::Hooks OutputGate::Hooks::DEFAULT;
 
-kj::Own<kj::PromiseFulfiller<void>> OutputGate::lock() {
-  auto paf = kj::newPromiseAndFulfiller<void>();
-  auto joined = kj::joinPromises(kj::arr(pastLocksPromise.addBranch(), kj::mv(paf.promise)));
-  pastLocksPromise = joined.fork();
-  return kj::mv(paf.fulfiller);
+OutputGate::Waiter::Waiter(kj::PromiseFulfiller<void>& fulfiller, OutputGate& gate)
+    : fulfiller(fulfiller),
+      gate(gate),
+      sequence(gate.nextSequence - 1) {
+  gate.hooks.outputGateWaiterAdded();
+
+  if (gate.locks.empty()) {
+    // Every lock taken so far has been released already.
+    KJ_IF_SOME(f, gate.failure) {
+      fulfiller.reject(kj::cp(f.exception));
+    } else {
+      fulfiller.fulfill();
+    }
+  } else {
+    gate.waiters.add(*this);
+  }
+}
+
+OutputGate::Waiter::~Waiter() noexcept(false) {
+  KJ_IF_SOME(g, gate) {
+    g.hooks.outputGateWaiterRemoved();
+    if (link.isLinked()) {
+      g.waiters.remove(*this);
+    }
+  }
+}
+
+void OutputGate::lock(HeldLock& lock) {
+  lock.sequence = nextSequence++;
+  locks.add(lock);
+}
+
+void OutputGate::release(HeldLock& lock, kj::Maybe<const kj::Exception&> error) {
+  KJ_IF_SOME(e, error) {
+    setBroken(e);
+    bool earliest = true;
+    KJ_IF_SOME(f, failure) {
+      earliest = lock.sequence < f.sequence;
+    }
+    if (earliest) {
+      failure = Failure{lock.sequence, kj::cp(e)};
+    }
+  }
+
+  bool wasOldest = &locks.front() == &lock;
+  locks.remove(lock);
+  if (!wasOldest) {
+    // An older lock is still held, so no waiter can be released yet.
+    return;
+  }
+
+  // Release every waiter which only waits for locks older than the oldest lock still held.
+  uint64_t oldestHeld = locks.empty() ? nextSequence : locks.front().sequence;
+  while (!waiters.empty() && waiters.front().sequence < oldestHeld) {
+    auto& waiter = waiters.front();
+    waiters.remove(waiter);
+
+    KJ_IF_SOME(f, failure) {
+      if (f.sequence <= waiter.sequence) {
+        waiter.fulfiller.reject(kj::cp(f.exception));
+        continue;
+      }
+    }
+    waiter.fulfiller.fulfill();
+  }
 }
 
 kj::Promise<void> OutputGate::wait() {
-  hooks.outputGateWaiterAdded();
-  return pastLocksPromise.addBranch().attach(
-      kj::defer([this]() { hooks.outputGateWaiterRemoved(); }));
+  return kj::newAdaptedPromise<void, Waiter>(*this);
 }
 
 kj::Promise<void> OutputGate::onBroken() {
@@ -355,8 +426,7 @@ kj::Exception OutputGate::makeUnfulfilledException() {
 }
 
 void OutputGate::setBroken(const kj::Exception& e) {
-  // We assume the exception is already propagated into `pastLocksPromise`, so all we need to do
-  // is handle onBroken().
+  // Waiters are handled by release(), so all we need to do is handle onBroken().
   KJ_IF_SOME(f, brokenState.tryGet<kj::Own<kj::PromiseFulfiller<void>>>()) {
     f.get()->reject(kj::cp(e));
   }
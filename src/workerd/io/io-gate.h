@@ -272,14 +272,47 @@ class OutputGate {
  private:
   Hooks& hooks;
 
-  kj::ForkedPromise<void> pastLocksPromise;
+  // Each call to lockWhile() takes the next sequence number and holds a HeldLock, which lives in
+  // the lockWhile() coroutine, until its promise completes. Held locks are kept in sequence order,
+  // so `locks.front()` is always the oldest lock still held, however they are released.
+  struct HeldLock {
+    uint64_t sequence;
+    kj::ListLink<HeldLock> link;
+  };
+
+  // Each call to wait() notes the sequence number of the last lock taken so far, and is released
+  // once every lock up to that one has been. Waiters are kept in the order they were added, so
+  // that their sequence numbers are non-decreasing.
+  struct Waiter {
+    Waiter(kj::PromiseFulfiller<void>& fulfiller, OutputGate& gate);
+    ~Waiter() noexcept(false);
+
+    kj::PromiseFulfiller<void>& fulfiller;
+    kj::Maybe<OutputGate&> gate;
+    uint64_t sequence;
+    kj::ListLink<Waiter> link;
+  };
+
+  struct Failure {
+    uint64_t sequence;
+    kj::Exception exception;
+  };
+
+  uint64_t nextSequence = 1;
+  kj::List<HeldLock, &HeldLock::link> locks;
+  kj::List<Waiter, &Waiter::link> waiters;
+
+  // The earliest lock which failed or was canceled, if any. Waiters for that lock or any later
+  // one will reject with its exception.
+  kj::Maybe<Failure> failure;
 
   // A fulfiller for onBroken(), or an exception if already broken.
   kj::OneOf<kj::Own<kj::PromiseFulfiller<void>>, kj::Exception> brokenState;
 
   void setBroken(const kj::Exception& e);
 
-  kj::Own<kj::PromiseFulfiller<void>> lock();
+  void lock(HeldLock& lock);
+  void release(HeldLock& lock, kj::Maybe<const kj::Exception&> error);
   static kj::Exception makeUnfulfilledException();
 };
 
@@ -288,36 +321,34 @@ class OutputGate {
 
 template <typename T>
 kj::Promise<T> OutputGate::lockWhile(kj::Promise<T> promise) {
-  auto fulfiller = lock();
-
   if constexpr (std::is_void_v<T>) {
     promise = promise.exclusiveJoin(hooks.makeTimeoutPromise());
   } else {
     promise = promise.exclusiveJoin(hooks.makeTimeoutPromise().then([]() -> T { KJ_UNREACHABLE; }));
   }
 
+  HeldLock heldLock;
+  lock(heldLock);
   hooks.outputGateLocked();
-  auto rejectIfCanceled = kj::defer([this, &fulfiller]() {
+  auto rejectIfCanceled = kj::defer([this, &heldLock]() {
     hooks.outputGateReleased();
-    if (fulfiller->isWaiting()) {
+    if (heldLock.link.isLinked()) {
       auto e = makeUnfulfilledException();
-      setBroken(e);
-      fulfiller->reject(kj::mv(e));
+      release(heldLock, e);
     }
   });
 
   try {
     if constexpr (std::is_void_v<T>) {
       co_await promise;
-      fulfiller->fulfill();
+      release(heldLock, kj::none);
     } else {
       auto v = co_await promise;
-      fulfiller->fulfill();
+      release(heldLock, kj::none);
       co_return v;
     }
   } catch (kj::Exception& e) {
-    setBroken(e);
-    fulfiller->reject(kj::cp(e));
+    release(heldLock, e);
     kj::throwFatalException(kj::cp(e));
   }
 }
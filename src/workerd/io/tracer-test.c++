@@ -0,0 +1,111 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/io/tracer.h>
+
+#include <kj/async.h>
+#include <kj/test.h>
+
+namespace workerd {
+namespace {
+
+// Counts how often the tracer asked for each kind of data.
+struct Producers {
+  uint eventInfo = 0;
+  uint logs = 0;
+  uint spans = 0;
+
+  void run(BaseTracer& tracer) {
+    tracing::InvocationSpanContext context(
+        tracing::TraceId(1, 2), tracing::TraceId(3, 4), tracing::SpanId(5));
+    auto now = kj::UNIX_EPOCH;
+
+    tracer.setEventInfo(context, now, [&]() -> tracing::EventInfo {
+      ++eventInfo;
+      return tracing::FetchEventInfo(kj::HttpMethod::GET, kj::str("https://example.com/"),
+          kj::str("{}"), kj::Array<tracing::FetchEventInfo::Header>());
+    });
+    tracer.setFetchResponseInfo(tracing::FetchResponseInfo(200));
+    tracer.addLog(context, now, LogLevel::INFO, [&]() {
+      ++logs;
+      return kj::str("[\"hello\"]");
+    });
+    tracer.addSpan([&]() {
+      ++spans;
+      return CompleteSpan(kj::ConstString(kj::str("span")), now);
+    });
+  }
+};
+
+// Runs the producers against the tracer for one stage of a pipeline, and returns the pipeline's
+// traces, which are complete once both are gone.
+kj::Promise<kj::Array<kj::Own<Trace>>> runInPipeline(
+    Producers& producers, PipelineLogLevel logLevel) {
+  auto pipeline = kj::rc<PipelineTracer>();
+  auto traces = pipeline->onComplete();
+  producers.run(*pipeline->makeWorkerTracer(logLevel, ExecutionModel::STATELESS, kj::none,
+      kj::none, kj::none, kj::none, kj::none, nullptr, kj::none, kj::none));
+  return traces;
+}
+
+KJ_TEST("WorkerTracer without a pipeline still records unless the log level is NONE") {
+  {
+    Producers producers;
+    auto tracer = kj::refcounted<WorkerTracer>(PipelineLogLevel::FULL, ExecutionModel::STATELESS);
+    producers.run(*tracer);
+
+    KJ_EXPECT(producers.eventInfo == 1);
+    KJ_EXPECT(producers.logs == 1);
+    KJ_EXPECT(producers.spans == 1);
+  }
+  {
+    Producers producers;
+    auto tracer = kj::refcounted<WorkerTracer>(PipelineLogLevel::NONE, ExecutionModel::STATELESS);
+    producers.run(*tracer);
+
+    KJ_EXPECT(producers.eventInfo == 0);
+    KJ_EXPECT(producers.logs == 0);
+    KJ_EXPECT(producers.spans == 0);
+  }
+}
+
+KJ_TEST("WorkerTracer builds nothing with PipelineLogLevel::NONE") {
+  kj::EventLoop loop;
+  kj::WaitScope waitScope(loop);
+
+  Producers producers;
+  auto traces = runInPipeline(producers, PipelineLogLevel::NONE);
+
+  KJ_EXPECT(producers.eventInfo == 0);
+  KJ_EXPECT(producers.logs == 0);
+  KJ_EXPECT(producers.spans == 0);
+
+  auto result = traces.wait(waitScope);
+  KJ_ASSERT(result.size() == 1);
+  KJ_EXPECT(result[0]->eventInfo == kj::none);
+}
+
+KJ_TEST("WorkerTracer builds each item once for a tail worker") {
+  kj::EventLoop loop;
+  kj::WaitScope waitScope(loop);
+
+  Producers producers;
+  auto traces = runInPipeline(producers, PipelineLogLevel::FULL);
+
+  KJ_EXPECT(producers.eventInfo == 1);
+  KJ_EXPECT(producers.logs == 1);
+  KJ_EXPECT(producers.spans == 1);
+
+  auto result = traces.wait(waitScope);
+  KJ_ASSERT(result.size() == 1);
+  auto& trace = *result[0];
+  KJ_EXPECT(KJ_ASSERT_NONNULL(trace.eventInfo).get<tracing::FetchEventInfo>().url ==
+      "https://example.com/");
+  KJ_ASSERT(trace.logs.size() == 1);
+  KJ_EXPECT(trace.logs[0].message == "[\"hello\"]");
+  KJ_EXPECT(trace.spans.size() == 1);
+}
+
+}  // namespace
+}  // namespace workerd
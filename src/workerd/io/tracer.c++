@@ -126,13 +126,14 @@ constexpr kj::LiteralStringConst logSizeExceeded =
 void WorkerTracer::addLog(const tracing::InvocationSpanContext& context,
     kj::Date timestamp,
     LogLevel logLevel,
-    kj::String message) {
+    kj::FunctionParam<kj::String()> makeMessage) {
   if (trace->exceededLogLimit) {
     return;
   }
-  if (pipelineLogLevel == PipelineLogLevel::NONE) {
+  if (!isRecording()) {
     return;
   }
+  auto message = makeMessage();
   size_t newSize = trace->bytesUsed + sizeof(tracing::Log) + message.size();
   if (newSize > MAX_TRACE_BYTES) {
     trace->exceededLogLimit = true;
@@ -151,7 +152,7 @@ void WorkerTracer::addLog(const tracing::InvocationSpanContext& context,
   trace->logs.add(timestamp, logLevel, kj::mv(message));
 }
 
-void WorkerTracer::addSpan(CompleteSpan&& span) {
+void WorkerTracer::addSpan(kj::FunctionParam<CompleteSpan()> makeSpan) {
   // This is where we'll actually encode the span.
   // Drop any spans beyond MAX_USER_SPANS.
   if (trace->spans.size() >= MAX_USER_SPANS) {
@@ -161,9 +162,10 @@ void WorkerTracer::addSpan(CompleteSpan&& span) {
   if (trace->exceededLogLimit) {
     return;
   }
-  if (pipelineLogLevel == PipelineLogLevel::NONE) {
+  if (!isRecording()) {
     return;
   }
+  auto span = makeSpan();
 
   // 48B for traceID, spanID, parentSpanID, start & end time.
   const int fixedSpanOverhead = 48;
@@ -222,7 +224,7 @@ void WorkerTracer::addException(const tracing::InvocationSpanContext& context,
   // TODO(someday): For now, we're using logLevel == none as a hint to avoid doing anything
   //   expensive while tracing.  We may eventually want separate configuration for exceptions vs.
   //   logs.
-  if (pipelineLogLevel == PipelineLogLevel::NONE) {
+  if (!isRecording()) {
     return;
   }
   size_t newSize = trace->bytesUsed + sizeof(tracing::Exception) + name.size() + message.size();
@@ -251,7 +253,7 @@ void WorkerTracer::addDiagnosticChannelEvent(const tracing::InvocationSpanContex
   if (trace->exceededDiagnosticChannelEventLimit) {
     return;
   }
-  if (pipelineLogLevel == PipelineLogLevel::NONE) {
+  if (!isRecording()) {
     return;
   }
   size_t newSize =
@@ -273,19 +275,19 @@ void WorkerTracer::addDiagnosticChannelEvent(const tracing::InvocationSpanContex
   trace->diagnosticChannelEvents.add(timestamp, kj::mv(channel), kj::mv(message));
 }
 
-void WorkerTracer::setEventInfo(
-    const tracing::InvocationSpanContext& context, kj::Date timestamp, tracing::EventInfo&& info) {
+void WorkerTracer::setEventInfo(const tracing::InvocationSpanContext& context,
+    kj::Date timestamp,
+    kj::FunctionParam<tracing::EventInfo()> makeInfo) {
   KJ_ASSERT(trace->eventInfo == kj::none, "tracer can only be used for a single event");
 
   // TODO(someday): For now, we're using logLevel == none as a hint to avoid doing anything
   //   expensive while tracing.  We may eventually want separate configuration for event info vs.
   //   logs.
-  // TODO(perf): Find a way to allow caller to avoid the cost of generation if the info struct
-  //   won't be used?
-  if (pipelineLogLevel == PipelineLogLevel::NONE) {
+  if (!isRecording()) {
     return;
   }
 
+  auto info = makeInfo();
   trace->eventTimestamp = timestamp;
   this->topLevelInvocationSpanContext = context.clone();
 
@@ -357,7 +359,7 @@ void WorkerTracer::setFetchResponseInfo(tracing::FetchResponseInfo&& info) {
   // Match the behavior of setEventInfo(). Any resolution of the TODO comments
   // in setEventInfo() that are related to this check while probably also affect
   // this function.
-  if (pipelineLogLevel == PipelineLogLevel::NONE) {
+  if (!isRecording()) {
     return;
   }
 
@@ -381,4 +383,8 @@ SpanParent WorkerTracer::getUserRequestSpan() {
   return userRequestSpan;
 }
 
+bool WorkerTracer::isRecording() const {
+  return pipelineLogLevel != PipelineLogLevel::NONE;
+}
+
 }  // namespace workerd
@@ -7,6 +7,8 @@
 #include <workerd/io/trace.h>
 #include <workerd/util/weak-refs.h>
 
+#include <kj/function.h>
+
 namespace workerd {
 namespace tracing {
 
@@ -103,13 +105,17 @@ class BaseTracer: public kj::Refcounted {
     self->invalidate();
   }
 
+  // addLog(), addSpan() and setEventInfo() take a function producing what they record, and only
+  // call it if the result will actually be recorded. This way callers don't pay for building
+  // strings or copying headers when no tail worker will see them.
+
   // Adds log line to trace.  For Spectre, timestamp should only be as accurate as JS Date.now().
   virtual void addLog(const tracing::InvocationSpanContext& context,
       kj::Date timestamp,
       LogLevel logLevel,
-      kj::String message) = 0;
+      kj::FunctionParam<kj::String()> makeMessage) = 0;
   // Add a span. There can be at most MAX_USER_SPANS spans in a trace.
-  virtual void addSpan(CompleteSpan&& span) = 0;
+  virtual void addSpan(kj::FunctionParam<CompleteSpan()> makeSpan) = 0;
 
   virtual void addException(const tracing::InvocationSpanContext& context,
       kj::Date timestamp,
@@ -125,7 +131,7 @@ class BaseTracer: public kj::Refcounted {
   // Adds info about the event that triggered the trace.  Must not be called more than once.
   virtual void setEventInfo(const tracing::InvocationSpanContext& context,
       kj::Date timestamp,
-      tracing::EventInfo&& info) = 0;
+      kj::FunctionParam<tracing::EventInfo()> makeInfo) = 0;
 
   // Adds info about the response. Must not be called more than once, and only
   // after passing a FetchEventInfo to setEventInfo().
@@ -163,8 +169,8 @@ class WorkerTracer: public BaseTracer {
   void addLog(const tracing::InvocationSpanContext& context,
       kj::Date timestamp,
       LogLevel logLevel,
-      kj::String message) override;
-  void addSpan(CompleteSpan&& span) override;
+      kj::FunctionParam<kj::String()> makeMessage) override;
+  void addSpan(kj::FunctionParam<CompleteSpan()> makeSpan) override;
   void addException(const tracing::InvocationSpanContext& context,
       kj::Date timestamp,
       kj::String name,
@@ -176,7 +182,7 @@ class WorkerTracer: public BaseTracer {
       kj::Array<kj::byte> message) override;
   void setEventInfo(const tracing::InvocationSpanContext& context,
       kj::Date timestamp,
-      tracing::EventInfo&& info) override;
+      kj::FunctionParam<tracing::EventInfo()> makeInfo) override;
   void setFetchResponseInfo(tracing::FetchResponseInfo&& info) override;
   void setOutcome(EventOutcome outcome, kj::Duration cpuTime, kj::Duration wallTime) override;
   SpanParent getUserRequestSpan() override;
@@ -200,5 +206,10 @@ class WorkerTracer: public BaseTracer {
   kj::Maybe<kj::Rc<PipelineTracer>> parentPipeline;
 
   kj::Maybe<kj::Own<tracing::TailStreamWriter>> maybeTailStreamWriter;
+
+  // True if we build and record event info, logs, exceptions, spans and so on, which is whenever
+  // the log level isn't NONE. A tracer without a pipeline records too, since its owner may read
+  // the trace directly.
+  bool isRecording() const;
 };
 }  // namespace workerd
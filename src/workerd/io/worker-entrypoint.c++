@@ -95,7 +95,7 @@ class WorkerEntrypoint final: public WorkerInterface {
   kj::Maybe<kj::Promise<void>> proxyTask;
   kj::Maybe<kj::Own<WorkerInterface>> failOpenService;
   bool loggedExceptionEarlier = false;
-  kj::Maybe<jsg::Ref<api::AbortController>> abortController;
+  kj::Maybe<kj::Own<api::LazyAbortSignal>> requestSignal;
 
   void init(kj::Own<const Worker> worker,
       kj::Maybe<kj::Own<Worker::Actor>> actor,
@@ -256,38 +256,41 @@ kj::Promise<void> WorkerEntrypoint::request(kj::HttpMethod method,
   bool isActor = context.getActor() != kj::none;
 
   KJ_IF_SOME(t, incomingRequest->getWorkerTracer()) {
-    auto timestamp = context.now();
-    kj::String cfJson;
-    KJ_IF_SOME(c, cfBlobJson) {
-      cfJson = kj::str(c);
-    }
+    t.setEventInfo(context.getInvocationSpanContext(), context.now(), [&]() -> tracing::EventInfo {
+      kj::String cfJson;
+      KJ_IF_SOME(c, cfBlobJson) {
+        cfJson = kj::str(c);
+      }
 
-    // To match our historical behavior (when we used to pull the headers from the JavaScript
-    // object later on), we need to canonicalize the headers, including:
-    // - Lower-case the header name.
-    // - Combine multiple headers with the same name into a comma-delimited list. (This explicitly
-    //   breaks the Set-Cookie header, incidentally, but should be equivalent for all other
-    //   headers.)
-    kj::TreeMap<kj::String, kj::Vector<kj::StringPtr>> traceHeaders;
-    headers.forEach([&](kj::StringPtr name, kj::StringPtr value) {
-      kj::String lower = toLower(name);
-      auto& slot = traceHeaders.findOrCreate(
-          lower, [&]() { return decltype(traceHeaders)::Entry{kj::mv(lower), {}}; });
-      slot.add(value);
-    });
-    auto traceHeadersArray = KJ_MAP(entry, traceHeaders) {
-      return tracing::FetchEventInfo::Header(kj::mv(entry.key), kj::strArray(entry.value, ", "));
-    };
+      // To match our historical behavior (when we used to pull the headers from the JavaScript
+      // object later on), we need to canonicalize the headers, including:
+      // - Lower-case the header name.
+      // - Combine multiple headers with the same name into a comma-delimited list. (This
+      //   explicitly breaks the Set-Cookie header, incidentally, but should be equivalent for all
+      //   other headers.)
+      kj::TreeMap<kj::String, kj::Vector<kj::StringPtr>> traceHeaders;
+      headers.forEach([&](kj::StringPtr name, kj::StringPtr value) {
+        kj::String lower = toLower(name);
+        auto& slot = traceHeaders.findOrCreate(
+            lower, [&]() { return decltype(traceHeaders)::Entry{kj::mv(lower), {}}; });
+        slot.add(value);
+      });
+      auto traceHeadersArray = KJ_MAP(entry, traceHeaders) {
+        return tracing::FetchEventInfo::Header(kj::mv(entry.key), kj::strArray(entry.value, ", "));
+      };
 
-    t.setEventInfo(context.getInvocationSpanContext(), timestamp,
-        tracing::FetchEventInfo(method, kj::str(url), kj::mv(cfJson), kj::mv(traceHeadersArray)));
+      return tracing::FetchEventInfo(
+          method, kj::str(url), kj::mv(cfJson), kj::mv(traceHeadersArray));
+    });
   }
 
   auto metricsForCatch = kj::addRef(incomingRequest->getMetrics());
   auto metricsForProxyTask = kj::addRef(incomingRequest->getMetrics());
 
+  // Links the entrypoint's flow to the request's flow within the IoContext.
   TRACE_EVENT_BEGIN("workerd", "WorkerEntrypoint::request() waiting on context",
-      PERFETTO_TRACK_FROM_POINTER(&context), PERFETTO_FLOW_FROM_POINTER(this));
+      PERFETTO_TRACK_FROM_POINTER(&context), PERFETTO_FLOW_FROM_POINTER(this),
+      PERFETTO_FLOW_FROM_POINTER(incomingRequest.get()));
 
   return context
       .run([this, &context, method, url, &headers, &requestBody,
@@ -298,15 +301,15 @@ kj::Promise<void> WorkerEntrypoint::request(kj::HttpMethod method,
     jsg::AsyncContextFrame::StorageScope traceScope = context.makeAsyncTraceScope(lock);
     auto featureFlags = FeatureFlags::get(lock);
 
-    kj::Maybe<jsg::Ref<api::AbortSignal>> signal;
+    kj::Maybe<kj::Own<api::LazyAbortSignal>> signal;
 
     if (featureFlags.getEnableRequestSignal()) {
       auto abortSignalFlag = featureFlags.getRequestSignalPassthrough()
           ? api::AbortSignal::Flag::NONE
           : api::AbortSignal::Flag::IGNORE_FOR_SUBREQUESTS;
-      jsg::Lock& js = lock;
-      signal.emplace(abortController.emplace(js.alloc<api::AbortController>(js, abortSignalFlag))
-                         ->getSignal());
+      auto& lazySignal =
+          requestSignal.emplace(kj::refcounted<api::LazyAbortSignal>(abortSignalFlag));
+      signal = kj::addRef(*lazySignal);
     }
 
     return lock.getGlobalScope().request(method, url, headers, requestBody, wrappedResponse,
@@ -346,20 +349,26 @@ kj::Promise<void> WorkerEntrypoint::request(kj::HttpMethod method,
     if (proxyTask == kj::none && !loggedExceptionEarlier) {
       // When the client disconnects, trigger an abort on request.signal, unless the request has
       // already completed normally, or failed with an exception.
-
-      // TODO(perf): Don't add a task to trigger the abort unless we know it has at least one
-      // listener.
-      KJ_IF_SOME(ctrl, abortController) {
-        context.addWaitUntil(context.run([ctrl = ctrl.addRef()](Worker::Lock& lock) mutable {
-          ctrl->getSignal()->triggerAbort(
-              lock, JSG_KJ_EXCEPTION(DISCONNECTED, DOMAbortError, "The client has disconnected"));
-        }));
+      //
+      // We only need to re-enter the isolate if aborting the signal would run JavaScript. If the
+      // signal hasn't even been allocated yet, it will be allocated already aborted.
+      KJ_IF_SOME(signal, requestSignal) {
+        auto exception =
+            JSG_KJ_EXCEPTION(DISCONNECTED, DOMAbortError, "The client has disconnected");
+        if (signal->needsLockToAbort()) {
+          context.addWaitUntil(context.run(
+              [signal = kj::addRef(*signal), exception = kj::mv(exception)](
+                  Worker::Lock& lock) mutable { signal->abort(lock, kj::mv(exception)); }));
+        } else {
+          signal->abort(kj::mv(exception));
+        }
       }
     }
 
-    // Release reference to the AbortController.
-    // Either the waitUntilTask holds a reference to it, or it will never be triggered at all.
-    abortController = kj::none;
+    // Release our reference to the request's signal.
+    // Either the waitUntilTask holds a reference to it, or it has already been aborted, or it
+    // will never be aborted at all.
+    requestSignal = kj::none;
 
     auto promise = incomingRequest->drain().attach(kj::mv(incomingRequest));
     waitUntilTasks.add(maybeAddGcPassForTest(context, kj::mv(promise)));
@@ -559,8 +568,9 @@ kj::Promise<WorkerInterface::ScheduledResult> WorkerEntrypoint::runScheduled(
   double eventTime = (scheduledTime - kj::UNIX_EPOCH) / kj::MILLISECONDS;
 
   KJ_IF_SOME(t, context.getWorkerTracer()) {
-    t.setEventInfo(context.getInvocationSpanContext(), context.now(),
-        tracing::ScheduledEventInfo(eventTime, kj::str(cron)));
+    t.setEventInfo(context.getInvocationSpanContext(), context.now(), [&]() -> tracing::EventInfo {
+      return tracing::ScheduledEventInfo(eventTime, kj::str(cron));
+    });
   }
 
   // Scheduled handlers run entirely in waitUntil() tasks.
@@ -620,8 +630,8 @@ kj::Promise<WorkerInterface::AlarmResult> WorkerEntrypoint::runAlarmImpl(
   incomingRequest->delivered();
 
   KJ_IF_SOME(t, incomingRequest->getWorkerTracer()) {
-    t.setEventInfo(
-        context.getInvocationSpanContext(), context.now(), tracing::AlarmEventInfo(scheduledTime));
+    t.setEventInfo(context.getInvocationSpanContext(), context.now(),
+        [&]() -> tracing::EventInfo { return tracing::AlarmEventInfo(scheduledTime); });
   }
 
   auto scheduleAlarmResult = co_await actor.scheduleAlarm(scheduledTime);
@@ -711,7 +721,8 @@ kj::Promise<bool> WorkerEntrypoint::test() {
 
   auto& context = incomingRequest->getContext();
   KJ_IF_SOME(t, context.getWorkerTracer()) {
-    t.setEventInfo(context.getInvocationSpanContext(), context.now(), tracing::CustomEventInfo());
+    t.setEventInfo(context.getInvocationSpanContext(), context.now(),
+        []() -> tracing::EventInfo { return tracing::CustomEventInfo(); });
   }
 
   context.addWaitUntil(context.run([entrypointName = entrypointName, props = kj::mv(props),
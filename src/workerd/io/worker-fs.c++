@@ -616,6 +616,11 @@ class DirectoryBase final: public Directory {
   }
 };
 
+// Read-only data shared by a writable file until the file is first modified.
+struct CopyOnWrite {
+  kj::ArrayPtr<const kj::byte> data;
+};
+
 // The implementation of the File interface.
 class FileImpl final: public File {
  public:
@@ -625,6 +630,10 @@ class FileImpl final: public File {
   // Constructor used to create a writable file.
   FileImpl(kj::Array<kj::byte> owned): ownedOrView(kj::mv(owned)), lastModified(kj::UNIX_EPOCH) {}
 
+  // Constructor used to create a writable copy of read-only data. The data is only copied once
+  // the file is first modified.
+  FileImpl(CopyOnWrite data): ownedOrView(data), lastModified(kj::UNIX_EPOCH) {}
+
   kj::Maybe<FsError> setLastModified(jsg::Lock& js, kj::Date date = kj::UNIX_EPOCH) override {
     if (isWritable()) {
       lastModified = date;
@@ -664,14 +673,13 @@ class FileImpl final: public File {
     if (!isWritable()) {
       return FsError::READ_ONLY;
     }
-    auto& owned = writableView();
     size_t end = offset + buffer.size();
-    if (end > owned.size()) {
+    if (end > readableView().size()) {
       KJ_IF_SOME(err, resize(js, end)) {
         return err;
       }
     }
-    owned.slice(offset, end).copyFrom(buffer);
+    writableView(js).slice(offset, end).copyFrom(buffer);
     return static_cast<uint32_t>(buffer.size());
   }
 
@@ -679,8 +687,9 @@ class FileImpl final: public File {
     if (!isWritable()) {
       return FsError::READ_ONLY;
     }
-    auto& owned = writableView();
-    if (size == owned.size()) return kj::none;  // Nothing to do.
+    // If the data hasn't been copied yet, we copy it straight into the resized buffer.
+    auto current = readableView();
+    if (size == current.size()) return kj::none;  // Nothing to do.
 
     auto maxSize = Worker::Isolate::from(js).getLimitEnforcer().getBlobSizeLimit();
     if (size > maxSize) {
@@ -689,13 +698,13 @@ class FileImpl final: public File {
 
     auto newData = kj::heapArray<kj::byte>(size);
 
-    if (size > owned.size()) {
+    if (size > current.size()) {
       // To grow the file, we need to allocate a new array, copy the old data over,
       // and replace the original.
-      newData.first(owned.size()).copyFrom(owned);
-      newData.slice(owned.size()).fill(0);
+      newData.first(current.size()).copyFrom(current);
+      newData.slice(current.size()).fill(0);
     } else {
-      newData.asPtr().copyFrom(owned.first(size));
+      newData.asPtr().copyFrom(current.first(size));
     }
     ownedOrView = newData.attach(js.getExternalMemoryAdjustment(newData.size()));
     return kj::none;
@@ -705,10 +714,10 @@ class FileImpl final: public File {
     if (!isWritable()) {
       return FsError::READ_ONLY;
     }
-    auto& view = writableView();
     int actualOffset = offset.orDefault(0);
-    if (actualOffset >= view.size() || view.size() == 0) return kj::none;
-    view.slice(actualOffset).fill(value);
+    auto size = readableView().size();
+    if (actualOffset >= size || size == 0) return kj::none;
+    writableView(js).slice(actualOffset).fill(value);
     return kj::none;
   }
 
@@ -730,6 +739,9 @@ class FileImpl final: public File {
       KJ_CASE_ONEOF(view, kj::ArrayPtr<const kj::byte>) {
         return;
       }
+      KJ_CASE_ONEOF(cow, CopyOnWrite) {
+        return;
+      }
     }
   }
 
@@ -747,7 +759,15 @@ class FileImpl final: public File {
         if (view.size() > maxSize) [[unlikely]] {
           return FsError::FILE_SIZE_LIMIT_EXCEEDED;
         }
-        kj::Rc<File> file = kj::rc<FileImpl>(kj::heapArray<kj::byte>(view));
+        // Read-only data never changes, so the copy can share it until the copy is modified.
+        kj::Rc<File> file = kj::rc<FileImpl>(CopyOnWrite{view});
+        return kj::mv(file);
+      }
+      KJ_CASE_ONEOF(cow, CopyOnWrite) {
+        if (cow.data.size() > maxSize) [[unlikely]] {
+          return FsError::FILE_SIZE_LIMIT_EXCEEDED;
+        }
+        kj::Rc<File> file = kj::rc<FileImpl>(cow);
         return kj::mv(file);
       }
     }
@@ -780,16 +800,22 @@ class FileImpl final: public File {
   }
 
  private:
-  kj::OneOf<kj::Array<kj::byte>, kj::ArrayPtr<const kj::byte>> ownedOrView;
+  kj::OneOf<kj::Array<kj::byte>, kj::ArrayPtr<const kj::byte>, CopyOnWrite> ownedOrView;
   kj::Date lastModified;
   mutable kj::Maybe<kj::String> maybeUniqueId;
 
   bool isWritable() const {
-    // Our file is only writable if it owns the actual data buffer.
-    return ownedOrView.is<kj::Array<kj::byte>>();
+    // Our file is only writable if it owns the actual data buffer, or will own a copy of it once
+    // it is modified.
+    return !ownedOrView.is<kj::ArrayPtr<const kj::byte>>();
   }
 
-  kj::Array<kj::byte>& writableView() {
+  kj::Array<kj::byte>& writableView(jsg::Lock& js) {
+    KJ_IF_SOME(cow, ownedOrView.tryGet<CopyOnWrite>()) {
+      auto data = kj::heapArray<kj::byte>(cow.data);
+      auto size = data.size();
+      ownedOrView = data.attach(js.getExternalMemoryAdjustment(size));
+    }
     return KJ_REQUIRE_NONNULL(ownedOrView.tryGet<kj::Array<kj::byte>>());
   }
 
@@ -801,6 +827,9 @@ class FileImpl final: public File {
       KJ_CASE_ONEOF(owned, kj::Array<kj::byte>) {
         return owned.asPtr().asConst();
       }
+      KJ_CASE_ONEOF(cow, CopyOnWrite) {
+        return cow.data;
+      }
     }
     KJ_UNREACHABLE;
   }
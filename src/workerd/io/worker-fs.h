@@ -272,9 +272,10 @@ class File: public kj::Refcounted {
 
   // Creates a new readable in-memory file wrapping the given data. The file
   // does not take ownership of the data and the data must remain valid for the
-  // lifetime of the file. The file will be read-only. It will not be initially
-  // included in a directory. The contents of the file will not be tracked and
-  // will not count towards the isolate external memory usage.
+  // lifetime of the file and of any copies made of it with clone(), which share
+  // the data until they are first modified. The file will be read-only. It will
+  // not be initially included in a directory. The contents of the file will not
+  // be tracked and will not count towards the isolate external memory usage.
   static kj::Rc<File> newReadable(kj::ArrayPtr<const kj::byte> data) KJ_WARN_UNUSED_RESULT;
 
   virtual kj::StringPtr jsgGetMemoryName() const = 0;
@@ -5,6 +5,7 @@
 #include "actor-cache.h"
 
 #include <workerd/api/actor-state.h>
+#include <workerd/api/crypto/keys.h>
 #include <workerd/api/global-scope.h>
 #include <workerd/api/sockets.h>
 #include <workerd/api/streams.h>  // for api::StreamEncoding
@@ -523,8 +524,15 @@ struct Worker::Isolate::Impl {
   kj::Maybe<std::unique_ptr<v8_inspector::V8Inspector>> inspector;
   InspectorPolicy inspectorPolicy;
   kj::Maybe<kj::Own<v8::CpuProfiler>> profiler;
+
+  // Profiler used by startSamplingProfiler(). Kept separate from `profiler` so that an inspector
+  // session can't stop or reconfigure it.
+  kj::Maybe<kj::Own<v8::CpuProfiler>> samplingProfiler;
   ActorCache::SharedLru actorCacheLru;
 
+  // Returned by getImportedKeyCache(). `mutable` because it is used through a const Isolate&.
+  mutable api::ImportedKeyCache importedKeyCache;
+
   // UUID for this isolate, initialized first time getUuid() is called.
   kj::Lazy<kj::String> uuid;
 
@@ -805,6 +813,62 @@ static void stopProfiling(jsg::Lock& js, v8::CpuProfiler& profiler, cdp::Command
   });
 }
 
+static constexpr kj::StringPtr SAMPLING_PROFILE_NAME = "Sampling Profile"_kj;
+
+static void startSamplingProfile(jsg::Lock& js, v8::CpuProfiler& profiler) {
+  js.withinHandleScope([&] {
+    // A sample limit of zero tells V8 not to record individual samples. The call tree, which is
+    // all we need for collapsed stacks, is still maintained.
+    v8::CpuProfilingOptions options(v8::kLeafNodeLineNumbers, 0);
+    profiler.StartProfiling(
+        jsg::v8StrIntern(js.v8Isolate, SAMPLING_PROFILE_NAME), kj::mv(options));
+  });
+}
+
+// Appends one collapsed-stack line for each node under `node` which was directly sampled.
+static void collapseProfileNode(
+    const v8::CpuProfileNode& node, kj::Vector<kj::String>& path, kj::Vector<kj::String>& lines) {
+  kj::StringPtr functionName = node.GetFunctionNameStr();
+  if (functionName.size() == 0) functionName = "(anonymous)"_kj;
+  kj::StringPtr url = node.GetScriptResourceNameStr();
+  auto frame = url.size() == 0
+      ? kj::str(functionName)
+      : kj::str(functionName, " (", url, ":", node.GetLineNumber(), ")");
+  // ';' separates frames in the collapsed format, so it must not appear within one.
+  for (char& c: frame) {
+    if (c == ';') c = ',';
+  }
+  path.add(kj::mv(frame));
+
+  if (node.GetHitCount() > 0) {
+    lines.add(kj::str(kj::strArray(path, ";"), " ", node.GetHitCount()));
+  }
+  for (int i = 0; i < node.GetChildrenCount(); i++) {
+    collapseProfileNode(*node.GetChild(i), path, lines);
+  }
+
+  path.removeLast();
+}
+
+static kj::String stopSamplingProfile(jsg::Lock& js, v8::CpuProfiler& profiler) {
+  return js.withinHandleScope([&]() -> kj::String {
+    auto cpuProfile =
+        profiler.StopProfiling(jsg::v8StrIntern(js.v8Isolate, SAMPLING_PROFILE_NAME));
+    if (cpuProfile == nullptr) return kj::str();
+    KJ_DEFER(cpuProfile->Delete());
+
+    kj::Vector<kj::String> path;
+    kj::Vector<kj::String> lines;
+    // The root node is synthetic, so start from its children.
+    auto root = cpuProfile->GetTopDownRoot();
+    for (int i = 0; i < root->GetChildrenCount(); i++) {
+      collapseProfileNode(*root->GetChild(i), path, lines);
+    }
+    if (lines.empty()) return kj::str();
+    return kj::str(kj::strArray(lines, "\n"), "\n");
+  });
+}
+
 }  // anonymous namespace
 
 struct Worker::Script::Impl {
@@ -1456,6 +1520,12 @@ const Worker::Isolate& Worker::Isolate::from(jsg::Lock& js) {
   return *static_cast<const Worker::Isolate*>(ptr);
 }
 
+kj::Maybe<const Worker::Isolate&> Worker::Isolate::tryFrom(jsg::Lock& js) {
+  auto ptr = js.v8Isolate->GetData(jsg::SET_DATA_ISOLATE);
+  if (ptr == nullptr) return kj::none;
+  return *static_cast<const Worker::Isolate*>(ptr);
+}
+
 bool Worker::Isolate::Impl::Lock::checkInWithLimitEnforcer(Worker::Isolate& isolate) {
   shouldReportIsolateMetrics = true;
   return limitEnforcer.exitJs(*lock);
@@ -1928,7 +1998,7 @@ void Worker::handleLog(jsg::Lock& js,
     auto& ioContext = IoContext::current();
     KJ_IF_SOME(tracer, ioContext.getWorkerTracer()) {
       auto timestamp = ioContext.now();
-      tracer.addLog(ioContext.getInvocationSpanContext(), timestamp, level, message());
+      tracer.addLog(ioContext.getInvocationSpanContext(), timestamp, level, message);
     }
   }
 
@@ -3980,6 +4050,10 @@ uint Worker::Isolate::getLockSuccessCount() const {
   return __atomic_load_n(&impl->lockSuccessCount, __ATOMIC_RELAXED);
 }
 
+api::ImportedKeyCache& Worker::Isolate::getImportedKeyCache() const {
+  return impl->importedKeyCache;
+}
+
 kj::Own<const Worker::Script> Worker::Isolate::newScript(kj::StringPtr scriptId,
     Script::Source source,
     IsolateObserver::StartType startType,
@@ -4000,6 +4074,59 @@ bool Worker::Isolate::isInspectorEnabled() const {
   return impl->inspector != kj::none;
 }
 
+kj::Promise<void> Worker::Isolate::startSamplingProfiler(kj::Duration samplingInterval) const {
+  auto asyncLock = co_await takeAsyncLockWithoutRequest(nullptr);
+  jsg::runInV8Stack([&](jsg::V8StackScope& stackScope) {
+    Isolate::Impl::Lock recordedLock(*this, asyncLock, stackScope);
+    auto& lock = *recordedLock.lock;
+    auto& samplingProfiler = const_cast<Impl&>(*impl).samplingProfiler;
+    if (samplingProfiler != kj::none) return;
+
+    auto profiler = kj::Own<v8::CpuProfiler>(
+        v8::CpuProfiler::New(lock.v8Isolate, v8::kDebugNaming, v8::kLazyLogging),
+        CpuProfilerDisposer::instance);
+    setSamplingInterval(*profiler, static_cast<int>(samplingInterval / kj::MICROSECONDS));
+    startSamplingProfile(lock, *profiler);
+    samplingProfiler = kj::mv(profiler);
+  });
+}
+
+kj::Promise<kj::String> Worker::Isolate::collectSamplingProfile(bool restart) const {
+  auto asyncLock = co_await takeAsyncLockWithoutRequest(nullptr);
+  co_return jsg::runInV8Stack([&](jsg::V8StackScope& stackScope) -> kj::String {
+    Isolate::Impl::Lock recordedLock(*this, asyncLock, stackScope);
+    auto& lock = *recordedLock.lock;
+    auto& samplingProfiler = const_cast<Impl&>(*impl).samplingProfiler;
+    auto& profiler = *KJ_UNWRAP_OR(samplingProfiler, return kj::str());
+
+    auto result = stopSamplingProfile(lock, profiler);
+    if (restart) {
+      startSamplingProfile(lock, profiler);
+    } else {
+      samplingProfiler = kj::none;
+    }
+    return result;
+  });
+}
+
+kj::Promise<Worker::Isolate::MemoryReport> Worker::Isolate::collectMemoryReport() const {
+  auto asyncLock = co_await takeAsyncLockWithoutRequest(nullptr);
+  co_return jsg::runInV8Stack([&](jsg::V8StackScope& stackScope) -> MemoryReport {
+    Isolate::Impl::Lock recordedLock(*this, asyncLock, stackScope);
+    auto& lock = *recordedLock.lock;
+
+    v8::HeapStatistics stats;
+    lock.v8Isolate->GetHeapStatistics(&stats);
+    return MemoryReport{
+      .usedHeapSize = stats.used_heap_size(),
+      .totalHeapSize = stats.total_heap_size(),
+      .externalMemory = stats.external_memory(),
+      .mallocedMemory = stats.malloced_memory(),
+      .nativeTypes = jsg::IsolateBase::from(lock.v8Isolate).getNativeMemoryUsage(),
+    };
+  });
+}
+
 namespace {
 
 // We only run the inspector within process sandboxes. There, it is safe to query the real clock
@@ -40,6 +40,7 @@ class DurableObjectStorage;
 class ServiceWorkerGlobalScope;
 struct ExportedHandler;
 struct CryptoAlgorithm;
+class ImportedKeyCache;
 struct QueueExportedHandler;
 class Socket;
 class WebSocket;
@@ -329,6 +330,10 @@ class Worker::Isolate: public kj::AtomicRefcounted {
   // Get the current Worker::Isolate from the current jsg::Lock
   static const Isolate& from(jsg::Lock& js);
 
+  // Like from(), but returns none if the lock doesn't belong to a Worker::Isolate, as in some unit
+  // tests.
+  static kj::Maybe<const Isolate&> tryFrom(jsg::Lock& js);
+
   inline IsolateObserver& getMetrics() {
     return *metrics;
   }
@@ -376,6 +381,9 @@ class Worker::Isolate: public kj::AtomicRefcounted {
   // Returns a count that is incremented upon every successful lock.
   uint getLockSuccessCount() const;
 
+  // Returns the cache of keys parsed by Web Crypto's importKey(). Requires the isolate lock.
+  api::ImportedKeyCache& getImportedKeyCache() const;
+
   // Accepts a connection to the V8 inspector and handles requests until the client disconnects.
   // Also adds a special JSON value to the header identified by `controlHeaderId`, for compatibility
   // with internal Cloudflare systems.
@@ -434,6 +442,35 @@ class Worker::Isolate: public kj::AtomicRefcounted {
 
   bool isInspectorEnabled() const;
 
+  // Starts a sampling CPU profiler on this isolate which, unlike the inspector's Profiler domain,
+  // is meant to be left running on production hosts. Only the aggregated call tree is kept, so
+  // memory use depends on the number of distinct stacks, not the number of samples. No-op if
+  // the sampling profiler is already running.
+  kj::Promise<void> startSamplingProfiler(kj::Duration samplingInterval) const;
+
+  // Returns the samples gathered since the sampling profiler was started or last collected, as
+  // collapsed stacks: one "outer;...;inner <count>" line per distinct stack, the format consumed
+  // by flamegraph.pl, speedscope and friends. If `restart` is true, sampling continues into a
+  // fresh profile, otherwise the profiler is shut down. Returns an empty string if the profiler
+  // is not running.
+  kj::Promise<kj::String> collectSamplingProfile(bool restart) const;
+
+  struct MemoryReport {
+    // From v8::HeapStatistics.
+    size_t usedHeapSize;
+    size_t totalHeapSize;
+    size_t externalMemory;
+    size_t mallocedMemory;
+
+    // Native objects reachable from JavaScript, grouped by type, largest retained size first.
+    kj::Array<jsg::NativeMemoryUsage> nativeTypes;
+  };
+
+  // Summarizes the isolate's memory use without taking a heap snapshot. This visits native
+  // objects in the same way as a heap snapshot but never walks the JavaScript heap, so it only
+  // holds the isolate lock briefly and is cheap enough to run periodically in production.
+  kj::Promise<MemoryReport> collectMemoryReport() const;
+
   // Represents a weak reference back to the isolate that code within the isolate can use as an
   // indirect pointer when they want to be able to race destruction safely. A caller wishing to
   // use a weak reference to the isolate should acquire a strong reference to weakIsolateRef.
@@ -29,9 +29,14 @@ AsyncContextFrame::AsyncContextFrame(Lock& js, StorageEntry storageEntry) {
     // Propagate the storage context of the current frame (if any).
     // If current(js) returns nullptr, we assume we're in the root
     // frame and there is no storage to propagate.
-    frame.storage.eraseAll([](const auto& entry) { return entry.key->isDead(); });
-    for (auto& entry: frame.storage) {
-      storage.insert(entry.clone(js));
+    if (frame.depth < MAX_DEPTH) {
+      parent = frame.addRef();
+      depth = frame.depth + 1;
+    } else {
+      // The chain is long enough. Start a new one so lookups don't have to walk any further, and
+      // so that frames which are no longer current can be collected.
+      frame.copyStorage(js, inherited);
+      inherited.eraseMatch(*storageEntry.key);
     }
   }
 
@@ -39,9 +44,7 @@ AsyncContextFrame::AsyncContextFrame(Lock& js, StorageEntry storageEntry) {
   // just out of an excess of caution.
   if (storageEntry.key->isDead()) return;
 
-  storage.upsert(kj::mv(storageEntry), [](StorageEntry& existing, StorageEntry&& row) mutable {
-    existing.value = kj::mv(row.value);
-  });
+  entry.emplace(kj::mv(storageEntry));
 }
 
 AsyncContextFrame::StorageEntry::StorageEntry(kj::Own<StorageKey> key, Value value)
@@ -149,8 +152,45 @@ v8::Local<v8::Function> AsyncContextFrame::wrapRoot(
 
 kj::Maybe<Value&> AsyncContextFrame::get(StorageKey& key) {
   KJ_ASSERT(!key.isDead());
-  storage.eraseAll([](const auto& entry) { return entry.key->isDead(); });
-  return storage.find(key).map([](auto& entry) -> Value& { return entry.value; });
+  return find(key).map([](StorageEntry& entry) -> Value& { return entry.value; });
+}
+
+kj::Maybe<AsyncContextFrame::StorageEntry&> AsyncContextFrame::find(StorageKey& key) {
+  AsyncContextFrame* frame = this;
+  for (;;) {
+    KJ_IF_SOME(e, frame->entry) {
+      if (e.key.get() == &key) return e;
+    }
+    KJ_IF_SOME(p, frame->parent) {
+      frame = p.get();
+    } else {
+      return frame->inherited.find(key);
+    }
+  }
+}
+
+void AsyncContextFrame::copyStorage(Lock& js, Storage& storage) {
+  // Entries closer to this frame shadow those further up the chain, so visit the chain in order
+  // and keep only the first entry seen for each key.
+  auto add = [&](StorageEntry& e) {
+    if (e.key->isDead()) return;
+    storage.findOrCreate(*e.key, [&]() { return e.clone(js); });
+  };
+
+  AsyncContextFrame* frame = this;
+  for (;;) {
+    KJ_IF_SOME(e, frame->entry) {
+      add(e);
+    }
+    KJ_IF_SOME(p, frame->parent) {
+      frame = p.get();
+    } else {
+      for (auto& e: frame->inherited) {
+        add(e);
+      }
+      return;
+    }
+  }
 }
 
 AsyncContextFrame::Scope::Scope(Lock& js, kj::Maybe<AsyncContextFrame&> resource)
@@ -187,8 +227,12 @@ v8::Local<v8::Object> AsyncContextFrame::getJSWrapper(Lock& js) {
 }
 
 void AsyncContextFrame::jsgVisitForGc(GcVisitor& visitor) {
-  for (auto& entry: storage) {
-    visitor.visit(entry.value);
+  KJ_IF_SOME(e, entry) {
+    visitor.visit(e.value);
+  }
+  visitor.visit(parent);
+  for (auto& e: inherited) {
+    visitor.visit(e.value);
   }
 }
 }  // namespace workerd::jsg
@@ -46,7 +46,11 @@ namespace workerd::jsg {
 //
 // All frames (except for the Root) are created within the scope of a parent, which by
 // default is whichever frame is current when the new frame is created. When the new frame
-// is created, it inherits a copy storage context of the parent.
+// is created, it inherits the storage context of the parent. Rather than copying it, the new
+// frame links to the parent and holds only the one value it adds, so creating a frame does
+// not depend on how many storage cells are live. Once a chain of linked frames reaches
+// MAX_DEPTH, the next frame copies the live cells of its ancestors instead of linking to
+// them, which keeps lookups short and lets superseded frames be collected.
 //
 // To implement all of this, however, we depend largely on an obscure v8 API on the
 // v8::Context object called SetContinuationPreservedEmbedderData and
@@ -77,10 +81,10 @@ class AsyncContextFrame final: public Wrappable {
     // The StorageKey is typically owned by an instance of AsyncLocalStorage (see
     // the api/node/async-hooks.h). When the ALS instance is garbage collected, it
     // must call reset to signal that this StorageKey is "dead" and can never be
-    // looked up again. Subsequent accesses to a frame will remove dead keys from
-    // the frame lazily. The lazy cleanup does mean that values may persist in
-    // memory a bit longer so if it proves to be problematic we can make the cleanup
-    // a bit more proactive.
+    // looked up again. Dead keys are not propagated to new frames, and are dropped
+    // lazily from existing ones when their storage is next copied. The lazy cleanup
+    // does mean that values may persist in memory a bit longer so if it proves to
+    // be problematic we can make the cleanup a bit more proactive.
     void reset() {
       dead = true;
     }
@@ -211,9 +215,13 @@ class AsyncContextFrame final: public Wrappable {
   }
   void jsgGetMemoryInfo(MemoryTracker& tracker) const override {
     Wrappable::jsgGetMemoryInfo(tracker);
-    tracker.trackField("storage", storage);
+    tracker.trackField("entry", entry);
+    tracker.trackField("inherited", inherited);
   }
 
+  // Maximum number of `parent` links between a frame and the end of its chain.
+  static constexpr uint MAX_DEPTH = 8;
+
  private:
   struct StorageEntryCallbacks {
     StorageKey& keyForRow(StorageEntry& entry) const {
@@ -230,7 +238,27 @@ class AsyncContextFrame final: public Wrappable {
   };
 
   using Storage = kj::Table<StorageEntry, kj::HashIndex<StorageEntryCallbacks>>;
-  Storage storage;
+
+  // The value set when this frame was created. Shadows any value for the same key in the
+  // frame's ancestors. None if the key was already dead.
+  kj::Maybe<StorageEntry> entry;
+
+  // The frame this one was created in, which holds the rest of this frame's storage context.
+  // None at the end of a chain.
+  kj::Maybe<Ref<AsyncContextFrame>> parent;
+
+  // Number of `parent` links from this frame to the end of its chain.
+  uint depth = 0;
+
+  // At the end of a chain, the storage context inherited from the frame this one was created in,
+  // copied rather than linked. Always empty if `parent` is set.
+  Storage inherited;
+
+  // Finds the entry for `key` in this frame's storage context.
+  kj::Maybe<StorageEntry&> find(StorageKey& key);
+
+  // Copies the live entries of this frame's storage context into `storage`.
+  void copyStorage(Lock& js, Storage& storage);
 
   void jsgVisitForGc(GcVisitor& visitor) override;
 
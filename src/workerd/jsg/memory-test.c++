@@ -100,5 +100,39 @@ KJ_TEST("MemoryTracker test") {
   });
 }
 
+KJ_TEST("MemoryTracker aggregates native memory without a snapshot") {
+  runTest([&](jsg::Lock& js, const TypeHandler<Ref<Foo>>& fooHandler) {
+    auto foo = fooHandler.wrap(js, js.alloc<Foo>());
+    auto foo2 = fooHandler.wrap(js, js.alloc<Foo>());
+    KJ_ASSERT(foo->IsObject() && foo2->IsObject());
+
+    auto usage = IsolateBase::from(js.v8Isolate).getNativeMemoryUsage();
+
+    kj::HashMap<kj::StringPtr, const NativeMemoryUsage*> byName;
+    for (auto& entry: usage) {
+      byName.insert(entry.name, &entry);
+    }
+
+    auto& isolateBase = *KJ_ASSERT_NONNULL(byName.find("IsolateBase"_kj));
+    KJ_EXPECT(isolateBase->count == 1);
+
+    auto& fooUsage = *KJ_ASSERT_NONNULL(byName.find("Foo"_kj));
+    KJ_EXPECT(fooUsage->count == 2);
+    KJ_EXPECT(fooUsage->selfSize == 2 * sizeof(Foo));
+    // Each Foo retains its four-character string.
+    KJ_EXPECT(fooUsage->retainedSize == 2 * (sizeof(Foo) + 4));
+
+    auto& strings = *KJ_ASSERT_NONNULL(byName.find("kj::String"_kj));
+    KJ_EXPECT(strings->count == 2);
+    KJ_EXPECT(strings->selfSize == 8);
+
+    // The root retains everything, so it sorts first.
+    KJ_EXPECT(usage[0].name == "IsolateBase");
+    for (auto& entry: usage) {
+      KJ_EXPECT(entry.retainedSize <= isolateBase->retainedSize);
+    }
+  });
+}
+
 }  // namespace
 }  // namespace workerd::jsg::test
@@ -4,6 +4,8 @@
 
 #include <kj/one-of.h>
 
+#include <algorithm>
+
 namespace workerd::jsg {
 
 class MemoryRetainerNode final: public v8::EmbedderGraph::Node {
@@ -60,7 +62,9 @@ class MemoryRetainerNode final: public v8::EmbedderGraph::Node {
 
   static v8::EmbedderGraph::Node* maybeWrapperNode(
       MemoryTracker* tracker, v8::Local<v8::Object> obj) {
-    if (!obj.IsEmpty()) return tracker->graph_->V8Node(obj.As<v8::Value>());
+    if (!obj.IsEmpty() && tracker->graph_ != nullptr) {
+      return tracker->graph_->V8Node(obj.As<v8::Value>());
+    }
     return nullptr;
   }
 
@@ -95,6 +99,10 @@ class MemoryRetainerNode final: public v8::EmbedderGraph::Node {
   v8::EmbedderGraph::Node::Detachedness detachedness_ =
       v8::EmbedderGraph::Node::Detachedness::kUnknown;
 
+  // Only used in aggregation mode.
+  MemoryRetainerNode* parent_ = nullptr;
+  size_t retainedSize_ = 0;
+
   friend class MemoryTracker;
 };
 
@@ -109,6 +117,28 @@ MemoryTracker::MemoryTracker(v8::Isolate* isolate, v8::EmbedderGraph* graph)
     : isolate_(isolate),
       graph_(graph) {}
 
+MemoryTracker::~MemoryTracker() noexcept(false) {}
+
+void MemoryTracker::addToGraph(MemoryRetainerNode* n, kj::Maybe<kj::StringPtr> edgeName) {
+  if (graph_ == nullptr) {
+    KJ_IF_SOME(currentNode, getCurrentNode(nodeStack_)) {
+      n->parent_ = &currentNode;
+    }
+    aggregatedNodes_.add(std::unique_ptr<MemoryRetainerNode>(n));
+    return;
+  }
+
+  graph_->AddNode(std::unique_ptr<v8::EmbedderGraph::Node>(n));
+
+  KJ_IF_SOME(currentNode, getCurrentNode(nodeStack_)) {
+    KJ_IF_SOME(name, edgeName) {
+      graph_->AddEdge(&currentNode, n, name.cStr());
+    } else {
+      graph_->AddEdge(&currentNode, n, nullptr);
+    }
+  }
+}
+
 MemoryRetainerNode* MemoryTracker::addNode(const void* retainer,
     const kj::StringPtr name,
     const size_t size,
@@ -122,17 +152,9 @@ MemoryRetainerNode* MemoryTracker::addNode(const void* retainer,
 
   MemoryRetainerNode* n = new MemoryRetainerNode(
       this, retainer, name, size, obj, kj::mv(checkIsRootNode), detachedness);
-  graph_->AddNode(std::unique_ptr<v8::EmbedderGraph::Node>(n));
+  addToGraph(n, edgeName);
   seen_.insert(retainer, n);
 
-  KJ_IF_SOME(currentNode, getCurrentNode(nodeStack_)) {
-    KJ_IF_SOME(name, edgeName) {
-      graph_->AddEdge(&currentNode, n, name.cStr());
-    } else {
-      graph_->AddEdge(&currentNode, n, nullptr);
-    }
-  }
-
   if (n->JSWrapperNode() != nullptr) {
     graph_->AddEdge(n, n->JSWrapperNode(), "native_to_javascript");
     graph_->AddEdge(n->JSWrapperNode(), n, "javascript_to_native");
@@ -144,16 +166,7 @@ MemoryRetainerNode* MemoryTracker::addNode(const void* retainer,
 MemoryRetainerNode* MemoryTracker::addNode(
     kj::StringPtr nodeName, size_t size, kj::Maybe<kj::StringPtr> edgeName) {
   MemoryRetainerNode* n = new MemoryRetainerNode(this, nodeName, size);
-  graph_->AddNode(std::unique_ptr<v8::EmbedderGraph::Node>(n));
-
-  KJ_IF_SOME(currentNode, getCurrentNode(nodeStack_)) {
-    KJ_IF_SOME(name, edgeName) {
-      graph_->AddEdge(&currentNode, n, name.cStr());
-    } else {
-      graph_->AddEdge(&currentNode, n, nullptr);
-    }
-  }
-
+  addToGraph(n, edgeName);
   return n;
 }
 
@@ -171,6 +184,7 @@ void MemoryTracker::decCurrentNodeSize(size_t size) {
 }
 
 void MemoryTracker::addEdge(v8::EmbedderGraph::Node* node, kj::StringPtr edgeName) {
+  if (graph_ == nullptr) return;
   KJ_IF_SOME(currentNode, getCurrentNode(nodeStack_)) {
     graph_->AddEdge(&currentNode, node, edgeName.cStr());
   } else {
@@ -179,6 +193,7 @@ void MemoryTracker::addEdge(v8::EmbedderGraph::Node* node, kj::StringPtr edgeNam
 }
 
 void MemoryTracker::addEdge(MemoryRetainerNode* node, kj::StringPtr edgeName) {
+  if (graph_ == nullptr) return;
   KJ_IF_SOME(currentNode, getCurrentNode(nodeStack_)) {
     graph_->AddEdge(&currentNode, node, edgeName.cStr());
   } else {
@@ -186,6 +201,36 @@ void MemoryTracker::addEdge(MemoryRetainerNode* node, kj::StringPtr edgeName) {
   }
 }
 
+kj::Array<NativeMemoryUsage> MemoryTracker::summarize() {
+  // Nodes are visited depth-first, so every node comes after its parent. Walking backwards,
+  // each node's retained size is complete by the time it is added to its parent's.
+  for (size_t i = aggregatedNodes_.size(); i > 0; --i) {
+    auto& node = *aggregatedNodes_[i - 1];
+    node.retainedSize_ += node.size_;
+    if (node.parent_ != nullptr) {
+      node.parent_->retainedSize_ += node.retainedSize_;
+    }
+  }
+
+  kj::HashMap<kj::StringPtr, NativeMemoryUsage> byName;
+  for (auto& node: aggregatedNodes_) {
+    auto& entry = byName.findOrCreate(node->name_, [&]() -> decltype(byName)::Entry {
+      return {node->name_,
+        NativeMemoryUsage{
+          .name = kj::str(node->name_), .count = 0, .selfSize = 0, .retainedSize = 0}};
+    });
+    entry.count++;
+    entry.selfSize += node->size_;
+    entry.retainedSize += node->retainedSize_;
+  }
+
+  auto result = KJ_MAP(entry, byName) { return kj::mv(entry.value); };
+  std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+    return a.retainedSize > b.retainedSize;
+  });
+  return result;
+}
+
 // ======================================================================================
 
 HeapSnapshotActivity::HeapSnapshotActivity(Callback callback): callback(kj::mv(callback)) {}
@@ -17,7 +17,9 @@
 #include <kj/map.h>
 #include <kj/string.h>
 #include <kj/table.h>
+#include <kj/vector.h>
 
+#include <memory>
 #include <stack>
 #include <string>
 
@@ -165,8 +167,30 @@ concept V8Value = requires(T a) { std::is_assignable_v<v8::Value, T>; };
   }                                                                                                \
   void jsgGetMemoryInfo(jsg::MemoryTracker& tracker) const
 
+// Summary of the native objects of one type found by a MemoryTracker in aggregation
+// mode (see IsolateBase::getNativeMemoryUsage()). `name` is the memory name of the
+// type, i.e. what jsgGetMemoryName() returns, or the node name of a field tracked
+// with trackFieldWithSize().
+struct NativeMemoryUsage {
+  kj::String name;
+  size_t count;
+
+  // Sum of the shallow sizes of all objects of this type.
+  size_t selfSize;
+
+  // Sum of the sizes of everything reachable from objects of this type, along the
+  // path by which the tracker first found each object. Objects of a type nested in
+  // another object of the same type are counted for both.
+  size_t retainedSize;
+};
+
 // jsg::MemoryTracker is used to construct the embedder graph for v8 heap
 // snapshot construction.
+//
+// It can also run without a graph, in which case it only aggregates the sizes of
+// the nodes it visits by name. This walks the same embedder objects as a heap
+// snapshot but never touches the V8 heap, so it is cheap enough to run
+// periodically in production.
 class MemoryTracker final {
  public:
   inline void trackFieldWithSize(
@@ -301,12 +325,24 @@ class MemoryTracker final {
 
  private:
   v8::Isolate* isolate_;
+
+  // Null when aggregating rather than building a graph.
   v8::EmbedderGraph* graph_;
   std::stack<MemoryRetainerNode*> nodeStack_;
   kj::HashMap<const void*, MemoryRetainerNode*> seen_;
+
+  // When aggregating, the nodes that would have been added to the graph, in the
+  // order they were visited.
+  kj::Vector<std::unique_ptr<MemoryRetainerNode>> aggregatedNodes_;
   KJ_DISALLOW_AS_COROUTINE_PARAM;
 
   explicit MemoryTracker(v8::Isolate* isolate, v8::EmbedderGraph* graph);
+  ~MemoryTracker() noexcept(false);
+
+  KJ_NOINLINE void addToGraph(MemoryRetainerNode* n, kj::Maybe<kj::StringPtr> edgeName);
+
+  // Groups the nodes visited in aggregation mode by name, largest retained size first.
+  kj::Array<NativeMemoryUsage> summarize();
 
   KJ_NOINLINE MemoryRetainerNode* addNode(const void* retainer,
       const kj::StringPtr name,
@@ -530,7 +566,7 @@ void MemoryTracker::trackField(
 template <V8Value T>
 void MemoryTracker::trackField(
     kj::StringPtr edgeName, const v8::Local<T>& value, kj::Maybe<kj::StringPtr> nodeName) {
-  if (!value.IsEmpty()) {
+  if (!value.IsEmpty() && graph_ != nullptr) {
     addEdge(graph_->V8Node(value.template As<v8::Value>()), edgeName);
   }
 }
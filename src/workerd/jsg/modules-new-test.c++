@@ -1899,5 +1899,56 @@ KJ_TEST("Using a deferred eval callback works") {
   });
 }
 
+// ======================================================================================
+
+struct CodeCacheObserver: public CompilationObserver {
+  mutable uint generated = 0;
+  mutable uint found = 0;
+
+  void onCompileCacheFound(v8::Isolate* isolate) const override {
+    ++found;
+  }
+  void onCompileCacheGenerated(v8::Isolate* isolate) const override {
+    ++generated;
+  }
+};
+
+KJ_TEST("Bundles with the same source and salt share the code cache") {
+  auto source = kj::str("export default 'sharing the code cache across bundles';");
+  CodeCacheObserver observer;
+
+  // Each call builds a fresh bundle and compiles its module in a fresh isolate, the way each
+  // service in a config gets its own.
+  auto compile = [&](kj::StringPtr salt) {
+    PREAMBLE(([&](Lock& js) {
+      ResolveObserver resolveObserver;
+      ModuleBundle::BundleBuilder bundleBuilder(BASE);
+      bundleBuilder.shareCodeCache(salt.asBytes());
+      bundleBuilder.addEsmModule("shared", source, Module::Flags::MAIN);
+      auto registry =
+          ModuleRegistry::Builder(resolveObserver, BASE).add(bundleBuilder.finish()).finish();
+      auto attached = registry->attachToIsolate(js, observer);
+
+      js.tryCatch([&] {
+        auto val = ModuleRegistry::resolve(js, "file:///shared");
+        KJ_ASSERT(val.isString());
+      }, [&](Value exception) { js.throwException(kj::mv(exception)); });
+    }));
+  };
+
+  compile("flags");
+  KJ_EXPECT(observer.generated == 1);
+  KJ_EXPECT(observer.found == 0);
+
+  compile("flags");
+  KJ_EXPECT(observer.generated == 1);
+  KJ_EXPECT(observer.found == 1);
+
+  // A different salt, e.g. different compatibility flags, does not share the entry.
+  compile("other flags");
+  KJ_EXPECT(observer.generated == 2);
+  KJ_EXPECT(observer.found == 1);
+}
+
 }  // namespace
 }  // namespace workerd::jsg::test
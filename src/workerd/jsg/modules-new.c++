@@ -10,6 +10,8 @@
 #include <workerd/jsg/jsg.h>
 #include <workerd/jsg/util.h>
 
+#include <openssl/sha.h>
+
 #include <kj/mutex.h>
 #include <kj/table.h>
 
@@ -67,10 +69,15 @@ constexpr ModuleBundle::Type toModuleBuilderType(ModuleBundle::BuiltinBuilder::T
 // The implementation of Module for ESM.
 class EsModule final: public Module {
  public:
-  explicit EsModule(Url specifier, Type type, Flags flags, kj::ArrayPtr<const char> source)
+  explicit EsModule(Url specifier,
+      Type type,
+      Flags flags,
+      kj::ArrayPtr<const char> source,
+      kj::Maybe<ModuleCodeCache::Key> sharedCacheKey = kj::none)
       : Module(kj::mv(specifier), type, flags | Flags::ESM | Flags::EVAL),
         source(source),
-        cachedData(kj::none) {
+        cachedData(kj::none),
+        sharedCacheKey(kj::mv(sharedCacheKey)) {
     KJ_DASSERT(isEsm());
   }
   // This variation does not take ownership of the source buffer.
@@ -102,11 +109,21 @@ class EsModule final: public Module {
       // reading and using the cached data without blocking each other
       // (which is fine since using the cache does not modify it).
       auto lock = cachedData.lockShared();
+      const v8::ScriptCompiler::CachedData* found = nullptr;
       KJ_IF_SOME(c, *lock) {
+        found = c.get();
+      } else KJ_IF_SOME(key, sharedCacheKey) {
+        // Another bundle with the same source may already have compiled this module. Entries in
+        // the shared cache are never removed, so the buffer outlives this compilation.
+        KJ_IF_SOME(c, ModuleCodeCache::get().find(key)) {
+          found = &c;
+        }
+      }
+      if (found != nullptr) {
         // We new new here because v8 will take ownership of the CachedData instance,
         // even tho we are maintaining ownership of the underlying buffer.
-        data = new v8::ScriptCompiler::CachedData(
-            c->data, c->length, v8::ScriptCompiler::CachedData::BufferPolicy::BufferNotOwned);
+        data = new v8::ScriptCompiler::CachedData(found->data, found->length,
+            v8::ScriptCompiler::CachedData::BufferPolicy::BufferNotOwned);
         auto check = data->CompatibilityCheck(js.v8Isolate);
         if (check != v8::ScriptCompiler::CachedData::kSuccess) {
           // The cached data is not compatible with the current isolate. Let's
@@ -152,13 +169,22 @@ class EsModule final: public Module {
     // acquire the lock and generate the cache. We'll test to see if the cached
     // data is still empty once the lock is acquired, and if it is not, we'll skip
     // generation.
+    //
+    // When the module shares its code cache, the generated data is published to the
+    // ModuleCodeCache instead, unless that is full.
     if (options == v8::ScriptCompiler::CompileOptions::kNoCompileOptions) {
       auto lock = cachedData.lockExclusive();
       if (*lock == kj::none) {
         if (auto ptr = v8::ScriptCompiler::CreateCodeCache(module->GetUnboundModuleScript())) {
           kj::Own<v8::ScriptCompiler::CachedData> cached(
               ptr, kj::_::HeapDisposer<v8::ScriptCompiler::CachedData>::instance);
-          *lock = kj::mv(cached);
+          KJ_IF_SOME(key, sharedCacheKey) {
+            KJ_IF_SOME(refused, ModuleCodeCache::get().add(key, kj::mv(cached))) {
+              *lock = kj::mv(refused);
+            }
+          } else {
+            *lock = kj::mv(cached);
+          }
           observer.onCompileCacheGenerated(js.v8Isolate);
         } else {
           observer.onCompileCacheGenerationFailed(js.v8Isolate);
@@ -195,6 +221,8 @@ class EsModule final: public Module {
   // When externed is true, the source buffer is passed into the isolate as an externalized
   // string. This is only appropriate for built-in modules that are compiled into the binary.
   kj::MutexGuarded<kj::Maybe<kj::Own<v8::ScriptCompiler::CachedData>>> cachedData;
+  // Set when the code cache is shared through ModuleCodeCache rather than kept in `cachedData`.
+  kj::Maybe<ModuleCodeCache::Key> sharedCacheKey;
 };
 
 // A SyntheticModule is essentially any type of module that is not backed by an ESM
@@ -1061,6 +1089,52 @@ void ModuleBundle::Builder::ensureIsNotBundleSpecifier(const Url& specifier) {
 
 // ======================================================================================
 
+ModuleCodeCache::Key ModuleCodeCache::keyFor(
+    const Url& specifier, kj::ArrayPtr<const char> source, kj::ArrayPtr<const kj::byte> salt) {
+  SHA256_CTX ctx;
+  SHA256_Init(&ctx);
+  // Prefix each part with its length so that different splits of the same bytes differ.
+  auto update = [&](kj::ArrayPtr<const kj::byte> part) {
+    uint64_t size = part.size();
+    SHA256_Update(&ctx, &size, sizeof(size));
+    SHA256_Update(&ctx, part.begin(), part.size());
+  };
+  update(specifier.getHref().asBytes());
+  update(source.asBytes());
+  update(salt);
+
+  Key key;
+  static_assert(sizeof(key) == SHA256_DIGEST_LENGTH);
+  SHA256_Final(key.begin(), &ctx);
+  return key;
+}
+
+kj::Maybe<const v8::ScriptCompiler::CachedData&> ModuleCodeCache::find(const Key& key) const {
+  auto lock = state.lockShared();
+  KJ_IF_SOME(entry, lock->entries.find(key)) {
+    return *entry.data;
+  }
+  return kj::none;
+}
+
+kj::Maybe<kj::Own<v8::ScriptCompiler::CachedData>> ModuleCodeCache::add(
+    const Key& key, kj::Own<v8::ScriptCompiler::CachedData> data) const {
+  auto lock = state.lockExclusive();
+  if (lock->entries.find(key) != kj::none) return kj::none;
+  size_t size = data->length;
+  if (lock->totalSize + size > MAX_TOTAL_SIZE) return kj::mv(data);
+  lock->totalSize += size;
+  lock->entries.insert(Entry{.key = key, .data = kj::mv(data)});
+  return kj::none;
+}
+
+const ModuleCodeCache& ModuleCodeCache::get() {
+  static const ModuleCodeCache instance;
+  return instance;
+}
+
+// ======================================================================================
+
 ModuleBundle::BundleBuilder::BundleBuilder(const jsg::Url& bundleBase)
     : ModuleBundle::Builder(Type::BUNDLE),
       bundleBase(bundleBase) {}
@@ -1086,15 +1160,32 @@ ModuleBundle::BundleBuilder& ModuleBundle::BundleBuilder::addEsmModule(
   auto url = KJ_ASSERT_NONNULL(bundleBase.tryResolve(specifier));
   // Make sure that percent-encoding in the path is normalized so we can match correctly.
   url = url.clone(Url::EquivalenceOption::NORMALIZE_PATH);
+  kj::Maybe<kj::Array<kj::byte>> salt;
+  KJ_IF_SOME(s, codeCacheSalt) {
+    salt = kj::heapArray<kj::byte>(s);
+  }
   add(url,
-      [url = url.clone(), source, flags, type = type()](const ResolveContext& context) mutable
+      [url = url.clone(), source, flags, type = type(), salt = kj::mv(salt)](
+          const ResolveContext& context) mutable
       -> kj::Maybe<kj::OneOf<kj::String, kj::Own<Module>>> {
-    kj::Own<Module> mod = kj::heap<EsModule>(kj::mv(url), type, flags, source);
+    // The key is computed here rather than up front so that modules which are never imported
+    // are never hashed.
+    kj::Maybe<ModuleCodeCache::Key> key;
+    KJ_IF_SOME(s, salt) {
+      key = ModuleCodeCache::keyFor(url, source, s);
+    }
+    kj::Own<Module> mod = kj::heap<EsModule>(kj::mv(url), type, flags, source, kj::mv(key));
     return kj::Maybe<kj::OneOf<kj::String, kj::Own<Module>>>(kj::mv(mod));
   });
   return *this;
 }
 
+ModuleBundle::BundleBuilder& ModuleBundle::BundleBuilder::shareCodeCache(
+    kj::ArrayPtr<const kj::byte> salt) {
+  codeCacheSalt = kj::heapArray(salt);
+  return *this;
+}
+
 ModuleBundle::BundleBuilder& ModuleBundle::BundleBuilder::alias(
     kj::StringPtr alias, kj::StringPtr specifier) {
   auto aliasUrl = KJ_ASSERT_NONNULL(bundleBase.tryResolve(alias));
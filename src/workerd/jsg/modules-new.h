@@ -18,6 +18,7 @@
 #include <kj/common.h>
 #include <kj/function.h>
 #include <kj/map.h>
+#include <kj/mutex.h>
 #include <kj/refcount.h>
 #include <kj/table.h>
 
@@ -424,6 +425,59 @@ constexpr Module::Flags operator|(const Module::Flags& a, const Module::Flags& b
   return static_cast<Module::Flags>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b));
 }
 
+// A process-wide, content-addressed cache of V8 code cache data for ESM modules from worker
+// bundles. Each worker's ModuleBundle has its own Module instances, so without this a config with
+// many services built from the same bundle would compile every module once per service. With
+// it, the first service to compile a module publishes its code cache, and the rest deserialize it.
+//
+// Entries are keyed by a SHA-256 digest of the module specifier, the source text, and a salt
+// provided by the embedder covering anything else that affects compilation (such as
+// compatibility flags). Like CompileCache, entries are never removed or replaced, so references
+// returned by `find()` remain valid for the life of the process. Once `MAX_TOTAL_SIZE` bytes are
+// cached, further entries are refused and modules fall back to their own per-module cache.
+class ModuleCodeCache final {
+ public:
+  static constexpr size_t MAX_TOTAL_SIZE = 256 * 1024 * 1024;
+
+  using Key = kj::FixedArray<kj::byte, 32>;
+
+  static Key keyFor(const Url& specifier,
+      kj::ArrayPtr<const char> source,
+      kj::ArrayPtr<const kj::byte> salt);
+
+  kj::Maybe<const v8::ScriptCompiler::CachedData&> find(const Key& key) const;
+
+  // If an entry for `key` already exists, it is kept and `data` is dropped. If the cache is full,
+  // `data` is handed back so the caller can keep it for itself.
+  kj::Maybe<kj::Own<v8::ScriptCompiler::CachedData>> add(
+      const Key& key, kj::Own<v8::ScriptCompiler::CachedData> data) const;
+
+  static const ModuleCodeCache& get();
+
+ private:
+  struct Entry {
+    Key key;
+    kj::Own<v8::ScriptCompiler::CachedData> data;
+  };
+  struct KeyCallbacks {
+    const Key& keyForRow(const Entry& entry) const {
+      return entry.key;
+    }
+    bool matches(const Entry& entry, const Key& key) const {
+      return entry.key.asPtr() == key.asPtr();
+    }
+    uint hashCode(const Key& key) const {
+      // The key is already a cryptographic hash, so any four bytes of it will do.
+      return key[0] | (key[1] << 8) | (key[2] << 16) | (static_cast<uint>(key[3]) << 24);
+    }
+  };
+  struct State {
+    kj::Table<Entry, kj::HashIndex<KeyCallbacks>> entries;
+    size_t totalSize = 0;
+  };
+  kj::MutexGuarded<State> state;
+};
+
 // A ModuleBundle is a source of modules that can be imported or required.
 // A ModuleRegistry is a collection of ModuleBundles.
 // Importantly, a ModuleBundle is immutable once created with exception to
@@ -484,8 +538,14 @@ class ModuleBundle {
 
     BundleBuilder& alias(kj::StringPtr alias, kj::StringPtr specifier) KJ_LIFETIMEBOUND;
 
+    // Shares the code cache of ESM modules added after this call with other bundles that contain
+    // the same sources and use the same `salt`, via ModuleCodeCache. `salt` must cover anything
+    // besides the source text that affects how modules compile.
+    BundleBuilder& shareCodeCache(kj::ArrayPtr<const kj::byte> salt) KJ_LIFETIMEBOUND;
+
    private:
     const jsg::Url& bundleBase;
+    kj::Maybe<kj::Array<kj::byte>> codeCacheSalt;
   };
 
   // Used to build a ModuleBundle representing modules sources from the runtime.
@@ -225,6 +225,12 @@ void IsolateBase::jsgGetMemoryInfo(MemoryTracker& tracker) const {
   tracker.trackField("heapTracer", heapTracer);
 }
 
+kj::Array<NativeMemoryUsage> IsolateBase::getNativeMemoryUsage() {
+  MemoryTracker tracker(ptr, nullptr);
+  tracker.track(this);
+  return tracker.summarize();
+}
+
 void IsolateBase::deferDestruction(Item item) {
   queue.lockExclusive()->push(kj::mv(item));
 }
@@ -214,6 +214,10 @@ class IsolateBase {
     return true;
   }
 
+  // Walks the native objects reachable from this isolate, as a heap snapshot would, and
+  // summarizes them by type without building a snapshot. Must be called with the isolate locked.
+  kj::Array<NativeMemoryUsage> getNativeMemoryUsage();
+
   // Get an object referencing this isolate that can be used to adjust external memory usage later
   kj::Arc<const ExternalMemoryTarget> getExternalMemoryTarget();
 
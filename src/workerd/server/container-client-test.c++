@@ -0,0 +1,258 @@
+// Copyright (c) 2025 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "container-client.h"
+
+#include <kj/async-io.h>
+#include <kj/compat/http.h>
+#include <kj/map.h>
+#include <kj/test.h>
+
+namespace workerd::server {
+namespace {
+
+// Minimal stand-in for the Docker Engine API, implementing just enough of the container
+// lifecycle endpoints for ContainerPool to work against it.
+class FakeDockerService final: public kj::HttpService {
+ public:
+  FakeDockerService(kj::HttpHeaderTable& headerTable): headerTable(headerTable) {}
+
+  kj::Vector<kj::String> calls;
+  kj::HashSet<kj::String> containers;
+  kj::HashSet<kj::String> running;
+
+  kj::Promise<void> request(kj::HttpMethod method,
+      kj::StringPtr url,
+      const kj::HttpHeaders& headers,
+      kj::AsyncInputStream& requestBody,
+      Response& response) override {
+    co_await requestBody.readAllBytes();
+    calls.add(kj::str(method, " ", url));
+
+    uint status = 404;
+    if (method == kj::HttpMethod::POST && url.startsWith("/containers/create?name=")) {
+      auto name = kj::str(url.slice(strlen("/containers/create?name=")));
+      if (containers.contains(name)) {
+        status = 409;
+      } else {
+        containers.insert(kj::mv(name));
+        status = 201;
+      }
+    } else KJ_IF_SOME(rest, stripPrefix(url, "/containers/")) {
+      size_t end = 0;
+      while (end < rest.size() && rest[end] != '/' && rest[end] != '?') ++end;
+      auto name = kj::str(rest.slice(0, end));
+      auto action = rest.slice(end);
+      if (!containers.contains(name)) {
+        status = 404;
+      } else if (method == kj::HttpMethod::DELETE) {
+        containers.erase(name);
+        running.erase(name);
+        status = 204;
+      } else if (action == "/start") {
+        status = running.contains(name) ? 304 : 204;
+        if (!running.contains(name)) running.insert(kj::mv(name));
+      } else if (action.startsWith("/rename?name=")) {
+        auto newName = kj::str(action.slice(strlen("/rename?name=")));
+        if (running.contains(name)) {
+          running.erase(name);
+          running.insert(kj::str(newName));
+        }
+        containers.erase(name);
+        containers.insert(kj::mv(newName));
+        status = 204;
+      } else {
+        status = 200;
+      }
+    }
+
+    kj::HttpHeaders responseHeaders(headerTable);
+    auto body = "{}"_kj;
+    auto stream = response.send(status, "", responseHeaders, body.size());
+    co_await stream->write(body.asBytes());
+  }
+
+ private:
+  kj::HttpHeaderTable& headerTable;
+
+  static kj::Maybe<kj::StringPtr> stripPrefix(kj::StringPtr str, kj::StringPtr prefix) {
+    if (str.startsWith(prefix)) return str.slice(prefix.size());
+    return kj::none;
+  }
+};
+
+struct FakeDockerServer {
+  FakeDockerServer(kj::AsyncIoContext& io)
+      : service(headerTable),
+        listener(
+            io.provider->getNetwork().parseAddress("127.0.0.1", 0).wait(io.waitScope)->listen()),
+        server(io.provider->getTimer(), headerTable, service),
+        serverTask(server.listenHttp(*listener).eagerlyEvaluate(nullptr)) {}
+
+  kj::String address() {
+    return kj::str("127.0.0.1:", listener->getPort());
+  }
+
+  kj::HttpHeaderTable headerTable;
+  FakeDockerService service;
+  kj::Own<kj::ConnectionReceiver> listener;
+  kj::HttpServer server;
+  kj::Promise<void> serverTask;
+};
+
+struct LoggingErrorHandler final: public kj::TaskSet::ErrorHandler {
+  void taskFailed(kj::Exception&& exception) override {
+    KJ_FAIL_EXPECT(exception);
+  }
+};
+
+KJ_TEST("DockerApiClient reuses its connection to the Docker socket") {
+  auto io = kj::setupAsyncIo();
+  FakeDockerServer fake(io);
+  auto docker = kj::refcounted<DockerApiClient>(
+      io.provider->getTimer(), io.provider->getNetwork(), fake.address());
+
+  for (auto i: kj::zeroTo(5)) {
+    auto response = docker->request(kj::HttpMethod::GET, kj::str("/containers/c", i, "/json"))
+                        .wait(io.waitScope);
+    KJ_EXPECT(response.statusCode == 404);
+  }
+
+  KJ_EXPECT(fake.service.calls.size() == 5);
+  KJ_EXPECT(docker->getConnectionCount() == 1);
+}
+
+KJ_TEST("ContainerPool pre-creates, hands out, and refills warm containers") {
+  auto io = kj::setupAsyncIo();
+  FakeDockerServer fake(io);
+  LoggingErrorHandler errorHandler;
+  kj::TaskSet waitUntilTasks(errorHandler);
+
+  auto docker = kj::refcounted<DockerApiClient>(
+      io.provider->getTimer(), io.provider->getNetwork(), fake.address());
+  auto pool = kj::refcounted<ContainerPool>(kj::addRef(*docker), kj::str("pool-"),
+      kj::str("image"), ContainerPool::Options{.size = 2, .prestart = true}, waitUntilTasks);
+
+  pool->fill();
+  pool->whenIdle().wait(io.waitScope);
+  KJ_EXPECT(pool->getStats().ready == 2);
+  KJ_EXPECT(fake.service.running.contains("pool-0"));
+  KJ_EXPECT(fake.service.running.contains("pool-1"));
+
+  KJ_EXPECT(pool->claim("actor").wait(io.waitScope));
+  KJ_EXPECT(fake.service.running.contains("actor"));
+  KJ_EXPECT(!fake.service.containers.contains("pool-1") ||
+      !fake.service.containers.contains("pool-0"));
+
+  // The claimed slot is refilled in the background.
+  pool->whenIdle().wait(io.waitScope);
+  KJ_EXPECT(pool->getStats().ready == 2);
+  KJ_EXPECT(fake.service.running.contains("pool-2"));
+
+  // Connections are only opened for concurrent requests, never one per call.
+  KJ_EXPECT(docker->getConnectionCount() <= 2);
+}
+
+KJ_TEST("ContainerPool without prestart starts the container on claim") {
+  auto io = kj::setupAsyncIo();
+  FakeDockerServer fake(io);
+  LoggingErrorHandler errorHandler;
+  kj::TaskSet waitUntilTasks(errorHandler);
+
+  auto docker = kj::refcounted<DockerApiClient>(
+      io.provider->getTimer(), io.provider->getNetwork(), fake.address());
+  auto pool = kj::refcounted<ContainerPool>(kj::addRef(*docker), kj::str("pool-"),
+      kj::str("image"), ContainerPool::Options{.size = 1, .prestart = false}, waitUntilTasks);
+
+  // Nothing to hand out before the pool is filled.
+  KJ_EXPECT(!pool->claim("actor").wait(io.waitScope));
+
+  pool->fill();
+  pool->whenIdle().wait(io.waitScope);
+  KJ_EXPECT(fake.service.containers.contains("pool-0"));
+  KJ_EXPECT(!fake.service.running.contains("pool-0"));
+
+  KJ_EXPECT(pool->claim("actor").wait(io.waitScope));
+  KJ_EXPECT(fake.service.running.contains("actor"));
+
+  pool->recordStart(10 * kj::MILLISECONDS, true);
+  pool->recordStart(500 * kj::MILLISECONDS, false);
+  pool->recordStart(20 * kj::MILLISECONDS, true);
+  auto stats = pool->getStats();
+  KJ_EXPECT(stats.warm.count == 2);
+  KJ_EXPECT(stats.warm.total == 30 * kj::MILLISECONDS);
+  KJ_EXPECT(stats.warm.max == 20 * kj::MILLISECONDS);
+  KJ_EXPECT(stats.cold.count == 1);
+
+  // Unclaimed warm containers are removed when the pool goes away.
+  pool->whenIdle().wait(io.waitScope);
+  pool = nullptr;
+  waitUntilTasks.onEmpty().wait(io.waitScope);
+  KJ_EXPECT(!fake.service.containers.contains("pool-1"));
+}
+
+KJ_TEST("ContainerPool removes containers that were still being created when it went away") {
+  auto io = kj::setupAsyncIo();
+  FakeDockerServer fake(io);
+  LoggingErrorHandler errorHandler;
+  kj::TaskSet waitUntilTasks(errorHandler);
+
+  auto docker = kj::refcounted<DockerApiClient>(
+      io.provider->getTimer(), io.provider->getNetwork(), fake.address());
+  auto pool = kj::refcounted<ContainerPool>(kj::addRef(*docker), kj::str("pool-"),
+      kj::str("image"), ContainerPool::Options{.size = 2, .prestart = true}, waitUntilTasks);
+
+  pool->fill();
+  KJ_EXPECT(pool->getStats().pending == 2);
+  pool = nullptr;
+
+  waitUntilTasks.onEmpty().wait(io.waitScope);
+  KJ_EXPECT(fake.service.calls.size() > 0);
+  KJ_EXPECT(fake.service.containers.size() == 0);
+  KJ_EXPECT(fake.service.running.size() == 0);
+}
+
+KJ_TEST("ContainerPool renders its stats for Prometheus") {
+  auto io = kj::setupAsyncIo();
+  FakeDockerServer fake(io);
+  LoggingErrorHandler errorHandler;
+  kj::TaskSet waitUntilTasks(errorHandler);
+
+  auto docker = kj::refcounted<DockerApiClient>(
+      io.provider->getTimer(), io.provider->getNetwork(), fake.address());
+  auto pool = kj::refcounted<ContainerPool>(kj::addRef(*docker), kj::str("pool-"),
+      kj::str("image"), ContainerPool::Options{.size = 2, .prestart = false}, waitUntilTasks);
+  pool->fill();
+  pool->whenIdle().wait(io.waitScope);
+  pool->recordStart(250 * kj::MILLISECONDS, true);
+  pool->recordStart(2 * kj::SECONDS, false);
+
+  kj::Vector<kj::String> lines;
+  ContainerPool::NamedPool pools[] = {{"ns", *pool}};
+  ContainerPool::renderPrometheus(lines, pools);
+
+  auto text = kj::strArray(lines, "\n");
+  auto hasLine = [&](kj::StringPtr expected) {
+    for (auto& line: lines) {
+      if (line == expected) return true;
+    }
+    return false;
+  };
+  KJ_EXPECT(text.contains("# TYPE workerd_container_pool_ready gauge\n"
+                          "workerd_container_pool_ready{namespace=\"ns\"} 2\n"),
+      text);
+  KJ_EXPECT(hasLine("workerd_container_pool_pending{namespace=\"ns\"} 0"), text);
+  KJ_EXPECT(hasLine("# TYPE workerd_container_start_seconds summary"), text);
+  KJ_EXPECT(
+      hasLine("workerd_container_start_seconds_count{namespace=\"ns\",start=\"warm\"} 1"), text);
+  KJ_EXPECT(
+      hasLine("workerd_container_start_seconds_sum{namespace=\"ns\",start=\"warm\"} 0.25"), text);
+  KJ_EXPECT(
+      hasLine("workerd_container_start_seconds_count{namespace=\"ns\",start=\"cold\"} 1"), text);
+  KJ_EXPECT(
+      hasLine("workerd_container_start_max_seconds{namespace=\"ns\",start=\"cold\"} 2"), text);
+}
+
+}  // namespace
+}  // namespace workerd::server
@@ -7,6 +7,7 @@
 #include <workerd/io/container.capnp.h>
 #include <workerd/jsg/jsg.h>
 #include <workerd/server/docker-api.capnp.h>
+#include <workerd/server/runtime-metrics.h>
 
 #include <capnp/compat/json.h>
 #include <capnp/message.h>
@@ -21,6 +22,11 @@
 namespace workerd::server {
 
 namespace {
+
+double toSeconds(kj::Duration duration) {
+  return static_cast<double>(duration / kj::NANOSECONDS) / 1e9;
+}
+
 kj::StringPtr signalToString(uint32_t signal) {
   switch (signal) {
     case 1:
@@ -101,25 +107,392 @@ typename T::Builder decodeJsonResponse(kj::StringPtr response) {
   return jsonRoot;
 }
 
+namespace {
+constexpr kj::StringPtr defaultEnv[] = {"CLOUDFLARE_COUNTRY_A2=XX"_kj,
+  "CLOUDFLARE_DEPLOYMENT_ID=xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"_kj,
+  "CLOUDFLARE_LOCATION=loc01"_kj, "CLOUDFLARE_REGION=REGN"_kj,
+  "CLOUDFLARE_APPLICATION_ID=xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"_kj,
+  "CLOUDFLARE_DURABLE_OBJECT_ID=xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"_kj};
+
+// Destroys the container.
+// No-op when the container does not exist.
+// Wait for the container to actually be stopped and removed when it exists.
+kj::Promise<void> destroyContainer(DockerApiClient& docker, kj::StringPtr containerName) {
+  auto response = co_await docker.request(
+      kj::HttpMethod::DELETE, kj::str("/containers/", containerName, "?force=true"));
+  // statusCode 204 refers to "no error"
+  // statusCode 404 refers to "no such container"
+  // Both of which are fine for us since we're tearing down the container anyway.
+  JSG_REQUIRE(response.statusCode == 204 || response.statusCode == 404, Error,
+      "Removing a container failed with: ", response.body);
+  // Do not send a wait request if container doesn't exist. This avoids sending an
+  // unnecessary request.
+  if (response.statusCode == 204) {
+    response = co_await docker.request(
+        kj::HttpMethod::POST, kj::str("/containers/", containerName, "/wait?condition=removed"));
+    JSG_REQUIRE(response.statusCode == 200 || response.statusCode == 404, Error,
+        "Waiting for container removal failed with: ", response.statusCode, response.body);
+  }
+}
+
+kj::Promise<void> createContainer(DockerApiClient& docker,
+    kj::StringPtr containerName,
+    kj::StringPtr imageName,
+    kj::Maybe<capnp::List<capnp::Text>::Reader> entrypoint,
+    kj::Maybe<capnp::List<capnp::Text>::Reader> environment) {
+  // Docker API: POST /containers/create
+  capnp::JsonCodec codec;
+  codec.handleByAnnotation<docker_api::Docker::ContainerCreateRequest>();
+  capnp::MallocMessageBuilder message;
+  auto jsonRoot = message.initRoot<docker_api::Docker::ContainerCreateRequest>();
+  jsonRoot.setImage(imageName);
+  // Add entrypoint if provided
+  KJ_IF_SOME(ep, entrypoint) {
+    auto jsonCmd = jsonRoot.initCmd(ep.size());
+    for (uint32_t i: kj::zeroTo(ep.size())) {
+      jsonCmd.set(i, ep[i]);
+    }
+  }
+
+  auto envSize = environment.map([](auto& env) { return env.size(); }).orDefault(0);
+  auto jsonEnv = jsonRoot.initEnv(envSize + kj::size(defaultEnv));
+
+  KJ_IF_SOME(env, environment) {
+    for (uint32_t i: kj::zeroTo(env.size())) {
+      jsonEnv.set(i, env[i]);
+    }
+  }
+
+  for (uint32_t i: kj::zeroTo(kj::size(defaultEnv))) {
+    jsonEnv.set(envSize + i, defaultEnv[i]);
+  }
+
+  auto hostConfig = jsonRoot.initHostConfig();
+  // We need to publish all ports to properly get the mapped port number locally
+  hostConfig.setPublishAllPorts(true);
+  // We need to set a restart policy to avoid having ambiguous states
+  // where the container we're managing is stuck at "exited" state.
+  hostConfig.initRestartPolicy().setName("on-failure");
+
+  auto response = co_await docker.request(kj::HttpMethod::POST,
+      kj::str("/containers/create?name=", containerName), codec.encode(jsonRoot));
+
+  // statusCode 409 refers to "conflict". Occurs when a container with the given name exists.
+  // In that case we destroy and re-create the container.
+  if (response.statusCode == 409) {
+    co_await destroyContainer(docker, containerName);
+    response = co_await docker.request(kj::HttpMethod::POST,
+        kj::str("/containers/create?name=", containerName), codec.encode(jsonRoot));
+  }
+
+  // statusCode 201 refers to "container created successfully"
+  if (response.statusCode != 201) {
+    JSG_REQUIRE(response.statusCode != 404, Error, "No such image available named ", imageName);
+    JSG_REQUIRE(response.statusCode != 409, Error, "Container already exists");
+    JSG_FAIL_REQUIRE(
+        Error, "Create container failed with [", response.statusCode, "] ", response.body);
+  }
+}
+
+kj::Promise<void> startContainer(DockerApiClient& docker, kj::StringPtr containerName) {
+  // Docker API: POST /containers/{id}/start
+  // We have to send an empty body since docker API will throw an error if we don't.
+  auto response = co_await docker.request(
+      kj::HttpMethod::POST, kj::str("/containers/", containerName, "/start"), kj::str(""));
+  // statusCode 304 refers to "container already started"
+  JSG_REQUIRE(response.statusCode != 304, Error, "Container already started");
+  // statusCode 204 refers to "no error"
+  JSG_REQUIRE(response.statusCode == 204, Error, "Starting container failed with: ", response.body);
+}
+
+// Creates a warm container, and starts it if `prestart` is true. This holds everything it needs,
+// so that it can run to completion even if the pool that asked for the container is destroyed.
+kj::Promise<void> buildWarmContainer(
+    kj::Own<DockerApiClient> docker, kj::String name, kj::String imageName, bool prestart) {
+  co_await createContainer(*docker, name, imageName, kj::none, kj::none);
+  if (prestart) {
+    co_await startContainer(*docker, name);
+  }
+}
+}  // namespace
+
+// =======================================================================================
+// DockerApiClient
+
+// Wraps the resolved Docker socket address so we can tell how many connections the pooled
+// HttpClient actually opens.
+class DockerApiClient::CountingAddress final: public kj::NetworkAddress {
+ public:
+  CountingAddress(DockerApiClient& client, kj::Own<kj::NetworkAddress> inner)
+      : client(client),
+        inner(kj::mv(inner)) {}
+
+  kj::Promise<kj::Own<kj::AsyncIoStream>> connect() override {
+    ++client.connectionCount;
+    return inner->connect();
+  }
+  kj::Own<kj::ConnectionReceiver> listen() override {
+    return inner->listen();
+  }
+  kj::Own<kj::NetworkAddress> clone() override {
+    return kj::heap<CountingAddress>(client, inner->clone());
+  }
+  kj::String toString() override {
+    return inner->toString();
+  }
+
+ private:
+  DockerApiClient& client;
+  kj::Own<kj::NetworkAddress> inner;
+};
+
+DockerApiClient::DockerApiClient(kj::Timer& timer, kj::Network& network, kj::String dockerPath)
+    : timer(timer),
+      network(network),
+      dockerPath(kj::mv(dockerPath)) {}
+
+kj::Promise<void> DockerApiClient::resolve() {
+  auto parsed = co_await network.parseAddress(dockerPath);
+  auto& addr = *address.emplace(kj::heap<CountingAddress>(*this, kj::mv(parsed)));
+  // The address-bound client keeps idle connections open and reuses them for subsequent
+  // requests. Requests issued while all connections are busy (e.g. a long-polling `/wait`) get a
+  // connection of their own.
+  httpClient = kj::newHttpClient(timer, headerTable, addr);
+}
+
+kj::Promise<void> DockerApiClient::ensureResolved() {
+  if (httpClient != kj::none) co_return;
+
+  if (resolveTask == kj::none) {
+    resolveTask = resolve().fork();
+  }
+  try {
+    co_await KJ_ASSERT_NONNULL(resolveTask).addBranch();
+  } catch (...) {
+    // Allow the next request to retry resolution rather than failing forever.
+    resolveTask = kj::none;
+    throw;
+  }
+}
+
+kj::Promise<DockerApiClient::Response> DockerApiClient::request(
+    kj::HttpMethod method, kj::String endpoint, kj::Maybe<kj::String> body) {
+  co_await ensureResolved();
+  auto& client = *KJ_ASSERT_NONNULL(httpClient);
+
+  kj::HttpHeaders headers(headerTable);
+  headers.set(kj::HttpHeaderId::HOST, "localhost");
+
+  KJ_IF_SOME(requestBody, body) {
+    headers.set(kj::HttpHeaderId::CONTENT_TYPE, "application/json");
+    headers.set(kj::HttpHeaderId::CONTENT_LENGTH, kj::str(requestBody.size()));
+
+    auto req = client.request(method, endpoint, headers, requestBody.size());
+    {
+      auto body = kj::mv(req.body);
+      co_await body->write(requestBody.asBytes());
+    }
+    auto response = co_await req.response;
+    // The body must be read to completion for the connection to be returned to the pool.
+    auto result = co_await response.body->readAllText();
+    co_return Response{.statusCode = response.statusCode, .body = kj::mv(result)};
+  } else {
+    auto req = client.request(method, endpoint, headers);
+    { auto body = kj::mv(req.body); }
+    auto response = co_await req.response;
+    auto result = co_await response.body->readAllText();
+    co_return Response{.statusCode = response.statusCode, .body = kj::mv(result)};
+  }
+}
+
+// =======================================================================================
+// ContainerPool
+
+ContainerPool::ContainerPool(kj::Own<DockerApiClient> docker,
+    kj::String namePrefix,
+    kj::String imageName,
+    Options options,
+    kj::TaskSet& waitUntilTasks)
+    : docker(kj::mv(docker)),
+      namePrefix(kj::encodeUriComponent(namePrefix)),
+      imageName(kj::mv(imageName)),
+      options(options),
+      waitUntilTasks(waitUntilTasks),
+      tasks(*this) {}
+
+ContainerPool::~ContainerPool() noexcept(false) {
+  // Nobody else knows about unclaimed warm containers, so remove them on the way out.
+  for (auto& name: ready) {
+    waitUntilTasks.add(docker
+                           ->request(kj::HttpMethod::DELETE,
+                               kj::str("/containers/", name, "?force=true"))
+                           .ignoreResult()
+                           .attach(kj::addRef(*docker)));
+  }
+
+  // Containers still being created would be left behind if their creation were canceled partway
+  // through, so let each creation finish, then remove whatever it created, even if it failed
+  // after creating the container but before starting it.
+  for (auto& entry: creating) {
+    auto destroy = [docker = kj::addRef(*docker), name = kj::str(entry.key)]() mutable {
+      return destroyContainer(*docker, name).attach(kj::mv(docker), kj::mv(name));
+    };
+    waitUntilTasks.add(
+        entry.value.addBranch().catch_([](kj::Exception&&) {}).then(kj::mv(destroy)));
+  }
+}
+
+void ContainerPool::fill() {
+  while (ready.size() + pending < options.size) {
+    ++pending;
+    tasks.add(createWarmContainer(kj::str(namePrefix, nextId++)));
+  }
+}
+
+kj::Promise<void> ContainerPool::createWarmContainer(kj::String name) {
+  KJ_DEFER(--pending);
+  auto creation = creating
+                      .insert(kj::str(name),
+                          buildWarmContainer(kj::addRef(*docker), kj::str(name),
+                              kj::str(imageName), options.prestart)
+                              .fork())
+                      .value.addBranch();
+  KJ_DEFER(creating.erase(name));
+  co_await creation;
+  ready.add(kj::str(name));
+}
+
+kj::Promise<bool> ContainerPool::claim(kj::StringPtr containerName) {
+  if (ready.empty()) co_return false;
+
+  auto warmName = kj::mv(ready.back());
+  ready.removeLast();
+  fill();
+
+  // The warm container is no longer in `ready`, so it must be removed if it isn't renamed, or
+  // nothing would ever claim or remove it.
+  auto discardWarm = [&]() {
+    waitUntilTasks.add(
+        destroyContainer(*docker, warmName).attach(kj::mv(warmName), kj::addRef(*docker)));
+  };
+
+  bool renamed = false;
+  try {
+    // A container by the target name may be left over from an earlier run; renaming onto it
+    // would conflict.
+    co_await destroyContainer(*docker, containerName);
+
+    // Docker API: POST /containers/{id}/rename
+    auto response = co_await docker->request(kj::HttpMethod::POST,
+        kj::str("/containers/", warmName, "/rename?name=", containerName));
+    if (response.statusCode == 204) {
+      renamed = true;
+    } else {
+      KJ_LOG(WARNING, "failed to claim warm container", warmName, response.statusCode,
+          response.body);
+    }
+  } catch (...) {
+    discardWarm();
+    throw;
+  }
+
+  if (!renamed) {
+    discardWarm();
+    co_return false;
+  }
+
+  if (!options.prestart) {
+    co_await startContainer(*docker, containerName);
+  }
+  co_return true;
+}
+
+void ContainerPool::recordStart(kj::Duration latency, bool warm) {
+  (warm ? warmStats : coldStats).record(latency);
+  KJ_LOG(INFO, "container started", warm ? "warm"_kj : "cold"_kj, latency);
+}
+
+ContainerPool::Stats ContainerPool::getStats() const {
+  return {
+    .warm = warmStats,
+    .cold = coldStats,
+    .ready = static_cast<uint>(ready.size()),
+    .pending = pending,
+  };
+}
+
+void ContainerPool::renderPrometheus(
+    kj::Vector<kj::String>& lines, kj::ArrayPtr<const NamedPool> pools) {
+  auto header = [&](kj::StringPtr name, kj::StringPtr type, kj::StringPtr help) {
+    lines.add(kj::str("# HELP ", name, " ", help));
+    lines.add(kj::str("# TYPE ", name, " ", type));
+  };
+  auto label = [](const NamedPool& entry) {
+    return kj::str("namespace=\"", RuntimeMetrics::escapeQuoted(entry.namespaceName), "\"");
+  };
+
+  header("workerd_container_pool_ready", "gauge", "Warm containers ready to be claimed.");
+  for (auto& entry: pools) {
+    lines.add(
+        kj::str("workerd_container_pool_ready{", label(entry), "} ", entry.pool.ready.size()));
+  }
+  header("workerd_container_pool_pending", "gauge", "Warm containers being created.");
+  for (auto& entry: pools) {
+    lines.add(kj::str("workerd_container_pool_pending{", label(entry), "} ", entry.pool.pending));
+  }
+
+  // Startup latency, as recorded by ContainerClient::start(), split by whether the container came
+  // from the pool.
+  auto startLabels = [&](const NamedPool& entry, bool warm) {
+    return kj::str("{", label(entry), ",start=\"", warm ? "warm" : "cold", "\"}");
+  };
+  header("workerd_container_start_seconds", "summary", "Container startup latency.");
+  for (auto& entry: pools) {
+    for (auto warm: {true, false}) {
+      auto& stats = warm ? entry.pool.warmStats : entry.pool.coldStats;
+      auto labels = startLabels(entry, warm);
+      lines.add(kj::str("workerd_container_start_seconds_count", labels, " ", stats.count));
+      lines.add(
+          kj::str("workerd_container_start_seconds_sum", labels, " ", toSeconds(stats.total)));
+    }
+  }
+  header("workerd_container_start_max_seconds", "gauge", "Slowest container startup.");
+  for (auto& entry: pools) {
+    for (auto warm: {true, false}) {
+      auto& stats = warm ? entry.pool.warmStats : entry.pool.coldStats;
+      lines.add(kj::str("workerd_container_start_max_seconds", startLabels(entry, warm), " ",
+          toSeconds(stats.max)));
+    }
+  }
+}
+
+void ContainerPool::taskFailed(kj::Exception&& exception) {
+  KJ_LOG(ERROR, "failed to create warm container", exception);
+}
+
+// =======================================================================================
+// ContainerClient
+
 ContainerClient::ContainerClient(capnp::ByteStreamFactory& byteStreamFactory,
     kj::Timer& timer,
-    kj::Network& network,
-    kj::String dockerPath,
+    kj::Own<DockerApiClient> docker,
     kj::String containerName,
     kj::String imageName,
+    kj::Maybe<kj::Own<ContainerPool>> pool,
     kj::TaskSet& waitUntilTasks)
     : byteStreamFactory(byteStreamFactory),
       timer(timer),
-      network(network),
-      dockerPath(kj::mv(dockerPath)),
+      docker(kj::mv(docker)),
       containerName(kj::encodeUriComponent(kj::mv(containerName))),
       imageName(kj::mv(imageName)),
+      pool(kj::mv(pool)),
       waitUntilTasks(waitUntilTasks) {}
 
 ContainerClient::~ContainerClient() noexcept(false) {
-  waitUntilTasks.add(dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::DELETE,
-      kj::str("/containers/", containerName, "?force=true"))
-                         .ignoreResult());
+  waitUntilTasks.add(
+      docker->request(kj::HttpMethod::DELETE, kj::str("/containers/", containerName, "?force=true"))
+          .ignoreResult()
+          .attach(kj::addRef(*docker)));
 }
 
 // Docker-specific Port implementation that implements rpc::Container::Port::Server
@@ -146,7 +519,8 @@ class ContainerClient::DockerPort final: public rpc::Container::Port::Server {
     auto mappedPort = KJ_ASSERT_NONNULL(maybeMappedPort);
 
     auto address =
-        co_await containerClient.network.parseAddress(kj::str(containerHost, ":", mappedPort));
+        co_await containerClient.docker->getNetwork().parseAddress(
+            kj::str(containerHost, ":", mappedPort));
     auto connection = co_await address->connect();
 
     auto upPipe = kj::newOneWayPipe();
@@ -169,45 +543,11 @@ class ContainerClient::DockerPort final: public rpc::Container::Port::Server {
   kj::Maybe<kj::Promise<void>> pumpTask;
 };
 
-kj::Promise<ContainerClient::Response> ContainerClient::dockerApiRequest(kj::Network& network,
-    kj::String dockerPath,
-    kj::HttpMethod method,
-    kj::String endpoint,
-    kj::Maybe<kj::String> body) {
-  kj::HttpHeaderTable headerTable;
-  auto address = co_await network.parseAddress(dockerPath);
-  auto connection = co_await address->connect();
-  auto httpClient = kj::newHttpClient(headerTable, *connection).attach(kj::mv(connection));
-  kj::HttpHeaders headers(headerTable);
-  headers.set(kj::HttpHeaderId::HOST, "localhost");
-
-  KJ_IF_SOME(requestBody, body) {
-    headers.set(kj::HttpHeaderId::CONTENT_TYPE, "application/json");
-    headers.set(kj::HttpHeaderId::CONTENT_LENGTH, kj::str(requestBody.size()));
-
-    auto req = httpClient->request(method, endpoint, headers, requestBody.size());
-    {
-      auto body = kj::mv(req.body);
-      co_await body->write(requestBody.asBytes());
-    }
-    auto response = co_await req.response;
-    auto result = co_await response.body->readAllText();
-    co_return Response{.statusCode = response.statusCode, .body = kj::mv(result)};
-  } else {
-    auto req = httpClient->request(method, endpoint, headers);
-    { auto body = kj::mv(req.body); }
-    auto response = co_await req.response;
-    auto result = co_await response.body->readAllText();
-    co_return Response{.statusCode = response.statusCode, .body = kj::mv(result)};
-  }
-}
-
 kj::Promise<ContainerClient::InspectResponse> ContainerClient::inspectContainer() {
   // Docker API: GET /containers/{id}/json
   auto endpoint = kj::str("/containers/", containerName, "/json");
 
-  auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::GET, kj::mv(endpoint));
+  auto response = co_await docker->request(kj::HttpMethod::GET, kj::mv(endpoint));
   // We check if the container with the given name exist, and if it's not,
   // we simply return false while avoiding an unnecessary error.
   if (response.statusCode == 404) {
@@ -254,80 +594,10 @@ kj::Promise<ContainerClient::InspectResponse> ContainerClient::inspectContainer(
   co_return InspectResponse{.isRunning = running, .ports = kj::mv(portMappings)};
 }
 
-kj::Promise<void> ContainerClient::createContainer(
-    kj::Maybe<capnp::List<capnp::Text>::Reader> entrypoint,
-    kj::Maybe<capnp::List<capnp::Text>::Reader> environment) {
-  // Docker API: POST /containers/create
-  capnp::JsonCodec codec;
-  codec.handleByAnnotation<docker_api::Docker::ContainerCreateRequest>();
-  capnp::MallocMessageBuilder message;
-  auto jsonRoot = message.initRoot<docker_api::Docker::ContainerCreateRequest>();
-  jsonRoot.setImage(imageName);
-  // Add entrypoint if provided
-  KJ_IF_SOME(ep, entrypoint) {
-    auto jsonCmd = jsonRoot.initCmd(ep.size());
-    for (uint32_t i: kj::zeroTo(ep.size())) {
-      jsonCmd.set(i, ep[i]);
-    }
-  }
-
-  auto envSize = environment.map([](auto& env) { return env.size(); }).orDefault(0);
-  auto jsonEnv = jsonRoot.initEnv(envSize + kj::size(defaultEnv));
-
-  KJ_IF_SOME(env, environment) {
-    for (uint32_t i: kj::zeroTo(env.size())) {
-      jsonEnv.set(i, env[i]);
-    }
-  }
-
-  for (uint32_t i: kj::zeroTo(kj::size(defaultEnv))) {
-    jsonEnv.set(envSize + i, defaultEnv[i]);
-  }
-
-  auto hostConfig = jsonRoot.initHostConfig();
-  // We need to publish all ports to properly get the mapped port number locally
-  hostConfig.setPublishAllPorts(true);
-  // We need to set a restart policy to avoid having ambiguous states
-  // where the container we're managing is stuck at "exited" state.
-  hostConfig.initRestartPolicy().setName("on-failure");
-
-  auto response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
-      kj::str("/containers/create?name=", containerName), codec.encode(jsonRoot));
-
-  // statusCode 409 refers to "conflict". Occurs when a container with the given name exists.
-  // In that case we destroy and re-create the container.
-  if (response.statusCode == 409) {
-    co_await destroyContainer();
-    response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
-        kj::str("/containers/create?name=", containerName), codec.encode(jsonRoot));
-  }
-
-  // statusCode 201 refers to "container created successfully"
-  if (response.statusCode != 201) {
-    JSG_REQUIRE(response.statusCode != 404, Error, "No such image available named ", imageName);
-    JSG_REQUIRE(response.statusCode != 409, Error, "Container already exists");
-    JSG_FAIL_REQUIRE(
-        Error, "Create container failed with [", response.statusCode, "] ", response.body);
-  }
-}
-
-kj::Promise<void> ContainerClient::startContainer() {
-  // Docker API: POST /containers/{id}/start
-  auto endpoint = kj::str("/containers/", containerName, "/start");
-  // We have to send an empty body since docker API will throw an error if we don't.
-  auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::POST, kj::mv(endpoint), kj::str(""));
-  // statusCode 304 refers to "container already started"
-  JSG_REQUIRE(response.statusCode != 304, Error, "Container already started");
-  // statusCode 204 refers to "no error"
-  JSG_REQUIRE(response.statusCode == 204, Error, "Starting container failed with: ", response.body);
-}
-
 kj::Promise<void> ContainerClient::stopContainer() {
   // Docker API: POST /containers/{id}/stop
   auto endpoint = kj::str("/containers/", containerName, "/stop");
-  auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::POST, kj::mv(endpoint));
+  auto response = co_await docker->request(kj::HttpMethod::POST, kj::mv(endpoint));
   // statusCode 204 refers to "no error"
   // statusCode 304 refers to "container already stopped"
   // Both are fine to avoid when stop container is called.
@@ -338,34 +608,15 @@ kj::Promise<void> ContainerClient::stopContainer() {
 kj::Promise<void> ContainerClient::killContainer(uint32_t signal) {
   // Docker API: POST /containers/{id}/kill
   auto endpoint = kj::str("/containers/", containerName, "/kill?signal=", signalToString(signal));
-  auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::POST, kj::mv(endpoint));
+  auto response = co_await docker->request(kj::HttpMethod::POST, kj::mv(endpoint));
   // statusCode 409 refers to "container is not running"
   // We should not throw an error when the container is already not running.
   JSG_REQUIRE(response.statusCode == 200 || response.statusCode == 409, Error,
       "Stopping container failed with: ", response.body);
 }
 
-// Destroys the container.
-// No-op when the container does not exist.
-// Wait for the container to actually be stopped and removed when it exists.
 kj::Promise<void> ContainerClient::destroyContainer() {
-  auto endpoint = kj::str("/containers/", containerName, "?force=true");
-  auto response = co_await dockerApiRequest(
-      network, kj::str(dockerPath), kj::HttpMethod::DELETE, kj::mv(endpoint));
-  // statusCode 204 refers to "no error"
-  // statusCode 404 refers to "no such container"
-  // Both of which are fine for us since we're tearing down the container anyway.
-  JSG_REQUIRE(response.statusCode == 204 || response.statusCode == 404, Error,
-      "Removing a container failed with: ", response.body);
-  // Do not send a wait request if container doesn't exist. This avoids sending an
-  // unnecessary request.
-  if (response.statusCode == 204) {
-    response = co_await dockerApiRequest(network, kj::str(dockerPath), kj::HttpMethod::POST,
-        kj::str("/containers/", containerName, "/wait?condition=removed"));
-    JSG_REQUIRE(response.statusCode == 200 || response.statusCode == 404, Error,
-        "Waiting for container removal failed with: ", response.statusCode, response.body);
-  }
+  return workerd::server::destroyContainer(*docker, containerName);
 }
 
 kj::Promise<void> ContainerClient::status(StatusContext context) {
@@ -387,8 +638,24 @@ kj::Promise<void> ContainerClient::start(StartContext context) {
     environment = params.getEnvironmentVariables();
   }
 
-  co_await createContainer(entrypoint, environment);
-  co_await startContainer();
+  auto startTime = timer.now();
+  bool warm = false;
+  // Warm containers are created with the default entrypoint and environment, so they can only
+  // stand in for a start() that doesn't override either.
+  if (entrypoint == kj::none && environment == kj::none) {
+    KJ_IF_SOME(p, pool) {
+      warm = co_await p->claim(containerName);
+    }
+  }
+
+  if (!warm) {
+    co_await createContainer(*docker, containerName, imageName, entrypoint, environment);
+    co_await startContainer(*docker, containerName);
+  }
+
+  KJ_IF_SOME(p, pool) {
+    p->recordStart(timer.now() - startTime, warm);
+  }
 }
 
 kj::Promise<void> ContainerClient::monitor(MonitorContext context) {
@@ -400,8 +667,7 @@ kj::Promise<void> ContainerClient::monitor(MonitorContext context) {
     // Docker API: POST /containers/{id}/wait - wait for container to exit
     auto endpoint = kj::str("/containers/", containerName, "/wait");
 
-    auto response = co_await dockerApiRequest(
-        network, kj::str(dockerPath), kj::HttpMethod::POST, kj::mv(endpoint));
+    auto response = co_await docker->request(kj::HttpMethod::POST, kj::mv(endpoint));
     if (response.statusCode == 404) {
       co_await timer.afterDelay(1 * kj::SECONDS);
       continue;
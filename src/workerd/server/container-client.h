@@ -12,9 +12,147 @@
 #include <kj/compat/http.h>
 #include <kj/map.h>
 #include <kj/string.h>
+#include <kj/time.h>
+#include <kj/timer.h>
+#include <kj/vector.h>
 
 namespace workerd::server {
 
+// Thin client for the Docker Engine API. All requests go through a single pooled
+// kj::HttpClient bound to the Docker socket address, so connections are kept alive and reused
+// across calls rather than dialing the socket for every request. Shared by all ContainerClients
+// (and ContainerPools) belonging to a worker.
+class DockerApiClient final: public kj::Refcounted {
+ public:
+  DockerApiClient(kj::Timer& timer, kj::Network& network, kj::String dockerPath);
+
+  struct Response {
+    kj::uint statusCode;
+    kj::String body;
+  };
+
+  kj::Promise<Response> request(
+      kj::HttpMethod method, kj::String endpoint, kj::Maybe<kj::String> body = kj::none);
+
+  // The network used to reach both the Docker socket and the containers' published ports.
+  kj::Network& getNetwork() {
+    return network;
+  }
+
+  // Number of connections opened to the Docker socket so far. Exposed for tests.
+  uint getConnectionCount() const {
+    return connectionCount;
+  }
+
+ private:
+  class CountingAddress;
+
+  kj::Timer& timer;
+  kj::Network& network;
+  kj::String dockerPath;
+  kj::HttpHeaderTable headerTable;
+  uint connectionCount = 0;
+
+  // Resolved lazily on first request, then reused for the lifetime of the client.
+  kj::Maybe<kj::Own<kj::NetworkAddress>> address;
+  kj::Maybe<kj::Own<kj::HttpClient>> httpClient;
+  kj::Maybe<kj::ForkedPromise<void>> resolveTask;
+
+  kj::Promise<void> resolve();
+  kj::Promise<void> ensureResolved();
+};
+
+// A pool of pre-created (and optionally pre-started) containers for a single image, owned by a
+// Durable Object namespace. When a Durable Object calls `start()` without a custom entrypoint or
+// environment, ContainerClient claims a warm container from the pool by renaming it, instead of
+// paying the full create + start latency. The pool refills itself in the background.
+class ContainerPool final: public kj::Refcounted, private kj::TaskSet::ErrorHandler {
+ public:
+  struct Options {
+    // Number of warm containers to keep ready.
+    uint size;
+    // If true, warm containers are started as well as created.
+    bool prestart;
+  };
+
+  ContainerPool(kj::Own<DockerApiClient> docker,
+      kj::String namePrefix,
+      kj::String imageName,
+      Options options,
+      kj::TaskSet& waitUntilTasks);
+  ~ContainerPool() noexcept(false);
+
+  // Begins creating warm containers until the pool is full. Called once the server is linked.
+  void fill();
+
+  // Try to hand out a warm container under the name `containerName`. Returns false if the pool
+  // was empty or the warm container could not be claimed, in which case the caller should fall
+  // back to creating a container itself. On success, the container is running.
+  kj::Promise<bool> claim(kj::StringPtr containerName);
+
+  // Startup latency as observed by `ContainerClient::start()`, split by whether the container came
+  // from the pool.
+  struct LatencyStats {
+    uint64_t count = 0;
+    kj::Duration total = 0 * kj::NANOSECONDS;
+    kj::Duration max = 0 * kj::NANOSECONDS;
+
+    void record(kj::Duration latency) {
+      ++count;
+      total += latency;
+      if (latency > max) max = latency;
+    }
+  };
+  struct Stats {
+    LatencyStats warm;
+    LatencyStats cold;
+    uint ready;
+    uint pending;
+  };
+
+  void recordStart(kj::Duration latency, bool warm);
+  Stats getStats() const;
+
+  // Appends the stats of `pools` to `lines` in Prometheus text format, labeled by the name of the
+  // Durable Object namespace each pool belongs to.
+  struct NamedPool {
+    kj::StringPtr namespaceName;
+    const ContainerPool& pool;
+  };
+  static void renderPrometheus(kj::Vector<kj::String>& lines, kj::ArrayPtr<const NamedPool> pools);
+
+  // Resolves when no warm containers are currently being created. Exposed for tests.
+  kj::Promise<void> whenIdle() {
+    return tasks.onEmpty();
+  }
+
+  kj::Own<ContainerPool> addRef() {
+    return kj::addRef(*this);
+  }
+
+ private:
+  kj::Own<DockerApiClient> docker;
+  kj::String namePrefix;
+  kj::String imageName;
+  Options options;
+  kj::TaskSet& waitUntilTasks;
+
+  kj::Vector<kj::String> ready;
+  uint pending = 0;
+  uint nextId = 0;
+  LatencyStats warmStats;
+  LatencyStats coldStats;
+
+  // Warm containers being created, by name. The creation itself doesn't refer to the pool, so the
+  // destructor can let it finish and then remove the container.
+  kj::HashMap<kj::String, kj::ForkedPromise<void>> creating;
+
+  kj::TaskSet tasks;
+
+  kj::Promise<void> createWarmContainer(kj::String name);
+  void taskFailed(kj::Exception&& exception) override;
+};
+
 // Docker-based implementation that implements the rpc::Container::Server interface
 // so it can be used as a rpc::Container::Client via kj::heap<ContainerClient>().
 // This allows the Container JSG class to use Docker directly without knowing
@@ -23,10 +161,10 @@ class ContainerClient final: public rpc::Container::Server {
  public:
   ContainerClient(capnp::ByteStreamFactory& byteStreamFactory,
       kj::Timer& timer,
-      kj::Network& network,
-      kj::String dockerPath,
+      kj::Own<DockerApiClient> docker,
       kj::String containerName,
       kj::String imageName,
+      kj::Maybe<kj::Own<ContainerPool>> pool,
       kj::TaskSet& waitUntilTasks);
 
   ~ContainerClient() noexcept(false);
@@ -43,41 +181,22 @@ class ContainerClient final: public rpc::Container::Server {
  private:
   capnp::ByteStreamFactory& byteStreamFactory;
   kj::Timer& timer;
-  kj::Network& network;
-  kj::String dockerPath;
+  kj::Own<DockerApiClient> docker;
   kj::String containerName;
   kj::String imageName;
+  kj::Maybe<kj::Own<ContainerPool>> pool;
   kj::TaskSet& waitUntilTasks;
 
-  static constexpr kj::StringPtr defaultEnv[] = {"CLOUDFLARE_COUNTRY_A2=XX"_kj,
-    "CLOUDFLARE_DEPLOYMENT_ID=xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"_kj,
-    "CLOUDFLARE_LOCATION=loc01"_kj, "CLOUDFLARE_REGION=REGN"_kj,
-    "CLOUDFLARE_APPLICATION_ID=xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"_kj,
-    "CLOUDFLARE_DURABLE_OBJECT_ID=xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"_kj};
-
   // Docker-specific Port implementation
   class DockerPort;
 
-  struct Response {
-    kj::uint statusCode;
-    kj::String body;
-  };
-
   struct InspectResponse {
     bool isRunning;
     kj::HashMap<uint16_t, uint16_t> ports;
   };
 
   // Docker API v1.50 helper methods
-  static kj::Promise<Response> dockerApiRequest(kj::Network& network,
-      kj::String dockerPath,
-      kj::HttpMethod method,
-      kj::String endpoint,
-      kj::Maybe<kj::String> body = kj::none);
   kj::Promise<InspectResponse> inspectContainer();
-  kj::Promise<void> createContainer(kj::Maybe<capnp::List<capnp::Text>::Reader> entrypoint,
-      kj::Maybe<capnp::List<capnp::Text>::Reader> environment);
-  kj::Promise<void> startContainer();
   kj::Promise<void> stopContainer();
   kj::Promise<void> killContainer(uint32_t signal);
   kj::Promise<void> destroyContainer();
@@ -0,0 +1,193 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "dns-cache.h"
+
+#include <kj/debug.h>
+#include <kj/test.h>
+#include <kj/vector.h>
+
+namespace workerd::server {
+namespace {
+
+struct FakeDns {
+  // Names that resolve, mapped to a comma-separated address list.
+  kj::HashMap<kj::String, kj::String> records;
+
+  // Addresses which refuse connections.
+  kj::HashSet<kj::String> unreachable;
+
+  uint lookups = 0;
+  kj::Vector<kj::String> connected;
+};
+
+class FakeAddress final: public kj::NetworkAddress {
+ public:
+  FakeAddress(FakeDns& dns, kj::String text): dns(dns), text(kj::mv(text)) {}
+
+  kj::Promise<kj::Own<kj::AsyncIoStream>> connect() override {
+    if (dns.unreachable.contains(text)) {
+      return KJ_EXCEPTION(DISCONNECTED, "connection refused", text);
+    }
+    dns.connected.add(kj::str(text));
+    auto pipe = kj::newTwoWayPipe();
+    return kj::mv(pipe.ends[0]).attach(kj::mv(pipe.ends[1]));
+  }
+  kj::Own<kj::ConnectionReceiver> listen() override {
+    KJ_UNIMPLEMENTED("not used");
+  }
+  kj::Own<kj::NetworkAddress> clone() override {
+    return kj::heap<FakeAddress>(dns, kj::str(text));
+  }
+  kj::String toString() override {
+    return kj::str(text);
+  }
+
+ private:
+  FakeDns& dns;
+  kj::String text;
+};
+
+// Numeric addresses are parsed immediately. Names are looked up in `FakeDns::records` on a later
+// turn of the event loop, like a real lookup on another thread.
+class FakeNetwork final: public kj::Network {
+ public:
+  FakeNetwork(FakeDns& dns): dns(dns) {}
+
+  kj::Promise<kj::Own<kj::NetworkAddress>> parseAddress(
+      kj::StringPtr addr, uint portHint = 0) override {
+    if ('0' <= addr[0] && addr[0] <= '9') {
+      return kj::Own<kj::NetworkAddress>(kj::heap<FakeAddress>(dns, kj::str(addr)));
+    }
+
+    ++dns.lookups;
+    return kj::evalLater([this, addr = kj::str(addr)]() -> kj::Own<kj::NetworkAddress> {
+      KJ_IF_SOME(record, dns.records.find(addr)) {
+        return kj::heap<FakeAddress>(dns, kj::str(record));
+      }
+      KJ_FAIL_REQUIRE("DNS lookup failed", addr);
+    });
+  }
+  kj::Own<kj::NetworkAddress> getSockaddr(const void* sockaddr, uint len) override {
+    KJ_UNIMPLEMENTED("not used");
+  }
+  kj::Own<kj::Network> restrictPeers(kj::ArrayPtr<const kj::StringPtr> allow,
+      kj::ArrayPtr<const kj::StringPtr> deny = nullptr) override {
+    KJ_UNIMPLEMENTED("not used");
+  }
+
+ private:
+  FakeDns& dns;
+};
+
+struct TestContext {
+  kj::EventLoop loop;
+  kj::WaitScope waitScope{loop};
+  kj::TimerImpl timer{kj::origin<kj::TimePoint>()};
+  FakeDns dns;
+  DnsCachingNetwork network;
+
+  TestContext(DnsCachingNetwork::Options options = {})
+      : network(kj::heap<FakeNetwork>(dns), timer, options) {}
+
+  kj::String resolve(kj::StringPtr addr) {
+    return network.parseAddress(addr).wait(waitScope)->toString();
+  }
+
+  void advance(kj::Duration duration) {
+    timer.advanceTo(timer.now() + duration);
+  }
+};
+
+KJ_TEST("DnsCachingNetwork combines concurrent lookups of the same name") {
+  TestContext context;
+  context.dns.records.insert(kj::str("example.com"), kj::str("192.0.2.1:80"));
+
+  auto promise1 = context.network.parseAddress("example.com");
+  auto promise2 = context.network.parseAddress("example.com");
+  auto promise3 = context.network.parseAddress("example.com", 443);
+  KJ_EXPECT(context.dns.lookups == 2);
+
+  KJ_EXPECT(promise1.wait(context.waitScope)->toString() == "192.0.2.1:80");
+  KJ_EXPECT(promise2.wait(context.waitScope)->toString() == "192.0.2.1:80");
+  promise3.wait(context.waitScope);
+  KJ_EXPECT(context.dns.lookups == 2);
+
+  // Connecting to each address doesn't look the name up again either.
+  auto address = context.network.parseAddress("example.com").wait(context.waitScope);
+  address->connect().wait(context.waitScope);
+  address->connect().wait(context.waitScope);
+  KJ_EXPECT(context.dns.lookups == 2);
+  KJ_EXPECT(context.dns.connected.size() == 2);
+}
+
+KJ_TEST("DnsCachingNetwork looks a name up again once it expires") {
+  TestContext context({.positiveTtl = 10 * kj::SECONDS});
+  context.dns.records.insert(kj::str("example.com"), kj::str("192.0.2.1:80"));
+
+  KJ_EXPECT(context.resolve("example.com") == "192.0.2.1:80");
+  context.advance(9 * kj::SECONDS);
+  KJ_EXPECT(context.resolve("example.com") == "192.0.2.1:80");
+  KJ_EXPECT(context.dns.lookups == 1);
+
+  context.dns.records.upsert(kj::str("example.com"), kj::str("192.0.2.2:80"));
+  context.advance(1 * kj::SECONDS);
+  KJ_EXPECT(context.resolve("example.com") == "192.0.2.2:80");
+  KJ_EXPECT(context.dns.lookups == 2);
+}
+
+KJ_TEST("DnsCachingNetwork remembers failed lookups for the negative TTL") {
+  TestContext context({.negativeTtl = 1 * kj::SECONDS});
+
+  for (auto i KJ_UNUSED: kj::zeroTo(2)) {
+    KJ_EXPECT_THROW_MESSAGE("DNS lookup failed", context.resolve("missing.example"));
+  }
+  KJ_EXPECT(context.dns.lookups == 1);
+
+  context.dns.records.insert(kj::str("missing.example"), kj::str("192.0.2.1:80"));
+  context.advance(1 * kj::SECONDS);
+  KJ_EXPECT(context.resolve("missing.example") == "192.0.2.1:80");
+  KJ_EXPECT(context.dns.lookups == 2);
+}
+
+KJ_TEST("DnsCachingNetwork rotates between the addresses a name resolves to") {
+  TestContext context;
+  context.dns.records.insert(kj::str("example.com"), kj::str("192.0.2.1:80,192.0.2.2:80"));
+
+  KJ_EXPECT(context.resolve("example.com") == "192.0.2.1:80,192.0.2.2:80");
+  KJ_EXPECT(context.resolve("example.com") == "192.0.2.2:80,192.0.2.1:80");
+  KJ_EXPECT(context.resolve("example.com") == "192.0.2.1:80,192.0.2.2:80");
+  KJ_EXPECT(context.dns.lookups == 1);
+
+  // An address which can't be reached is skipped.
+  context.dns.unreachable.insert(kj::str("192.0.2.2:80"));
+  auto address = context.network.parseAddress("example.com").wait(context.waitScope);
+  KJ_EXPECT(address->toString() == "192.0.2.2:80,192.0.2.1:80");
+  address->connect().wait(context.waitScope);
+  KJ_ASSERT(context.dns.connected.size() == 1);
+  KJ_EXPECT(context.dns.connected[0] == "192.0.2.1:80");
+}
+
+KJ_TEST("DnsCachingNetwork drops the entry closest to expiring when full") {
+  TestContext context({.maxEntries = 2});
+  context.dns.records.insert(kj::str("a.example"), kj::str("192.0.2.1:80"));
+  context.dns.records.insert(kj::str("b.example"), kj::str("192.0.2.2:80"));
+  context.dns.records.insert(kj::str("c.example"), kj::str("192.0.2.3:80"));
+
+  context.resolve("a.example");
+  context.advance(1 * kj::SECONDS);
+  context.resolve("b.example");
+  context.resolve("c.example");
+  KJ_EXPECT(context.dns.lookups == 3);
+
+  context.resolve("b.example");
+  context.resolve("c.example");
+  KJ_EXPECT(context.dns.lookups == 3);
+
+  context.resolve("a.example");
+  KJ_EXPECT(context.dns.lookups == 4);
+}
+
+}  // namespace
+}  // namespace workerd::server
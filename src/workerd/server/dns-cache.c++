@@ -0,0 +1,202 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "dns-cache.h"
+
+#include <kj/debug.h>
+#include <kj/vector.h>
+
+namespace workerd::server {
+
+namespace {
+
+// A name which resolved to several addresses, ordered so that this caller tries a different one
+// first than the previous caller did. Connecting falls back to the remaining addresses in order,
+// as a kj::NetworkAddress covering several addresses would.
+class RoundRobinAddress final: public kj::NetworkAddress {
+ public:
+  RoundRobinAddress(kj::Array<kj::Own<kj::NetworkAddress>> addresses)
+      : addresses(kj::mv(addresses)) {}
+
+  kj::Promise<kj::Own<kj::AsyncIoStream>> connect() override {
+    kj::Maybe<kj::Exception> lastError;
+    for (auto& address: addresses) {
+      try {
+        co_return co_await address->connect();
+      } catch (...) {
+        lastError = kj::getCaughtExceptionAsKj();
+      }
+    }
+    KJ_IF_SOME(error, lastError) {
+      kj::throwFatalException(kj::mv(error));
+    }
+    KJ_UNREACHABLE;
+  }
+
+  kj::Promise<kj::AuthenticatedStream> connectAuthenticated() override {
+    kj::Maybe<kj::Exception> lastError;
+    for (auto& address: addresses) {
+      try {
+        co_return co_await address->connectAuthenticated();
+      } catch (...) {
+        lastError = kj::getCaughtExceptionAsKj();
+      }
+    }
+    KJ_IF_SOME(error, lastError) {
+      kj::throwFatalException(kj::mv(error));
+    }
+    KJ_UNREACHABLE;
+  }
+
+  kj::Own<kj::ConnectionReceiver> listen() override {
+    return addresses[0]->listen();
+  }
+
+  kj::Own<kj::DatagramPort> bindDatagramPort() override {
+    return addresses[0]->bindDatagramPort();
+  }
+
+  kj::Own<kj::NetworkAddress> clone() override {
+    return kj::heap<RoundRobinAddress>(KJ_MAP(address, addresses) { return address->clone(); });
+  }
+
+  kj::String toString() override {
+    return kj::strArray(KJ_MAP(address, addresses) { return address->toString(); }, ",");
+  }
+
+ private:
+  kj::Array<kj::Own<kj::NetworkAddress>> addresses;
+};
+
+}  // namespace
+
+DnsCachingNetwork::DnsCachingNetwork(kj::Own<kj::Network> inner, kj::Timer& timer, Options options)
+    : inner(kj::mv(inner)),
+      timer(timer),
+      options(options) {}
+
+kj::Promise<kj::Own<kj::NetworkAddress>> DnsCachingNetwork::parseAddress(
+    kj::StringPtr addr, uint portHint) {
+  auto entry = getEntry(addr, portHint);
+  if (!entry->done) {
+    co_await KJ_ASSERT_NONNULL(entry->lookup).addBranch();
+  }
+  co_return pick(*entry);
+}
+
+kj::Own<kj::NetworkAddress> DnsCachingNetwork::getSockaddr(const void* sockaddr, uint len) {
+  return inner->getSockaddr(sockaddr, len);
+}
+
+kj::Own<kj::Network> DnsCachingNetwork::restrictPeers(
+    kj::ArrayPtr<const kj::StringPtr> allow, kj::ArrayPtr<const kj::StringPtr> deny) {
+  // The restricted network filters lookup results, so it can't share our entries.
+  return kj::heap<DnsCachingNetwork>(inner->restrictPeers(allow, deny), timer, options);
+}
+
+kj::Own<DnsCachingNetwork::Entry> DnsCachingNetwork::getEntry(kj::StringPtr addr, uint portHint) {
+  auto now = timer.now();
+  auto key = kj::str(portHint, '/', addr);
+
+  KJ_IF_SOME(entry, entries.find(key)) {
+    if (!entry->done || now < entry->expires) {
+      return kj::addRef(*entry);
+    }
+    // Expired. Anyone still holding the old entry keeps using it.
+    entries.erase(key);
+  }
+
+  makeRoom(now);
+  auto entry = kj::refcounted<Entry>();
+  entry->lookup = resolve(*entry, kj::str(addr), portHint).fork();
+  entries.insert(kj::mv(key), kj::addRef(*entry));
+  return entry;
+}
+
+void DnsCachingNetwork::makeRoom(kj::TimePoint now) {
+  if (entries.size() < options.maxEntries) return;
+
+  entries.eraseAll(
+      [&](auto&, kj::Own<Entry>& entry) { return entry->done && entry->expires <= now; });
+
+  // Nothing has expired, so drop whichever entry will expire first. Lookups still in flight are
+  // dropped last; their waiters hold their own references, so they still get the result.
+  while (entries.size() >= kj::max(options.maxEntries, 1u)) {
+    kj::Maybe<decltype(entries)::Entry&> victim;
+    for (auto& candidate: entries) {
+      bool better = true;
+      KJ_IF_SOME(v, victim) {
+        better = candidate.value->done &&
+            (!v.value->done || candidate.value->expires < v.value->expires);
+      }
+      if (better) victim = candidate;
+    }
+    entries.erase(KJ_ASSERT_NONNULL(victim));
+  }
+}
+
+kj::Promise<void> DnsCachingNetwork::resolve(Entry& entry, kj::String addr, uint portHint) {
+  // If the entry is dropped before anyone waits on it, its ForkedPromise is destroyed, which
+  // cancels this coroutine. Otherwise the waiters keep the entry alive until we're done.
+  try {
+    auto address = co_await inner->parseAddress(addr, portHint);
+    entry.addresses = co_await split(kj::mv(address), portHint);
+    entry.expires = timer.now() + options.positiveTtl;
+  } catch (...) {
+    entry.error = kj::getCaughtExceptionAsKj();
+    entry.expires = timer.now() + options.negativeTtl;
+  }
+  entry.done = true;
+}
+
+kj::Promise<kj::Array<kj::Own<kj::NetworkAddress>>> DnsCachingNetwork::split(
+    kj::Own<kj::NetworkAddress> address, uint portHint) {
+  // A kj::NetworkAddress covering several addresses lists them all in toString(), separated by
+  // commas. Each of those is numeric, so parsing it again doesn't do another DNS lookup.
+  auto text = address->toString();
+  kj::Vector<kj::StringPtr> parts;
+  kj::StringPtr rest = text;
+  for (;;) {
+    KJ_IF_SOME(comma, rest.findFirst(',')) {
+      parts.add(rest.first(comma));
+      rest = rest.slice(comma + 1);
+    } else {
+      parts.add(rest);
+      break;
+    }
+  }
+
+  if (parts.size() == 1) {
+    co_return kj::arr(kj::mv(address));
+  }
+
+  auto result = kj::heapArrayBuilder<kj::Own<kj::NetworkAddress>>(parts.size());
+  try {
+    for (auto part: parts) {
+      result.add(co_await inner->parseAddress(part, portHint));
+    }
+  } catch (...) {
+    // Not a format we understand. Use the address as a whole, without round-robin.
+    co_return kj::arr(kj::mv(address));
+  }
+  co_return result.finish();
+}
+
+kj::Own<kj::NetworkAddress> DnsCachingNetwork::pick(Entry& entry) {
+  KJ_IF_SOME(error, entry.error) {
+    kj::throwFatalException(kj::cp(error));
+  }
+
+  auto count = entry.addresses.size();
+  if (count == 1) {
+    return entry.addresses[0]->clone();
+  }
+
+  uint first = entry.next;
+  entry.next = (first + 1) % count;
+  return kj::heap<RoundRobinAddress>(
+      KJ_MAP(i, kj::zeroTo(count)) { return entry.addresses[(first + i) % count]->clone(); });
+}
+
+}  // namespace workerd::server
@@ -0,0 +1,83 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <kj/async-io.h>
+#include <kj/map.h>
+#include <kj/refcount.h>
+#include <kj/timer.h>
+
+namespace workerd::server {
+
+// A kj::Network which remembers the result of parseAddress() for a while, so that a burst of
+// outbound connections to the same host doesn't do a DNS lookup (which occupies a getaddrinfo
+// thread) for each one.
+//
+// - Successful lookups are kept for `positiveTtl`, failed ones for `negativeTtl`.
+// - Concurrent lookups of the same address share a single lookup of the inner network.
+// - When a name resolves to several addresses, each address returned from the cache prefers a
+//   different one of them, in turn, falling back to the others if connecting fails.
+// - At most `maxEntries` names are remembered. When full, expired entries are dropped first, then
+//   the entry closest to expiring.
+//
+// Addresses are cached as the inner network returned them, so if the inner network restricts
+// peers, the cache holds the already-filtered addresses.
+class DnsCachingNetwork final: public kj::Network {
+ public:
+  struct Options {
+    kj::Duration positiveTtl = 60 * kj::SECONDS;
+    kj::Duration negativeTtl = 5 * kj::SECONDS;
+    uint maxEntries = 1024;
+  };
+
+  DnsCachingNetwork(kj::Own<kj::Network> inner, kj::Timer& timer, Options options);
+
+  kj::Promise<kj::Own<kj::NetworkAddress>> parseAddress(
+      kj::StringPtr addr, uint portHint = 0) override;
+  kj::Own<kj::NetworkAddress> getSockaddr(const void* sockaddr, uint len) override;
+  kj::Own<kj::Network> restrictPeers(kj::ArrayPtr<const kj::StringPtr> allow,
+      kj::ArrayPtr<const kj::StringPtr> deny = nullptr) override;
+
+ private:
+  struct Entry: public kj::Refcounted {
+    // Resolves when `addresses` or `error` has been filled in, at which point `done` is set.
+    kj::Maybe<kj::ForkedPromise<void>> lookup;
+    bool done = false;
+
+    kj::Array<kj::Own<kj::NetworkAddress>> addresses;
+    kj::Maybe<kj::Exception> error;
+
+    // Meaningless until `done`.
+    kj::TimePoint expires = kj::origin<kj::TimePoint>();
+
+    // Index of the address the next caller should try first.
+    uint next = 0;
+  };
+
+  kj::Own<kj::Network> inner;
+  kj::Timer& timer;
+  Options options;
+
+  // Keyed by "<portHint>/<addr>".
+  kj::HashMap<kj::String, kj::Own<Entry>> entries;
+
+  // Returns the entry for the given address, starting a new lookup if there isn't one or it has
+  // expired.
+  kj::Own<Entry> getEntry(kj::StringPtr addr, uint portHint);
+
+  // Drops entries until there is room for a new one.
+  void makeRoom(kj::TimePoint now);
+
+  kj::Promise<void> resolve(Entry& entry, kj::String addr, uint portHint);
+
+  // Splits a multi-address result into one NetworkAddress per address, so that they can be
+  // tried in a different order by each caller.
+  kj::Promise<kj::Array<kj::Own<kj::NetworkAddress>>> split(
+      kj::Own<kj::NetworkAddress> address, uint portHint);
+
+  kj::Own<kj::NetworkAddress> pick(Entry& entry);
+};
+
+}  // namespace workerd::server
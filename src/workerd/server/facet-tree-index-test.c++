@@ -1,5 +1,6 @@
 #include "facet-tree-index.h"
 
+#include <kj/async.h>
 #include <kj/io.h>
 #include <kj/memory.h>
 #include <kj/test.h>
@@ -64,6 +65,8 @@ KJ_TEST("FacetTreeIndex basic functionality") {
     expectChildren(index, 3, {});
     expectChildren(index, 4, {});
     expectChildren(index, 5, {});
+
+    index.flush();
   }
 
   {
@@ -92,6 +95,8 @@ KJ_TEST("FacetTreeIndex basic functionality") {
     expectChildren(index, 5, {});
     expectChildren(index, 6, {});
     expectChildren(index, 7, {});
+
+    index.flush();
   }
 
   {
@@ -198,6 +203,8 @@ KJ_TEST("FacetTreeIndex corruption handling") {
     // Similarly, "ignored" should be new
     uint id2 = index.getId(0, "ignored");
     KJ_EXPECT(id2 == 3);
+
+    index.flush();
   }
 
   // Open yet again, make sure that the newly-added entries were written successfully.
@@ -258,6 +265,8 @@ KJ_TEST("FacetTreeIndex handles truncated files correctly") {
     KJ_EXPECT(id1 == 1);
     KJ_EXPECT(id2 == 2);
     KJ_EXPECT(id3 == 3);
+
+    index.flush();
   }
 
   // Step 2: Corrupt the last entry by overwriting its nameLength field with an invalid large value
@@ -282,6 +291,8 @@ KJ_TEST("FacetTreeIndex handles truncated files correctly") {
     // should get the ID 3 (reusing the ID that was intended for entry3)
     uint id = index.getId(0, "replacement");
     KJ_EXPECT(id == 3);
+
+    index.flush();
   }
 
   // Step 4: Re-read the file again and add yet another new entry
@@ -300,5 +311,50 @@ KJ_TEST("FacetTreeIndex handles truncated files correctly") {
   }
 }
 
+KJ_TEST("FacetTreeIndex batches new entries until they are made durable") {
+  kj::EventLoop loop;
+  kj::WaitScope waitScope(loop);
+
+  auto file = kj::newInMemoryFile(kj::nullClock());
+  FacetTreeIndex index(file->clone());
+  auto emptySize = file->stat().size;
+
+  // Nothing is pending, so there's nothing to wait for.
+  KJ_EXPECT(index.whenDurable().poll(waitScope));
+
+  uint id1 = index.getId(0, "facet1");
+  uint id2 = index.getId(0, "facet2");
+  uint id3 = index.getId(id1, "child1");
+  KJ_EXPECT(id3 == 3);
+
+  // IDs are assigned right away, but nothing is written until the flush runs.
+  KJ_EXPECT(file->stat().size == emptySize);
+
+  auto promise1 = index.whenDurable();
+  auto promise2 = index.whenDurable();
+  KJ_EXPECT(file->stat().size == emptySize);
+
+  // Both waiters share the same flush.
+  promise1.wait(waitScope);
+  KJ_EXPECT(promise2.poll(waitScope));
+  promise2.wait(waitScope);
+  auto flushedSize = file->stat().size;
+  KJ_EXPECT(flushedSize > emptySize);
+  KJ_EXPECT(index.whenDurable().poll(waitScope));
+
+  // Looking up existing entries doesn't require another flush, but a new entry does.
+  KJ_EXPECT(index.getId(0, "facet2") == id2);
+  KJ_EXPECT(index.whenDurable().poll(waitScope));
+  KJ_EXPECT(index.getId(id2, "child2") == 4);
+  index.whenDurable().wait(waitScope);
+  KJ_EXPECT(file->stat().size > flushedSize);
+
+  FacetTreeIndex reopened(file->clone());
+  KJ_EXPECT(reopened.getId(0, "facet1") == 1);
+  KJ_EXPECT(reopened.getId(0, "facet2") == 2);
+  KJ_EXPECT(reopened.getId(1, "child1") == 3);
+  KJ_EXPECT(reopened.getId(2, "child2") == 4);
+}
+
 }  // namespace
 }  // namespace workerd::server
@@ -94,30 +94,15 @@ uint FacetTreeIndex::getId(uint parent, kj::StringPtr name) {
 
   // Use findOrCreate to either find an existing entry or create a new one
   auto& entry = entries.findOrCreate(EntryPtr{parent, name}, [&]() -> Entry {
-    // New entry, need to assign a new ID and append to file
+    // New entry, need to assign a new ID and queue it to be appended to the file.
     KJ_REQUIRE(nextId() <= MAX_ID, "Maximum number of facets exceeded");
 
-    // Prepare entry data
     EntryHeader header{
       .parentId = static_cast<uint16_t>(parent),
       .nameLength = static_cast<uint16_t>(name.size()),
     };
-
-// Don't whine about VLA being non-standard.
-#pragma clang diagnostic ignored "-Wvla-cxx-extension"
-
-    size_t entrySize = sizeof(EntryHeader) + header.nameLength;
-    byte entryData[entrySize];
-    memcpy(entryData, &header, sizeof(header));
-    memcpy(entryData + sizeof(EntryHeader), name.begin(), header.nameLength);
-
-    file->write(offset, kj::arrayPtr(entryData, entrySize));
-
-    // We don't want to return an entry that might disappear after a power failure, so sync it
-    // now.
-    file->datasync();
-
-    offset += entrySize;
+    pending.addAll(kj::asBytes(header));
+    pending.addAll(name.asBytes());
 
     return Entry{parent, kj::heapString(name)};
   });
@@ -127,4 +112,36 @@ uint FacetTreeIndex::getId(uint parent, kj::StringPtr name) {
   return 1 + (&entry - entries.begin());
 }
 
+kj::Promise<void> FacetTreeIndex::whenDurable() {
+  if (pending.size() == 0) {
+    return kj::READY_NOW;
+  }
+
+  if (!flushScheduled) {
+    // Wait for the rest of this turn so that every facet created alongside this one makes it into
+    // the same batch.
+    flushScheduled = true;
+    flushTask.emplace(kj::evalLater([this]() {
+      flushScheduled = false;
+      flush();
+    }).fork());
+  }
+
+  return KJ_ASSERT_NONNULL(flushTask).addBranch();
+}
+
+void FacetTreeIndex::flush() {
+  if (pending.size() == 0) return;
+
+  file->write(offset, pending.asPtr());
+
+  // We don't want anyone to rely on an entry that might disappear after a power failure, so sync
+  // before reporting it durable. If either call throws, the entries stay pending and the next
+  // flush rewrites them at the same offset.
+  file->datasync();
+
+  offset += pending.size();
+  pending.clear();
+}
+
 }  // namespace workerd::server
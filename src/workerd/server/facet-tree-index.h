@@ -1,7 +1,9 @@
 #pragma once
 
+#include <kj/async.h>
 #include <kj/filesystem.h>
 #include <kj/map.h>
+#include <kj/vector.h>
 
 namespace workerd::server {
 
@@ -54,8 +56,19 @@ class FacetTreeIndex {
   FacetTreeIndex(kj::Own<const kj::File> file);
 
   // Gets the ID for the given facet, assigning it if needed.
+  //
+  // A newly-assigned ID is returned immediately, but its entry is only buffered in memory. Don't
+  // create anything on disk that depends on the ID until `whenDurable()` resolves.
   uint getId(uint parent, kj::StringPtr name);
 
+  // Returns a promise that resolves once every ID assigned so far has been written to the file and
+  // synced. Entries buffered during the same turn of the event loop are appended with one write
+  // and one `datasync()`, shared by all callers waiting on them.
+  kj::Promise<void> whenDurable();
+
+  // Synchronously writes and syncs any buffered entries.
+  void flush();
+
   // For each child of the given parent ID, call the callback.
   template <typename Func>
   void forEachChild(uint parentId, Func&& callback) {
@@ -73,6 +86,15 @@ class FacetTreeIndex {
   // a corrupted tail was detected).
   uint offset;
 
+  // Encoded entries which have been assigned IDs but not yet written, to be appended at `offset`.
+  kj::Vector<kj::byte> pending;
+
+  // Flush scheduled by `whenDurable()`. Only meaningful while `flushScheduled` is true; after the
+  // flush runs, the promise is left in place (it can't be destroyed from within itself) and
+  // replaced by the next call that needs a flush.
+  kj::Maybe<kj::ForkedPromise<void>> flushTask;
+  bool flushScheduled = false;
+
   struct EntryPtr;
 
   struct Entry {
@@ -0,0 +1,79 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "memory-reporter.h"
+
+#include <workerd/tests/test-fixture.h>
+
+#include <kj/test.h>
+
+namespace workerd::server {
+namespace {
+
+// Returns the value of the sample with exactly this name and labels.
+kj::Maybe<kj::StringPtr> findSample(kj::ArrayPtr<const kj::String> lines, kj::StringPtr sample) {
+  for (auto& line: lines) {
+    if (line.startsWith(sample) && line.size() > sample.size() && line[sample.size()] == ' ') {
+      return line.slice(sample.size() + 1);
+    }
+  }
+  return kj::none;
+}
+
+KJ_TEST("MemoryReporter reports each registered isolate") {
+  auto io = kj::setupAsyncIo();
+  TestFixture fixture({.waitScope = io.waitScope});
+
+  kj::Vector<kj::String> reports;
+  // Only the largest type is kept, which is always the isolate itself, as it retains everything.
+  MemoryReporter reporter(io.provider->getTimer(), {.maxTypes = 1},
+      [&](kj::StringPtr json) { reports.add(kj::str(json)); });
+  reporter.registerIsolate("test", fixture.getIsolate());
+
+  // Nothing is rendered before the first report.
+  kj::Vector<kj::String> lines;
+  reporter.renderPrometheus(lines);
+  KJ_EXPECT(findSample(lines, "workerd_isolate_heap_used_bytes{isolate=\"test\"}") == kj::none);
+
+  reporter.collect().wait(io.waitScope);
+
+  KJ_ASSERT(reports.size() == 1);
+  auto& json = reports[0];
+  KJ_EXPECT(json.startsWith("{\"isolate\":\"test\",\"usedHeapSize\":"), json);
+  KJ_EXPECT(json.contains(",\"nativeTypes\":[{\"name\":\"IsolateBase\",\"count\":1,"), json);
+
+  lines.clear();
+  reporter.renderPrometheus(lines);
+
+  kj::StringPtr gauges[] = {"workerd_isolate_heap_used_bytes", "workerd_isolate_heap_total_bytes",
+    "workerd_isolate_external_memory_bytes", "workerd_isolate_malloced_memory_bytes",
+    "workerd_isolate_native_retained_bytes", "workerd_isolate_native_objects"};
+  for (auto name: gauges) {
+    KJ_EXPECT(KJ_ASSERT_NONNULL(findSample(lines, kj::str("# TYPE ", name))) == "gauge", name);
+  }
+
+  auto sample = [&](kj::StringPtr name) {
+    return KJ_ASSERT_NONNULL(findSample(lines, name), name).parseAs<uint64_t>();
+  };
+  auto used = sample("workerd_isolate_heap_used_bytes{isolate=\"test\"}");
+  auto total = sample("workerd_isolate_heap_total_bytes{isolate=\"test\"}");
+  KJ_EXPECT(used > 0);
+  KJ_EXPECT(used <= total);
+  // The rendered gauges come from the same report as the JSON.
+  KJ_EXPECT(json.contains(kj::str("\"usedHeapSize\":", used, ",")), json);
+
+  KJ_EXPECT(sample("workerd_isolate_native_objects{isolate=\"test\",type=\"IsolateBase\"}") == 1);
+  KJ_EXPECT(
+      sample("workerd_isolate_native_retained_bytes{isolate=\"test\",type=\"IsolateBase\"}") > 0);
+
+  // Types beyond `maxTypes` aren't reported.
+  size_t nativeObjectSamples = 0;
+  for (auto& line: lines) {
+    if (line.startsWith("workerd_isolate_native_objects{")) ++nativeObjectSamples;
+  }
+  KJ_EXPECT(nativeObjectSamples == 1);
+}
+
+}  // namespace
+}  // namespace workerd::server
@@ -0,0 +1,132 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "memory-reporter.h"
+
+#include "runtime-metrics.h"
+
+#include <kj/debug.h>
+
+namespace workerd::server {
+
+namespace {
+
+kj::String reportToJson(kj::StringPtr name, const Worker::Isolate::MemoryReport& report) {
+  auto types = KJ_MAP(type, report.nativeTypes) {
+    return kj::str("{\"name\":\"", RuntimeMetrics::escapeQuoted(type.name),
+        "\",\"count\":", type.count, ",\"selfSize\":", type.selfSize,
+        ",\"retainedSize\":", type.retainedSize, "}");
+  };
+  return kj::str("{\"isolate\":\"", RuntimeMetrics::escapeQuoted(name),
+      "\",\"usedHeapSize\":", report.usedHeapSize, ",\"totalHeapSize\":", report.totalHeapSize,
+      ",\"externalMemory\":", report.externalMemory, ",\"mallocedMemory\":", report.mallocedMemory,
+      ",\"nativeTypes\":[", kj::strArray(types, ","), "]}");
+}
+
+void renderGauge(kj::Vector<kj::String>& lines, kj::StringPtr name, kj::StringPtr help) {
+  lines.add(kj::str("# HELP ", name, " ", help));
+  lines.add(kj::str("# TYPE ", name, " gauge"));
+}
+
+}  // namespace
+
+MemoryReporter::MemoryReporter(
+    kj::Timer& timer, Options options, kj::Function<void(kj::StringPtr json)> onReport)
+    : timer(timer),
+      options(options),
+      onReport(kj::mv(onReport)) {}
+
+void MemoryReporter::registerIsolate(kj::StringPtr name, const Worker::Isolate& isolate) {
+  isolates.upsert(kj::str(name), isolate.getWeakRef());
+}
+
+kj::Promise<void> MemoryReporter::run() {
+  for (;;) {
+    co_await timer.afterDelay(options.interval);
+    co_await collect();
+  }
+}
+
+kj::Promise<void> MemoryReporter::collect() {
+  struct LiveIsolate {
+    kj::String name;
+    kj::Own<const Worker::Isolate> isolate;
+  };
+  kj::Vector<LiveIsolate> live;
+  kj::Vector<kj::String> dead;
+  for (auto& entry: isolates) {
+    KJ_IF_SOME(isolate, entry.value->tryAddStrongRef()) {
+      live.add(LiveIsolate{.name = kj::str(entry.key), .isolate = kj::mv(isolate)});
+    } else {
+      dead.add(kj::str(entry.key));
+    }
+  }
+  for (auto& name: dead) {
+    isolates.erase(name);
+    latest.erase(name);
+  }
+
+  // One isolate at a time, so that at most one isolate lock is held on behalf of the reporter.
+  for (auto& entry: live) {
+    auto report = co_await entry.isolate->collectMemoryReport();
+    if (report.nativeTypes.size() > options.maxTypes) {
+      // Types are sorted by retained size, largest first.
+      auto top = kj::heapArrayBuilder<jsg::NativeMemoryUsage>(options.maxTypes);
+      for (auto& type: report.nativeTypes.first(options.maxTypes)) {
+        top.add(kj::mv(type));
+      }
+      report.nativeTypes = top.finish();
+    }
+    onReport(reportToJson(entry.name, report));
+    latest.upsert(kj::mv(entry.name), kj::mv(report));
+  }
+}
+
+void MemoryReporter::renderPrometheus(kj::Vector<kj::String>& lines) const {
+  struct Gauge {
+    kj::StringPtr name;
+    kj::StringPtr help;
+    size_t Worker::Isolate::MemoryReport::* field;
+  };
+  static const Gauge GAUGES[] = {
+    {"workerd_isolate_heap_used_bytes"_kj, "V8 heap in use."_kj,
+      &Worker::Isolate::MemoryReport::usedHeapSize},
+    {"workerd_isolate_heap_total_bytes"_kj, "V8 heap allocated."_kj,
+      &Worker::Isolate::MemoryReport::totalHeapSize},
+    {"workerd_isolate_external_memory_bytes"_kj,
+      "Memory outside the V8 heap attributed to the isolate, e.g. ArrayBuffer contents."_kj,
+      &Worker::Isolate::MemoryReport::externalMemory},
+    {"workerd_isolate_malloced_memory_bytes"_kj, "Memory malloc()ed by V8 itself."_kj,
+      &Worker::Isolate::MemoryReport::mallocedMemory},
+  };
+  for (auto& gauge: GAUGES) {
+    renderGauge(lines, gauge.name, gauge.help);
+    for (auto& entry: latest) {
+      lines.add(kj::str(gauge.name, "{isolate=\"", RuntimeMetrics::escapeQuoted(entry.key), "\"} ",
+          entry.value.*gauge.field));
+    }
+  }
+
+  renderGauge(lines, "workerd_isolate_native_retained_bytes",
+      "Memory retained by native objects reachable from JavaScript, by type.");
+  for (auto& entry: latest) {
+    auto isolate = RuntimeMetrics::escapeQuoted(entry.key);
+    for (auto& type: entry.value.nativeTypes) {
+      lines.add(kj::str("workerd_isolate_native_retained_bytes{isolate=\"", isolate, "\",type=\"",
+          RuntimeMetrics::escapeQuoted(type.name), "\"} ", type.retainedSize));
+    }
+  }
+
+  renderGauge(lines, "workerd_isolate_native_objects",
+      "Number of native objects reachable from JavaScript, by type.");
+  for (auto& entry: latest) {
+    auto isolate = RuntimeMetrics::escapeQuoted(entry.key);
+    for (auto& type: entry.value.nativeTypes) {
+      lines.add(kj::str("workerd_isolate_native_objects{isolate=\"", isolate, "\",type=\"",
+          RuntimeMetrics::escapeQuoted(type.name), "\"} ", type.count));
+    }
+  }
+}
+
+}  // namespace workerd::server
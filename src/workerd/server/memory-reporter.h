@@ -0,0 +1,57 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <workerd/io/worker.h>
+
+#include <kj/async.h>
+#include <kj/function.h>
+#include <kj/map.h>
+#include <kj/timer.h>
+#include <kj/vector.h>
+
+namespace workerd::server {
+
+// Periodically summarizes the memory use of every registered isolate, without taking heap
+// snapshots, so that leaks can be tracked down on production hosts.
+//
+// Each report holds V8's heap statistics plus the native objects reachable from JavaScript
+// (streams, buffers, caches, WebSockets, SQL cursors, ...) grouped by type. Reports are passed to
+// `onReport` as JSON, one line per isolate, and the latest ones can be rendered as Prometheus
+// gauges.
+class MemoryReporter final {
+ public:
+  struct Options {
+    kj::Duration interval = 60 * kj::SECONDS;
+
+    // Only this many native types, by retained size, are reported per isolate, to keep metric
+    // cardinality bounded.
+    uint maxTypes = 20;
+  };
+
+  MemoryReporter(
+      kj::Timer& timer, Options options, kj::Function<void(kj::StringPtr json)> onReport);
+
+  void registerIsolate(kj::StringPtr name, const Worker::Isolate& isolate);
+
+  // Collects a report every `interval`. Never resolves.
+  kj::Promise<void> run();
+
+  // Collects a report from every live isolate now. Exposed for tests.
+  kj::Promise<void> collect();
+
+  // Appends gauges for the latest reports, in Prometheus text format.
+  void renderPrometheus(kj::Vector<kj::String>& lines) const;
+
+ private:
+  kj::Timer& timer;
+  Options options;
+  kj::Function<void(kj::StringPtr)> onReport;
+
+  kj::HashMap<kj::String, kj::Own<const Worker::Isolate::WeakIsolateRef>> isolates;
+  kj::HashMap<kj::String, Worker::Isolate::MemoryReport> latest;
+};
+
+}  // namespace workerd::server
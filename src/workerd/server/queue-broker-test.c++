@@ -0,0 +1,156 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "queue-broker.h"
+
+#include <kj/async-io.h>
+#include <kj/encoding.h>
+#include <kj/filesystem.h>
+#include <kj/test.h>
+
+namespace workerd::server {
+namespace {
+
+struct Delivery {
+  kj::Vector<kj::String> bodies;
+  kj::Vector<uint16_t> attempts;
+};
+
+struct QueueTest {
+  kj::AsyncIoContext io = kj::setupAsyncIo();
+  kj::Timer& timer = io.provider->getTimer();
+  const kj::Clock& clock = kj::systemPreciseCalendarClock();
+  kj::Own<const kj::Directory> dir = kj::newInMemoryDirectory(clock);
+  SqliteDatabase::Vfs vfs{*dir};
+  kj::HttpHeaderTable::Builder headerTableBuilder;
+  kj::HttpHeaderTable& headerTable = headerTableBuilder.getFutureTable();
+
+  kj::Own<QueueBroker> makeBroker(kj::StringPtr name, QueueBroker::Options options) {
+    return kj::heap<QueueBroker>(kj::str(name), clock, timer, headerTableBuilder, options);
+  }
+
+  // Delivers to `deliveries`, responding to each batch with `respond`.
+  QueueBroker::DeliverFn collect(
+      kj::Vector<Delivery>& deliveries, QueueBroker::DeliveryResult (*respond)() = nullptr) {
+    return [&deliveries, respond](kj::Array<api::IncomingQueueMessage> batch)
+               -> kj::Promise<QueueBroker::DeliveryResult> {
+      auto& delivery = deliveries.add();
+      for (auto& message: batch) {
+        delivery.bodies.add(kj::str(message.body.asChars()));
+        delivery.attempts.add(message.attempts);
+      }
+      if (respond != nullptr) return respond();
+      return QueueBroker::DeliveryResult{.outcome = EventOutcome::OK, .ackAll = true};
+    };
+  }
+
+  void waitFor(kj::FunctionParam<bool()> condition) {
+    for (auto i KJ_UNUSED: kj::zeroTo(500)) {
+      if (condition()) return;
+      timer.afterDelay(1 * kj::MILLISECONDS).wait(io.waitScope);
+    }
+    KJ_FAIL_ASSERT("timed out waiting for queue delivery");
+  }
+
+  uint send(kj::HttpClient& client, kj::StringPtr url, kj::StringPtr body) {
+    kj::HttpHeaders headers(headerTable);
+    auto request = client.request(kj::HttpMethod::POST, url, headers, body.size());
+    request.body->write(body.asBytes()).wait(io.waitScope);
+    auto response = request.response.wait(io.waitScope);
+    response.body->readAllBytes().wait(io.waitScope);
+    return response.statusCode;
+  }
+};
+
+kj::String batchOf(kj::ArrayPtr<const kj::StringPtr> bodies) {
+  auto messages = KJ_MAP(body, bodies) {
+    return kj::str(
+        "{\"body\":\"", kj::encodeBase64(body.asBytes()), "\",\"contentType\":\"text\"}");
+  };
+  return kj::str("{\"messages\":[", kj::strArray(messages, ","), "]}");
+}
+
+KJ_TEST("QueueBroker batches messages by size and by time") {
+  QueueTest test;
+  auto broker =
+      test.makeBroker("q", {.maxBatchSize = 2, .maxBatchTimeout = 50 * kj::MILLISECONDS});
+  auto table = test.headerTableBuilder.build();
+  broker->open(test.vfs, kj::Path({"q.sqlite"}));
+  auto client = kj::newHttpClient(*broker);
+
+  kj::Vector<Delivery> deliveries;
+  broker->startDelivery(test.collect(deliveries), kj::none);
+
+  auto batch = batchOf({"a"_kj, "b"_kj, "c"_kj});
+  KJ_EXPECT(test.send(*client, "https://fake-host/batch", batch) == 200);
+
+  // The first two messages fill a batch; the third goes out on its own after the timeout.
+  test.waitFor([&]() { return deliveries.size() == 2; });
+  KJ_EXPECT(deliveries[0].bodies.size() == 2);
+  KJ_EXPECT(deliveries[0].bodies[0] == "a");
+  KJ_EXPECT(deliveries[0].bodies[1] == "b");
+  KJ_EXPECT(deliveries[1].bodies.size() == 1);
+  KJ_EXPECT(deliveries[1].bodies[0] == "c");
+
+  test.waitFor([&]() { return broker->getStoredCount() == 0; });
+}
+
+KJ_TEST("QueueBroker retries with backoff and then dead-letters") {
+  QueueTest test;
+  auto dlq = test.makeBroker("dlq", {});
+  auto broker = test.makeBroker("q",
+      {.maxBatchSize = 1, .maxRetries = 2, .retryDelay = 1 * kj::MILLISECONDS});
+  auto table = test.headerTableBuilder.build();
+  dlq->open(test.vfs, kj::Path({"dlq.sqlite"}));
+  broker->open(test.vfs, kj::Path({"q.sqlite"}));
+  auto client = kj::newHttpClient(*broker);
+
+  auto retryAll = []() {
+    return QueueBroker::DeliveryResult{
+      .outcome = EventOutcome::OK, .ackAll = false, .retryBatch = {.retry = true}};
+  };
+  kj::Vector<Delivery> deliveries;
+  broker->startDelivery(test.collect(deliveries, retryAll), *dlq);
+
+  KJ_EXPECT(test.send(*client, "https://fake-host/message", "hello") == 200);
+
+  test.waitFor([&]() { return dlq->getStoredCount() == 1; });
+  KJ_EXPECT(broker->getStoredCount() == 0);
+  KJ_ASSERT(deliveries.size() == 3);
+  KJ_EXPECT(deliveries[0].attempts[0] == 1);
+  KJ_EXPECT(deliveries[1].attempts[0] == 2);
+  KJ_EXPECT(deliveries[2].attempts[0] == 3);
+}
+
+KJ_TEST("QueueBroker keeps undelivered messages across restarts") {
+  QueueTest test;
+  {
+    auto broker = test.makeBroker("q", {});
+    auto table = test.headerTableBuilder.build();
+    broker->open(test.vfs, kj::Path({"q.sqlite"}));
+    auto client = kj::newHttpClient(*broker);
+    KJ_EXPECT(test.send(*client, "https://fake-host/message", "one") == 200);
+    KJ_EXPECT(test.send(*client, "https://fake-host/message", "two") == 200);
+    KJ_EXPECT(test.send(*client, "https://fake-host/other", "") == 404);
+    KJ_EXPECT(test.send(*client, "https://fake-host/batch", "{\"messages\":") == 400);
+    KJ_EXPECT(broker->getStoredCount() == 2);
+  }
+
+  kj::HttpHeaderTable::Builder builder;
+  QueueBroker broker(kj::str("q"), test.clock, test.timer, builder,
+      {.maxBatchTimeout = 1 * kj::MILLISECONDS});
+  auto table = builder.build();
+  broker.open(test.vfs, kj::Path({"q.sqlite"}));
+  KJ_EXPECT(broker.getStoredCount() == 2);
+
+  kj::Vector<Delivery> deliveries;
+  broker.startDelivery(test.collect(deliveries), kj::none);
+  test.waitFor([&]() { return broker.getStoredCount() == 0; });
+  KJ_ASSERT(deliveries.size() == 1);
+  KJ_EXPECT(deliveries[0].bodies[0] == "one");
+  KJ_EXPECT(deliveries[0].bodies[1] == "two");
+}
+
+}  // namespace
+}  // namespace workerd::server
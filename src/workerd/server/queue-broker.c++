@@ -0,0 +1,419 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "queue-broker.h"
+
+#include <capnp/compat/json.h>
+#include <kj/debug.h>
+#include <kj/encoding.h>
+
+#include <algorithm>
+
+namespace workerd::server {
+
+namespace {
+
+int64_t toNanos(kj::Date date) {
+  return (date - kj::UNIX_EPOCH) / kj::NANOSECONDS;
+}
+
+kj::Date fromNanos(int64_t nanos) {
+  return kj::UNIX_EPOCH + nanos * kj::NANOSECONDS;
+}
+
+// Returns the last component of the URL's path. `WorkerQueue` sends to "<base URL>/message" or
+// "<base URL>/batch", where the base URL depends on the binding.
+kj::StringPtr lastPathComponent(kj::StringPtr url) {
+  KJ_IF_SOME(q, url.findFirst('?')) {
+    url = url.first(q);
+  }
+  KJ_IF_SOME(slash, url.findLast('/')) {
+    return url.slice(slash + 1);
+  }
+  return url;
+}
+
+kj::Duration parseDelay(kj::StringPtr value) {
+  auto seconds = KJ_REQUIRE_NONNULL(value.tryParseAs<uint>(), "invalid message delay", value);
+  return seconds * kj::SECONDS;
+}
+
+}  // namespace
+
+struct QueueBroker::Statements {
+  explicit Statements(SqliteDatabase& db): db(db) {}
+
+  SqliteDatabase& db;
+
+  SqliteDatabase::Statement insert = db.prepare(R"(
+    INSERT INTO _cf_QUEUE (body, content_type, enqueued_time, visible_time) VALUES (?, ?, ?, ?)
+  )");
+
+  // Returns how many messages are ready, and since when the oldest of them has been ready.
+  SqliteDatabase::Statement countReady = db.prepare(R"(
+    SELECT COUNT(*), MIN(visible_time) FROM _cf_QUEUE WHERE leased = 0 AND visible_time <= ?
+  )");
+
+  SqliteDatabase::Statement nextVisible = db.prepare(R"(
+    SELECT MIN(visible_time) FROM _cf_QUEUE WHERE leased = 0
+  )");
+
+  SqliteDatabase::Statement selectBatch = db.prepare(R"(
+    SELECT id, body, content_type, enqueued_time, attempts FROM _cf_QUEUE
+    WHERE leased = 0 AND visible_time <= ?
+    ORDER BY visible_time, id
+    LIMIT ?
+  )");
+
+  SqliteDatabase::Statement lease = db.prepare(R"(
+    UPDATE _cf_QUEUE SET leased = 1, attempts = attempts + 1 WHERE id = ?
+  )");
+
+  SqliteDatabase::Statement reschedule = db.prepare(R"(
+    UPDATE _cf_QUEUE SET leased = 0, visible_time = ? WHERE id = ?
+  )");
+
+  SqliteDatabase::Statement remove = db.prepare(R"(
+    DELETE FROM _cf_QUEUE WHERE id = ?
+  )");
+
+  SqliteDatabase::Statement selectMessage = db.prepare(R"(
+    SELECT body, content_type FROM _cf_QUEUE WHERE id = ?
+  )");
+
+  SqliteDatabase::Statement count = db.prepare(R"(
+    SELECT COUNT(*) FROM _cf_QUEUE
+  )");
+};
+
+QueueBroker::QueueBroker(kj::String name,
+    const kj::Clock& clock,
+    kj::Timer& timer,
+    kj::HttpHeaderTable::Builder& headerTableBuilder,
+    Options options)
+    : name(kj::mv(name)),
+      clock(clock),
+      timer(timer),
+      options(options),
+      headerTable(headerTableBuilder.getFutureTable()),
+      hMsgFormat(headerTableBuilder.add("X-Msg-Fmt")),
+      hMsgDelay(headerTableBuilder.add("X-Msg-Delay-Secs")) {}
+
+QueueBroker::~QueueBroker() noexcept(false) {}
+
+void QueueBroker::open(const SqliteDatabase::Vfs& vfs, kj::Path path) {
+  auto& db = *this->db.emplace(kj::heap<SqliteDatabase>(vfs, kj::mv(path),
+      kj::WriteMode::CREATE | kj::WriteMode::MODIFY | kj::WriteMode::CREATE_PARENT));
+
+  db.run("PRAGMA journal_mode=WAL;");
+  db.run(R"(
+    CREATE TABLE IF NOT EXISTS _cf_QUEUE (
+      id INTEGER PRIMARY KEY AUTOINCREMENT,
+      body BLOB,
+      content_type TEXT NOT NULL,
+      enqueued_time INTEGER NOT NULL,
+      visible_time INTEGER NOT NULL,
+      attempts INTEGER NOT NULL DEFAULT 0,
+      leased INTEGER NOT NULL DEFAULT 0
+    );
+  )");
+  db.run(R"(
+    CREATE INDEX IF NOT EXISTS _cf_QUEUE_visible_time ON _cf_QUEUE (visible_time);
+  )");
+
+  // Only one batch is ever in flight, so any message still leased was being delivered when the
+  // process last exited. The consumer may or may not have seen it; deliver it again.
+  db.run("UPDATE _cf_QUEUE SET leased = 0 WHERE leased = 1;");
+
+  statements = kj::heap<Statements>(db);
+}
+
+QueueBroker::Statements& QueueBroker::getStatements() {
+  return *KJ_REQUIRE_NONNULL(statements, "queue has not been opened");
+}
+
+void QueueBroker::startDelivery(DeliverFn deliverParam, kj::Maybe<QueueBroker&> deadLetterQueue) {
+  KJ_REQUIRE(deliver == kj::none, "queue delivery already started");
+  deliver = kj::mv(deliverParam);
+  this->deadLetterQueue = deadLetterQueue;
+  auto loop = kj::evalLater([this]() { return deliveryLoop(); });
+  deliveryTask = loop.eagerlyEvaluate(
+      [this](kj::Exception&& e) { KJ_LOG(ERROR, "queue delivery stopped", name, e); });
+}
+
+void QueueBroker::enqueue(kj::ArrayPtr<Message> messages) {
+  auto& stmts = getStatements();
+  auto now = clock.now();
+
+  stmts.db.run("BEGIN TRANSACTION");
+  KJ_ON_SCOPE_FAILURE(stmts.db.run("ROLLBACK TRANSACTION"));
+  for (auto& message: messages) {
+    stmts.insert.run(message.body.asPtr().asConst(), kj::StringPtr(message.contentType),
+        toNanos(now), toNanos(now + message.delay));
+  }
+  stmts.db.run("COMMIT TRANSACTION");
+
+  KJ_IF_SOME(fulfiller, wakeUp) {
+    fulfiller->fulfill();
+    wakeUp = kj::none;
+  }
+}
+
+uint QueueBroker::getStoredCount() {
+  auto query = getStatements().count.run();
+  return query.getInt64(0);
+}
+
+kj::Promise<void> QueueBroker::waitUntil(kj::Maybe<kj::Date> when) {
+  auto paf = kj::newPromiseAndFulfiller<void>();
+  wakeUp = kj::mv(paf.fulfiller);
+  KJ_IF_SOME(w, when) {
+    auto delay = kj::max(w - clock.now(), 0 * kj::NANOSECONDS);
+    return paf.promise.exclusiveJoin(timer.afterDelay(delay));
+  }
+  return kj::mv(paf.promise);
+}
+
+kj::Promise<void> QueueBroker::deliveryLoop() {
+  auto& stmts = getStatements();
+  for (;;) {
+    auto now = clock.now();
+
+    uint ready;
+    kj::Maybe<kj::Date> oldestReady;
+    {
+      auto query = stmts.countReady.run(toNanos(now));
+      ready = query.getInt64(0);
+      if (!query.isNull(1)) oldestReady = fromNanos(query.getInt64(1));
+    }
+
+    KJ_IF_SOME(oldest, oldestReady) {
+      // Hold small batches back until they fill up or the oldest message has waited long enough.
+      auto deadline = oldest + options.maxBatchTimeout;
+      if (ready < options.maxBatchSize && now < deadline) {
+        co_await waitUntil(deadline);
+      } else {
+        co_await deliverBatch(now);
+      }
+    } else {
+      kj::Maybe<kj::Date> next;
+      {
+        auto query = stmts.nextVisible.run();
+        if (!query.isNull(0)) next = fromNanos(query.getInt64(0));
+      }
+      co_await waitUntil(next);
+    }
+  }
+}
+
+kj::Promise<void> QueueBroker::deliverBatch(kj::Date now) {
+  auto& stmts = getStatements();
+
+  kj::Vector<int64_t> ids(options.maxBatchSize);
+  kj::Vector<uint> attempts(options.maxBatchSize);
+  kj::Vector<api::IncomingQueueMessage> batch(options.maxBatchSize);
+  {
+    auto query = stmts.selectBatch.run(toNanos(now), static_cast<int64_t>(options.maxBatchSize));
+    while (!query.isDone()) {
+      auto id = query.getInt64(0);
+      auto contentType = query.getText(2);
+      ids.add(id);
+      attempts.add(query.getInt64(4) + 1);
+      batch.add(api::IncomingQueueMessage{
+        .id = kj::str(id),
+        .timestamp = fromNanos(query.getInt64(3)),
+        .body = kj::heapArray(query.getBlob(1)),
+        .contentType = contentType.size() == 0 ? kj::Maybe<kj::String>() : kj::str(contentType),
+        .attempts = static_cast<uint16_t>(kj::min(attempts.back(), 0xffffu)),
+      });
+      query.nextRow();
+    }
+  }
+
+  stmts.db.run("BEGIN TRANSACTION");
+  {
+    KJ_ON_SCOPE_FAILURE(stmts.db.run("ROLLBACK TRANSACTION"));
+    for (auto id: ids) stmts.lease.run(id);
+    stmts.db.run("COMMIT TRANSACTION");
+  }
+
+  kj::Maybe<DeliveryResult> result;
+  try {
+    result = co_await KJ_ASSERT_NONNULL(deliver)(batch.releaseAsArray());
+  } catch (...) {
+    auto exception = kj::getCaughtExceptionAsKj();
+    KJ_LOG(WARNING, "queue consumer threw an exception", name, exception);
+  }
+
+  recordResult(ids, attempts, kj::mv(result));
+}
+
+void QueueBroker::recordResult(kj::ArrayPtr<const int64_t> ids,
+    kj::ArrayPtr<const uint> attempts,
+    kj::Maybe<DeliveryResult> result) {
+  auto& stmts = getStatements();
+  auto now = clock.now();
+
+  stmts.db.run("BEGIN TRANSACTION");
+  KJ_ON_SCOPE_FAILURE(stmts.db.run("ROLLBACK TRANSACTION"));
+
+  for (auto i: kj::indices(ids)) {
+    // Individual calls to retry() or ack() take precedence over retryAll() and ackAll(), which
+    // take precedence over the outcome. If the consumer failed, everything it didn't explicitly
+    // ack is retried.
+    bool retry = true;
+    kj::Maybe<int> delaySeconds;
+    KJ_IF_SOME(r, result) {
+      auto id = kj::str(ids[i]);
+      bool explicitRetry = false;
+      for (auto& message: r.retryMessages) {
+        if (message.msgId == id) {
+          explicitRetry = true;
+          delaySeconds = message.delaySeconds;
+          break;
+        }
+      }
+      if (explicitRetry) {
+        retry = true;
+      } else if (std::find(r.explicitAcks.begin(), r.explicitAcks.end(), id) !=
+          r.explicitAcks.end()) {
+        retry = false;
+      } else if (r.outcome != EventOutcome::OK) {
+        retry = true;
+      } else if (r.ackAll) {
+        retry = false;
+      } else if (r.retryBatch.retry) {
+        retry = true;
+        delaySeconds = r.retryBatch.delaySeconds;
+      } else {
+        retry = false;
+      }
+    }
+
+    if (retry) {
+      retryOrDeadLetter(ids[i], attempts[i], delaySeconds, now);
+    } else {
+      stmts.remove.run(ids[i]);
+    }
+  }
+
+  stmts.db.run("COMMIT TRANSACTION");
+}
+
+void QueueBroker::retryOrDeadLetter(
+    int64_t id, uint attempts, kj::Maybe<int> delaySeconds, kj::Date now) {
+  auto& stmts = getStatements();
+
+  if (attempts > options.maxRetries) {
+    KJ_IF_SOME(dlq, deadLetterQueue) {
+      auto query = stmts.selectMessage.run(id);
+      Message message{
+        .body = kj::heapArray(query.getBlob(0)),
+        .contentType = kj::str(query.getText(1)),
+      };
+      dlq.enqueue(kj::arrayPtr(message));
+    } else {
+      KJ_LOG(WARNING, "dropping queue message after exhausting retries", name, id, attempts);
+    }
+    stmts.remove.run(id);
+    return;
+  }
+
+  auto delay = options.retryDelay * (int64_t(1) << kj::min(attempts - 1, RETRY_BACKOFF_MAX));
+  KJ_IF_SOME(seconds, delaySeconds) {
+    delay = kj::max(seconds, 0) * kj::SECONDS;
+  }
+  stmts.reschedule.run(toNanos(now + delay), id);
+}
+
+kj::Array<QueueBroker::Message> QueueBroker::parseMessage(
+    const kj::HttpHeaders& headers, kj::Array<kj::byte> body) {
+  auto message = kj::heapArray<Message>(1);
+  message[0].body = kj::mv(body);
+  message[0].contentType = kj::str(headers.get(hMsgFormat).orDefault(""));
+  KJ_IF_SOME(delay, headers.get(hMsgDelay)) {
+    message[0].delay = parseDelay(delay);
+  }
+  return message;
+}
+
+kj::Array<QueueBroker::Message> QueueBroker::parseBatch(
+    const kj::HttpHeaders& headers, kj::StringPtr body) {
+  auto defaultDelay = 0 * kj::SECONDS;
+  KJ_IF_SOME(delay, headers.get(hMsgDelay)) {
+    defaultDelay = parseDelay(delay);
+  }
+
+  capnp::JsonCodec json;
+  capnp::MallocMessageBuilder arena;
+  auto root = arena.initRoot<capnp::JsonValue>();
+  json.decodeRaw(body, root);
+  KJ_REQUIRE(root.isObject(), "queue batch must be a JSON object");
+
+  for (auto field: root.asReader().getObject()) {
+    if (field.getName() != "messages") continue;
+    auto value = field.getValue();
+    KJ_REQUIRE(value.isArray(), "queue batch messages must be an array");
+
+    return KJ_MAP(element, value.getArray()) {
+      KJ_REQUIRE(element.isObject(), "queue batch message must be a JSON object");
+      Message message{.contentType = kj::str(), .delay = defaultDelay};
+      bool hasBody = false;
+      for (auto messageField: element.getObject()) {
+        auto fieldName = messageField.getName();
+        auto fieldValue = messageField.getValue();
+        if (fieldName == "body") {
+          KJ_REQUIRE(fieldValue.isString(), "queue message body must be a string");
+          auto decoded = kj::decodeBase64(fieldValue.getString());
+          KJ_REQUIRE(!decoded.hadErrors, "queue message body must be base64");
+          message.body = kj::mv(decoded);
+          hasBody = true;
+        } else if (fieldName == "contentType") {
+          KJ_REQUIRE(fieldValue.isString(), "queue message contentType must be a string");
+          message.contentType = kj::str(fieldValue.getString());
+        } else if (fieldName == "delaySecs") {
+          KJ_REQUIRE(fieldValue.isNumber() && fieldValue.getNumber() >= 0,
+              "queue message delaySecs must be a non-negative number");
+          message.delay = static_cast<int64_t>(fieldValue.getNumber()) * kj::SECONDS;
+        }
+      }
+      KJ_REQUIRE(hasBody, "queue message has no body");
+      return message;
+    };
+  }
+
+  KJ_FAIL_REQUIRE("queue batch has no messages");
+}
+
+kj::Promise<void> QueueBroker::request(kj::HttpMethod method,
+    kj::StringPtr url,
+    const kj::HttpHeaders& headers,
+    kj::AsyncInputStream& requestBody,
+    Response& response) {
+  kj::HttpHeaders responseHeaders(headerTable);
+  if (method != kj::HttpMethod::POST) {
+    co_return co_await response.sendError(405, "Method Not Allowed", responseHeaders);
+  }
+
+  auto kind = lastPathComponent(url);
+  if (kind != "message" && kind != "batch") {
+    co_return co_await response.sendError(404, "Not Found", responseHeaders);
+  }
+
+  auto body = co_await requestBody.readAllBytes();
+
+  kj::Maybe<kj::Array<Message>> messages;
+  KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() {
+    messages = kind == "message" ? parseMessage(headers, kj::mv(body))
+                                 : parseBatch(headers, kj::str(body.asChars()));
+  })) {
+    KJ_LOG(INFO, "malformed queue send", name, exception);
+    co_return co_await response.sendError(400, "Bad Request", responseHeaders);
+  }
+
+  enqueue(KJ_ASSERT_NONNULL(messages));
+  response.send(200, "OK", responseHeaders, static_cast<uint64_t>(0));
+}
+
+}  // namespace workerd::server
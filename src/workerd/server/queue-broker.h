@@ -0,0 +1,135 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <workerd/api/queue.h>
+#include <workerd/io/worker-interface.h>
+#include <workerd/util/sqlite.h>
+
+#include <kj/async.h>
+#include <kj/compat/http.h>
+#include <kj/function.h>
+#include <kj/time.h>
+#include <kj/timer.h>
+
+namespace workerd::server {
+
+// A durable message queue, backing the `queue` service type in the config.
+//
+// Producers send to it over HTTP using the same protocol `WorkerQueue` uses for any queue
+// binding (`POST /message` and `POST /batch`). Messages are stored in SQLite and delivered in
+// batches to a consumer, which is called once at least `maxBatchSize` messages are ready or the
+// oldest ready message has waited `maxBatchTimeout`. Messages the consumer retries are delivered
+// again after a backoff, and once they have been retried `maxRetries` times they are moved to a
+// dead letter queue, if there is one, or dropped.
+//
+// Delivery is at-least-once: one batch is in flight at a time, and its messages are marked as
+// leased before the consumer is called. If the process exits before the consumer's response has
+// been recorded, leased messages are delivered again the next time the queue is opened.
+class QueueBroker final: public kj::HttpService {
+ public:
+  // Upper bound on the retry backoff, as a power of two times `retryDelay`.
+  static constexpr uint RETRY_BACKOFF_MAX = 10;
+
+  struct Options {
+    uint maxBatchSize = 10;
+    kj::Duration maxBatchTimeout = 5 * kj::SECONDS;
+    uint maxRetries = 3;
+    kj::Duration retryDelay = 1 * kj::SECONDS;
+  };
+
+  struct Message {
+    kj::Array<kj::byte> body;
+
+    // One of the `IncomingQueueMessage::ContentType` values.
+    kj::String contentType;
+
+    kj::Duration delay = 0 * kj::SECONDS;
+  };
+
+  // The consumer's response to a batch, as reported by `QueueCustomEventImpl`.
+  struct DeliveryResult {
+    EventOutcome outcome;
+    bool ackAll;
+    api::QueueRetryBatch retryBatch;
+    kj::Array<kj::String> explicitAcks;
+    kj::Array<api::QueueRetryMessage> retryMessages;
+  };
+
+  using DeliverFn =
+      kj::Function<kj::Promise<DeliveryResult>(kj::Array<api::IncomingQueueMessage> batch)>;
+
+  QueueBroker(kj::String name,
+      const kj::Clock& clock,
+      kj::Timer& timer,
+      kj::HttpHeaderTable::Builder& headerTableBuilder,
+      Options options);
+  ~QueueBroker() noexcept(false);
+  KJ_DISALLOW_COPY_AND_MOVE(QueueBroker);
+
+  // Opens (creating if necessary) the database the queue is stored in. Must be called before
+  // anything else, after the header table has been built.
+  void open(const SqliteDatabase::Vfs& vfs, kj::Path path);
+
+  // Starts delivering stored messages to `deliver`, beginning on a later turn of the event loop.
+  // Messages which exhaust their retries are enqueued to `deadLetterQueue`, which must be opened
+  // by then and must outlive this broker. Without a call to `startDelivery()`, messages are only
+  // stored.
+  void startDelivery(DeliverFn deliver, kj::Maybe<QueueBroker&> deadLetterQueue);
+
+  // Stores messages atomically.
+  void enqueue(kj::ArrayPtr<Message> messages);
+
+  kj::StringPtr getName() const {
+    return name;
+  }
+
+  // Number of messages stored, including ones currently being delivered. Exposed for tests.
+  uint getStoredCount();
+
+  kj::Promise<void> request(kj::HttpMethod method,
+      kj::StringPtr url,
+      const kj::HttpHeaders& headers,
+      kj::AsyncInputStream& requestBody,
+      Response& response) override;
+
+ private:
+  kj::String name;
+  const kj::Clock& clock;
+  kj::Timer& timer;
+  Options options;
+  kj::HttpHeaderTable& headerTable;
+  kj::HttpHeaderId hMsgFormat;
+  kj::HttpHeaderId hMsgDelay;
+
+  struct Statements;
+  kj::Maybe<kj::Own<SqliteDatabase>> db;
+  kj::Maybe<kj::Own<Statements>> statements;
+
+  kj::Maybe<DeliverFn> deliver;
+  kj::Maybe<QueueBroker&> deadLetterQueue;
+
+  // Fulfilled by `enqueue()` to wake up the delivery loop.
+  kj::Maybe<kj::Own<kj::PromiseFulfiller<void>>> wakeUp;
+  kj::Promise<void> deliveryTask = nullptr;
+
+  Statements& getStatements();
+
+  kj::Promise<void> deliveryLoop();
+  kj::Promise<void> deliverBatch(kj::Date now);
+
+  // Resolves at `when`, or as soon as a message is enqueued.
+  kj::Promise<void> waitUntil(kj::Maybe<kj::Date> when);
+
+  void recordResult(kj::ArrayPtr<const int64_t> ids,
+      kj::ArrayPtr<const uint> attempts,
+      kj::Maybe<DeliveryResult> result);
+  void retryOrDeadLetter(int64_t id, uint attempts, kj::Maybe<int> delaySeconds, kj::Date now);
+
+  kj::Array<Message> parseMessage(const kj::HttpHeaders& headers, kj::Array<kj::byte> body);
+  kj::Array<Message> parseBatch(const kj::HttpHeaders& headers, kj::StringPtr body);
+};
+
+}  // namespace workerd::server
@@ -0,0 +1,94 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "runtime-metrics.h"
+
+#include <kj/async-io.h>
+#include <kj/test.h>
+
+namespace workerd::server {
+namespace {
+
+KJ_TEST("RuntimeMetrics records isolate lock timing") {
+  auto io = kj::setupAsyncIo();
+  RuntimeMetrics metrics(io.provider->getTimer(), {}, [](kj::StringPtr) {});
+
+  auto observer = metrics.makeIsolateObserver("my \"worker\"");
+  {
+    IsolateObserver::LockRecord record(
+        observer->tryCreateLockTiming(kj::Maybe<RequestObserver&>(kj::none)));
+    record.locked();
+  }
+  {
+    // A lock that was never acquired counts as neither waiting nor holding.
+    IsolateObserver::LockRecord record(
+        observer->tryCreateLockTiming(kj::Maybe<RequestObserver&>(kj::none)));
+  }
+
+  auto text = metrics.renderPrometheus();
+  KJ_EXPECT(text.contains("# TYPE workerd_isolate_lock_wait_seconds histogram\n"), text);
+  KJ_EXPECT(
+      text.contains("workerd_isolate_lock_wait_seconds_count{isolate=\"my \\\"worker\\\"\"} 1\n"),
+      text);
+  KJ_EXPECT(
+      text.contains("workerd_isolate_lock_hold_seconds_count{isolate=\"my \\\"worker\\\"\"} 1\n"),
+      text);
+  KJ_EXPECT(
+      text.contains("workerd_isolate_lock_hold_seconds_bucket{isolate=\"my \\\"worker\\\"\","
+                    "le=\"+Inf\"} 1\n"),
+      text);
+  KJ_EXPECT(text.contains("workerd_event_loop_lag_seconds_count 0\n"), text);
+
+  auto json = metrics.renderJson();
+  KJ_EXPECT(json.startsWith("{\"eventLoopLag\":{\"count\":0,"), json);
+  KJ_EXPECT(json.contains(
+                "\"isolates\":[{\"name\":\"my \\\"worker\\\"\",\"lockWait\":{\"count\":1,"),
+      json);
+}
+
+KJ_TEST("RuntimeMetrics samples the event loop") {
+  auto io = kj::setupAsyncIo();
+  auto& timer = io.provider->getTimer();
+  kj::Vector<kj::String> reports;
+  RuntimeMetrics metrics(timer,
+      {.sampleInterval = 1 * kj::MILLISECONDS, .reportInterval = 20 * kj::MILLISECONDS},
+      [&](kj::StringPtr json) { reports.add(kj::str(json)); });
+
+  auto running = metrics.run().eagerlyEvaluate(nullptr);
+  timer.afterDelay(50 * kj::MILLISECONDS).wait(io.waitScope);
+
+  KJ_EXPECT(metrics.getSchedulingLag().snapshot().count > 0);
+  KJ_EXPECT(metrics.getTurnDuration().snapshot().count > 0);
+  KJ_ASSERT(reports.size() > 0);
+  KJ_EXPECT(reports[0].startsWith("{\"eventLoopLag\":{"), reports[0]);
+}
+
+KJ_TEST("RuntimeMetrics serves Prometheus text at /metrics") {
+  auto io = kj::setupAsyncIo();
+  RuntimeMetrics metrics(io.provider->getTimer(), {}, [](kj::StringPtr) {});
+  metrics.getSchedulingLag().record(3 * kj::MICROSECONDS);
+
+  kj::HttpHeaderTable headerTable;
+  auto service = metrics.makeHttpService(headerTable);
+  auto client = kj::newHttpClient(*service);
+
+  {
+    auto response = client->request(kj::HttpMethod::GET, "/metrics", kj::HttpHeaders(headerTable))
+                        .response.wait(io.waitScope);
+    KJ_EXPECT(response.statusCode == 200);
+    auto body = response.body->readAllText().wait(io.waitScope);
+    KJ_EXPECT(body.contains("workerd_event_loop_lag_seconds_bucket{le=\"4e-06\"} 1\n"), body);
+    KJ_EXPECT(body.contains("workerd_event_loop_lag_seconds_count 1\n"), body);
+  }
+
+  {
+    auto response = client->request(kj::HttpMethod::GET, "/", kj::HttpHeaders(headerTable))
+                        .response.wait(io.waitScope);
+    KJ_EXPECT(response.statusCode == 404);
+    response.body->readAllText().wait(io.waitScope);
+  }
+}
+
+}  // namespace
+}  // namespace workerd::server
@@ -0,0 +1,236 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "runtime-metrics.h"
+
+#include <kj/debug.h>
+
+namespace workerd::server {
+
+namespace {
+
+double toSeconds(kj::Duration duration) {
+  return static_cast<double>(duration / kj::NANOSECONDS) / 1e9;
+}
+
+void renderHistogram(kj::Vector<kj::String>& lines,
+    kj::StringPtr name,
+    kj::StringPtr labels,
+    const util::DurationHistogram::Snapshot& snapshot) {
+  auto sep = labels.size() == 0 ? ""_kj : ","_kj;
+
+  // Buckets above the highest non-empty one add nothing over `+Inf`, so leave them out.
+  uint last = 0;
+  for (uint i = 0; i < util::DurationHistogram::BUCKET_COUNT; i++) {
+    if (snapshot.buckets[i] != 0) last = i;
+  }
+
+  uint64_t cumulative = 0;
+  for (uint i = 0; i <= last; i++) {
+    cumulative += snapshot.buckets[i];
+    lines.add(kj::str(name, "_bucket{", labels, sep, "le=\"",
+        toSeconds(util::DurationHistogram::bucketUpperBound(i)), "\"} ", cumulative));
+  }
+  lines.add(kj::str(name, "_bucket{", labels, sep, "le=\"+Inf\"} ", snapshot.count));
+  if (labels.size() == 0) {
+    lines.add(kj::str(name, "_sum ", toSeconds(snapshot.sum)));
+    lines.add(kj::str(name, "_count ", snapshot.count));
+  } else {
+    lines.add(kj::str(name, "_sum{", labels, "} ", toSeconds(snapshot.sum)));
+    lines.add(kj::str(name, "_count{", labels, "} ", snapshot.count));
+  }
+}
+
+void renderHeader(kj::Vector<kj::String>& lines, kj::StringPtr name, kj::StringPtr help) {
+  lines.add(kj::str("# HELP ", name, " ", help));
+  lines.add(kj::str("# TYPE ", name, " histogram"));
+}
+
+kj::TimePoint preciseNow() {
+  return kj::systemPreciseMonotonicClock().now();
+}
+
+}  // namespace
+
+// Measures one isolate lock. A LockTiming is created before the lock is requested, so the time
+// until `locked()` includes any time spent queued behind other requests for the async lock, not
+// just time blocked on the isolate mutex.
+class RuntimeMetrics::LockTiming final: public IsolateObserver::LockTiming {
+ public:
+  explicit LockTiming(IsolateLockStats& stats): stats(stats), created(preciseNow()) {}
+
+  void locked() override {
+    auto now = preciseNow();
+    stats.wait.record(now - created);
+    lockedAt = now;
+  }
+
+  void stop() override {
+    KJ_IF_SOME(l, lockedAt) {
+      stats.hold.record(preciseNow() - l);
+    }
+  }
+
+ private:
+  // The isolate, and therefore its observer and stats, outlive any lock on it.
+  IsolateLockStats& stats;
+  kj::TimePoint created;
+  kj::Maybe<kj::TimePoint> lockedAt;
+};
+
+class RuntimeMetrics::Observer final: public IsolateObserver {
+ public:
+  explicit Observer(kj::Own<IsolateLockStats> statsParam)
+      : stats(*statsParam),
+        ownStats(kj::mv(statsParam)) {}
+
+  kj::Maybe<kj::Own<IsolateObserver::LockTiming>> tryCreateLockTiming(
+      kj::OneOf<SpanParent, kj::Maybe<RequestObserver&>> parentOrRequest) const override {
+    return kj::Own<IsolateObserver::LockTiming>(kj::heap<RuntimeMetrics::LockTiming>(stats));
+  }
+
+ private:
+  // Histograms are updated from const methods, which is fine since they are thread-safe.
+  IsolateLockStats& stats;
+  kj::Own<IsolateLockStats> ownStats;
+};
+
+class RuntimeMetrics::HttpService final: public kj::HttpService {
+ public:
+  HttpService(const RuntimeMetrics& metrics, kj::HttpHeaderTable& headerTable)
+      : metrics(metrics),
+        headerTable(headerTable) {}
+
+  kj::Promise<void> request(kj::HttpMethod method,
+      kj::StringPtr url,
+      const kj::HttpHeaders& headers,
+      kj::AsyncInputStream& requestBody,
+      Response& response) override {
+    kj::HttpHeaders responseHeaders(headerTable);
+    if (method != kj::HttpMethod::GET || (url != "/metrics" && !url.startsWith("/metrics?"))) {
+      co_return co_await response.sendError(404, "Not Found", responseHeaders);
+    }
+
+    auto body = metrics.renderPrometheus();
+    responseHeaders.setPtr(kj::HttpHeaderId::CONTENT_TYPE, "text/plain; version=0.0.4");
+    auto stream = response.send(200, "OK", responseHeaders, body.size());
+    co_await stream->write(body.asBytes());
+  }
+
+ private:
+  const RuntimeMetrics& metrics;
+  kj::HttpHeaderTable& headerTable;
+};
+
+RuntimeMetrics::RuntimeMetrics(
+    kj::Timer& timer, Options options, kj::Function<void(kj::StringPtr json)> onReport)
+    : timer(timer),
+      options(options),
+      onReport(kj::mv(onReport)) {}
+
+kj::Own<IsolateObserver> RuntimeMetrics::makeIsolateObserver(kj::StringPtr isolateName) {
+  auto stats = kj::atomicRefcounted<IsolateLockStats>();
+  stats->name = kj::str(isolateName);
+  auto observer = kj::atomicRefcounted<Observer>(kj::atomicAddRef(*stats));
+  isolates.add(kj::mv(stats));
+  return observer;
+}
+
+kj::String RuntimeMetrics::escapeQuoted(kj::StringPtr text) {
+  // Control characters never appear in service names in practice, so rather than encode them we
+  // just replace them.
+  kj::Vector<char> escaped(text.size() + 1);
+  for (char c: text) {
+    if (c == '"' || c == '\\') {
+      escaped.add('\\');
+      escaped.add(c);
+    } else if (static_cast<uint8_t>(c) < 0x20) {
+      escaped.add('_');
+    } else {
+      escaped.add(c);
+    }
+  }
+  escaped.add('\0');
+  return kj::String(escaped.releaseAsArray());
+}
+
+void RuntimeMetrics::addPrometheusSource(
+    kj::Function<void(kj::Vector<kj::String>& lines)> source) {
+  prometheusSources.add(kj::mv(source));
+}
+
+kj::Promise<void> RuntimeMetrics::run() {
+  return kj::joinPromisesFailFast(kj::arr(sampleLoop(), reportLoop()));
+}
+
+kj::Promise<void> RuntimeMetrics::sampleLoop() {
+  for (;;) {
+    auto due = preciseNow() + options.sampleInterval;
+    co_await timer.afterDelay(options.sampleInterval);
+    auto woke = preciseNow();
+    schedulingLag.record(kj::max(woke - due, 0 * kj::NANOSECONDS));
+
+    // Everything that was ready before us runs before we resume.
+    co_await kj::yield();
+    turnDuration.record(preciseNow() - woke);
+  }
+}
+
+kj::Promise<void> RuntimeMetrics::reportLoop() {
+  for (;;) {
+    co_await timer.afterDelay(options.reportInterval);
+    auto json = renderJson();
+    KJ_LOG(INFO, "runtime metrics", json);
+    onReport(json);
+  }
+}
+
+kj::String RuntimeMetrics::renderPrometheus() const {
+  kj::Vector<kj::String> lines;
+
+  renderHeader(lines, "workerd_event_loop_lag_seconds",
+      "How late event loop timers fire relative to when they were due.");
+  renderHistogram(lines, "workerd_event_loop_lag_seconds", "", schedulingLag.snapshot());
+
+  renderHeader(lines, "workerd_event_loop_turn_seconds",
+      "Time to process the events already queued when a new event is queued.");
+  renderHistogram(lines, "workerd_event_loop_turn_seconds", "", turnDuration.snapshot());
+
+  renderHeader(lines, "workerd_isolate_lock_wait_seconds",
+      "Time from requesting an isolate lock until it was acquired.");
+  for (auto& isolate: isolates) {
+    renderHistogram(lines, "workerd_isolate_lock_wait_seconds",
+        kj::str("isolate=\"", escapeQuoted(isolate->name), "\""), isolate->wait.snapshot());
+  }
+
+  renderHeader(lines, "workerd_isolate_lock_hold_seconds", "Time an isolate lock was held.");
+  for (auto& isolate: isolates) {
+    renderHistogram(lines, "workerd_isolate_lock_hold_seconds",
+        kj::str("isolate=\"", escapeQuoted(isolate->name), "\""), isolate->hold.snapshot());
+  }
+
+  for (auto& source: prometheusSources) {
+    source(lines);
+  }
+
+  lines.add(nullptr);
+  return kj::strArray(lines, "\n");
+}
+
+kj::String RuntimeMetrics::renderJson() const {
+  auto isolateJson = KJ_MAP(isolate, isolates) {
+    return kj::str("{\"name\":\"", escapeQuoted(isolate->name),
+        "\",\"lockWait\":", isolate->wait.snapshot().toJson(),
+        ",\"lockHold\":", isolate->hold.snapshot().toJson(), "}");
+  };
+  return kj::str("{\"eventLoopLag\":", schedulingLag.snapshot().toJson(),
+      ",\"eventLoopTurn\":", turnDuration.snapshot().toJson(), ",\"isolates\":[",
+      kj::strArray(isolateJson, ","), "]}");
+}
+
+kj::Own<kj::HttpService> RuntimeMetrics::makeHttpService(kj::HttpHeaderTable& headerTable) const {
+  return kj::heap<HttpService>(*this, headerTable);
+}
+
+}  // namespace workerd::server
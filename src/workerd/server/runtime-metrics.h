@@ -0,0 +1,102 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <workerd/io/observer.h>
+#include <workerd/util/histogram.h>
+
+#include <kj/async.h>
+#include <kj/compat/http.h>
+#include <kj/function.h>
+#include <kj/timer.h>
+#include <kj/vector.h>
+
+namespace workerd::server {
+
+// Built-in runtime instrumentation for workerd, used to tell apart tail latency caused by lock
+// contention from tail latency caused by blocking work on the event loop.
+//
+// Records, as histograms:
+// - Event loop scheduling lag: how late a timer fires relative to when it was due.
+// - Event loop turn duration: how long it takes to get through the events that were ready at the
+//   time a new event was queued.
+// - Per isolate, how long each isolate lock waited (including time queued for the async lock) and
+//   how long it was then held.
+//
+// The histograms are reported periodically via `onReport` and can be scraped in Prometheus text
+// format from the HTTP service returned by `makeHttpService()`.
+class RuntimeMetrics final {
+ public:
+  struct Options {
+    // How often the event loop is sampled.
+    kj::Duration sampleInterval = 100 * kj::MILLISECONDS;
+
+    // How often a summary is passed to `onReport`.
+    kj::Duration reportInterval = 60 * kj::SECONDS;
+  };
+
+  // `onReport` is called with a single-line JSON summary every `reportInterval`.
+  RuntimeMetrics(
+      kj::Timer& timer, Options options, kj::Function<void(kj::StringPtr json)> onReport);
+  KJ_DISALLOW_COPY_AND_MOVE(RuntimeMetrics);
+
+  // Returns an IsolateObserver for a new isolate which records its lock timing. Must be called on
+  // the thread that calls the render methods.
+  kj::Own<IsolateObserver> makeIsolateObserver(kj::StringPtr isolateName);
+
+  // Adds a callback which appends more metrics, in Prometheus text format, whenever
+  // `renderPrometheus()` is called.
+  void addPrometheusSource(kj::Function<void(kj::Vector<kj::String>& lines)> source);
+
+  // Samples the event loop and reports summaries. Never resolves.
+  kj::Promise<void> run();
+
+  kj::String renderPrometheus() const;
+  kj::String renderJson() const;
+
+  // Returns an HTTP service which serves `renderPrometheus()` at `/metrics`.
+  kj::Own<kj::HttpService> makeHttpService(kj::HttpHeaderTable& headerTable) const;
+
+  // Escapes `text` for use inside double quotes, both as a Prometheus label value and as a JSON
+  // string.
+  static kj::String escapeQuoted(kj::StringPtr text);
+
+  // Exposed for tests.
+  util::DurationHistogram& getSchedulingLag() {
+    return schedulingLag;
+  }
+  util::DurationHistogram& getTurnDuration() {
+    return turnDuration;
+  }
+
+ private:
+  kj::Timer& timer;
+  Options options;
+  kj::Function<void(kj::StringPtr)> onReport;
+
+  util::DurationHistogram schedulingLag;
+  util::DurationHistogram turnDuration;
+
+  // Shared between the isolate's observer (which may outlive the server, e.g. while deferred
+  // proxying finishes) and this object.
+  struct IsolateLockStats: public kj::AtomicRefcounted {
+    kj::String name;
+    util::DurationHistogram wait;
+    util::DurationHistogram hold;
+  };
+  kj::Vector<kj::Own<IsolateLockStats>> isolates;
+
+  // `renderPrometheus()` is const, but rendering never changes what the sources report.
+  mutable kj::Vector<kj::Function<void(kj::Vector<kj::String>&)>> prometheusSources;
+
+  class Observer;
+  class LockTiming;
+  class HttpService;
+
+  kj::Promise<void> sampleLoop();
+  kj::Promise<void> reportLoop();
+};
+
+}  // namespace workerd::server
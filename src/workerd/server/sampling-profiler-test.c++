@@ -0,0 +1,75 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "sampling-profiler.h"
+
+#include <workerd/tests/test-fixture.h>
+
+#include <kj/test.h>
+
+namespace workerd::server {
+namespace {
+
+// Keeps the isolate busy in a named function for long enough to be sampled many times. (Date.now()
+// doesn't advance while JavaScript runs, so this counts iterations rather than time.)
+constexpr kj::StringPtr BUSY_MODULE = R"SCRIPT(
+  function busy() {
+    let x = 0;
+    for (let i = 0; i < 50000000; i++) x += Math.sqrt(i);
+    return x;
+  }
+  export default {
+    fetch(request) { return new Response(String(busy())); },
+  };
+)SCRIPT"_kj;
+
+KJ_TEST("SamplingProfiler writes a profile of each registered isolate") {
+  auto io = kj::setupAsyncIo();
+  TestFixture fixture({.waitScope = io.waitScope, .mainModuleSource = BUSY_MODULE});
+
+  auto dir = kj::newInMemoryDirectory(kj::nullClock());
+  auto& dirRef = *dir;
+  kj::Vector<kj::String> written;
+  SamplingProfiler profiler(io.provider->getTimer(), kj::mv(dir),
+      {.samplingInterval = 100 * kj::MICROSECONDS, .flushInterval = 1 * kj::HOURS},
+      [&](kj::StringPtr fileName) { written.add(kj::str(fileName)); });
+  profiler.registerIsolate("test", fixture.getIsolate());
+
+  // Nothing is written while the profiler is stopped.
+  profiler.flush().wait(io.waitScope);
+  KJ_EXPECT(written.empty());
+
+  profiler.toggle();
+  KJ_EXPECT(profiler.isRunning());
+  // Let the profiler start on the isolate before running anything.
+  io.waitScope.poll();
+
+  auto response = fixture.runRequest(kj::HttpMethod::GET, "http://www.example.com", "");
+  KJ_EXPECT(response.statusCode == 200);
+
+  profiler.flush().wait(io.waitScope);
+  KJ_ASSERT(written.size() == 1);
+  auto profile = dirRef.openFile(kj::Path({written[0]}))->readAllText();
+  kj::StringPtr remaining = profile;
+  while (remaining.size() > 0) {
+    // Every stack starts with the isolate's name and ends with its sample count.
+    auto end = KJ_ASSERT_NONNULL(remaining.findFirst('\n'));
+    auto line = kj::str(remaining.slice(0, end));
+    KJ_EXPECT(line.startsWith("test;"), line);
+    KJ_EXPECT(line.findLast(' ') != kj::none, line);
+    remaining = remaining.slice(end + 1);
+  }
+  KJ_EXPECT(profile.contains("busy"), profile);
+
+  // Stopping writes out whatever was sampled since the last flush, then nothing more.
+  profiler.toggle();
+  KJ_EXPECT(!profiler.isRunning());
+  io.waitScope.poll();
+  size_t writtenWhenStopped = written.size();
+  profiler.flush().wait(io.waitScope);
+  KJ_EXPECT(written.size() == writtenWhenStopped);
+}
+
+}  // namespace
+}  // namespace workerd::server
@@ -0,0 +1,108 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "sampling-profiler.h"
+
+#include <kj/debug.h>
+#include <kj/time.h>
+#include <kj/vector.h>
+
+namespace workerd::server {
+
+SamplingProfiler::SamplingProfiler(kj::Timer& timer,
+    kj::Own<const kj::Directory> outputDir,
+    Options options,
+    kj::Function<void(kj::StringPtr fileName)> onWrite)
+    : timer(timer),
+      outputDir(kj::mv(outputDir)),
+      options(options),
+      onWrite(kj::mv(onWrite)),
+      tasks(*this) {}
+
+void SamplingProfiler::registerIsolate(kj::StringPtr name, const Worker::Isolate& isolate) {
+  isolates.upsert(kj::str(name), isolate.getWeakRef());
+  if (running) {
+    tasks.add(isolate.startSamplingProfiler(options.samplingInterval)
+                  .attach(kj::atomicAddRef(isolate)));
+  }
+}
+
+void SamplingProfiler::toggle() {
+  if (running) {
+    running = false;
+    flushLoop = kj::none;
+    tasks.add(flush(false));
+    KJ_LOG(INFO, "CPU profiler stopped");
+  } else {
+    running = true;
+    flushLoop = start().eagerlyEvaluate([this](kj::Exception&& e) { taskFailed(kj::mv(e)); });
+    KJ_LOG(INFO, "CPU profiler started");
+  }
+}
+
+kj::Promise<void> SamplingProfiler::start() {
+  kj::Vector<kj::Own<const Worker::Isolate>> live;
+  for (auto& entry: isolates) {
+    KJ_IF_SOME(isolate, entry.value->tryAddStrongRef()) {
+      live.add(kj::mv(isolate));
+    }
+  }
+  for (auto& isolate: live) {
+    co_await isolate->startSamplingProfiler(options.samplingInterval);
+  }
+
+  for (;;) {
+    co_await timer.afterDelay(options.flushInterval);
+    co_await flush();
+  }
+}
+
+kj::Promise<void> SamplingProfiler::flush(bool restart) {
+  struct LiveIsolate {
+    kj::String name;
+    kj::Own<const Worker::Isolate> isolate;
+  };
+  kj::Vector<LiveIsolate> live;
+  kj::Vector<kj::String> dead;
+  for (auto& entry: isolates) {
+    KJ_IF_SOME(isolate, entry.value->tryAddStrongRef()) {
+      live.add(LiveIsolate{.name = kj::str(entry.key), .isolate = kj::mv(isolate)});
+    } else {
+      dead.add(kj::str(entry.key));
+    }
+  }
+  for (auto& name: dead) {
+    isolates.erase(name);
+  }
+
+  kj::Vector<char> content;
+  for (auto& entry: live) {
+    auto stacks = co_await entry.isolate->collectSamplingProfile(restart);
+    // Prefix each line with the isolate's name, so that a single flamegraph can show all isolates
+    // side by side.
+    kj::StringPtr remaining = stacks;
+    while (remaining.size() > 0) {
+      auto end = remaining.findFirst('\n').orDefault(remaining.size());
+      content.addAll(entry.name);
+      content.add(';');
+      content.addAll(remaining.slice(0, end));
+      content.add('\n');
+      remaining = remaining.slice(kj::min(end + 1, remaining.size()));
+    }
+  }
+  if (content.empty()) co_return;
+
+  auto now = (kj::systemPreciseCalendarClock().now() - kj::UNIX_EPOCH) / kj::MILLISECONDS;
+  auto fileName = kj::str("cpu-", now, "-", fileCounter++, ".folded");
+  outputDir
+      ->openFile(kj::Path({fileName}), kj::WriteMode::CREATE | kj::WriteMode::MODIFY)
+      ->writeAll(content.asPtr().asBytes());
+  onWrite(fileName);
+}
+
+void SamplingProfiler::taskFailed(kj::Exception&& exception) {
+  KJ_LOG(ERROR, "CPU profiler failed", exception);
+}
+
+}  // namespace workerd::server
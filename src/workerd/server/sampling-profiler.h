@@ -0,0 +1,71 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <workerd/io/worker.h>
+
+#include <kj/async.h>
+#include <kj/filesystem.h>
+#include <kj/function.h>
+#include <kj/map.h>
+#include <kj/timer.h>
+
+namespace workerd::server {
+
+// Continuous sampling CPU profiler for all isolates in the server.
+//
+// While running, every isolate registered with the profiler has V8's sampling profiler enabled,
+// and every `flushInterval` the aggregated stacks of all isolates are written to a new file in
+// `outputDir` in collapsed-stack format, with the isolate name as the outermost frame. Unlike
+// the inspector, this needs no debugger connection and does not stop the isolate, so it can be
+// toggled on a production host without disturbing traffic.
+class SamplingProfiler final: private kj::TaskSet::ErrorHandler {
+ public:
+  struct Options {
+    // How often V8 samples the stack of a running isolate.
+    kj::Duration samplingInterval = 1 * kj::MILLISECONDS;
+
+    // How often the profile is written to disk.
+    kj::Duration flushInterval = 60 * kj::SECONDS;
+  };
+
+  // `onWrite` is called with the name of each profile file after it has been written.
+  SamplingProfiler(kj::Timer& timer,
+      kj::Own<const kj::Directory> outputDir,
+      Options options,
+      kj::Function<void(kj::StringPtr fileName)> onWrite);
+
+  void registerIsolate(kj::StringPtr name, const Worker::Isolate& isolate);
+
+  bool isRunning() const {
+    return running;
+  }
+
+  // Starts profiling if stopped, or writes out a final profile and stops if running.
+  void toggle();
+
+  // Collects and writes out a profile immediately. Exposed for tests.
+  kj::Promise<void> flush(bool restart = true);
+
+ private:
+  kj::Timer& timer;
+  kj::Own<const kj::Directory> outputDir;
+  Options options;
+  kj::Function<void(kj::StringPtr)> onWrite;
+
+  kj::HashMap<kj::String, kj::Own<const Worker::Isolate::WeakIsolateRef>> isolates;
+  bool running = false;
+  uint fileCounter = 0;
+
+  // The periodic flush loop, present while running.
+  kj::Maybe<kj::Promise<void>> flushLoop;
+  kj::TaskSet tasks;
+
+  kj::Promise<void> start();
+
+  void taskFailed(kj::Exception&& exception) override;
+};
+
+}  // namespace workerd::server
@@ -11,8 +11,10 @@
 #include <kj/async-queue.h>
 #include <kj/test.h>
 
+#include <atomic>
 #include <cstdlib>
 #include <regex>
+#include <thread>
 
 namespace workerd::server {
 namespace {
@@ -789,6 +791,215 @@ KJ_TEST("Server: compatibility dates are required") {
   )"_blockquote);
 }
 
+KJ_TEST("Server: errors from Workers built in parallel are reported in config order") {
+  TestServer test(R"((
+    services = [
+      ( name = "a",
+        worker = (serviceWorkerScript = "")
+      ),
+      ( name = "b" ),
+      ( name = "c",
+        worker = (serviceWorkerScript = "")
+      ),
+    ]
+  ))"_kj);
+
+  test.expectErrors(R"(
+    service a: Worker must specify compatibilityDate.
+    Service named "b" does not specify what to serve.
+    service c: Worker must specify compatibilityDate.
+  )"_blockquote);
+}
+
+// Holds each Worker that parses its script until `expected` Workers are parsing at once, which can
+// only happen if they're being compiled at the same time.
+struct ParseBarrier {
+  uint expected;
+  kj::MutexGuarded<uint> arrived{0};
+  // The number of Workers which saw the others arrive, rather than timing out.
+  std::atomic<uint> met = 0;
+};
+
+class ParseBarrierObserver final: public IsolateObserver {
+ public:
+  explicit ParseBarrierObserver(ParseBarrier& barrier): barrier(barrier) {}
+
+  kj::Own<Parse> parse(StartType startType) const override {
+    ++*barrier.arrived.lockExclusive();
+    bool allArrived = barrier.arrived.when(
+        [&](const uint& arrived) { return arrived >= barrier.expected; },
+        [&](uint& arrived) { return arrived >= barrier.expected; }, 10 * kj::SECONDS);
+    if (allArrived) ++barrier.met;
+    return IsolateObserver::parse(startType);
+  }
+
+ private:
+  ParseBarrier& barrier;
+};
+
+KJ_TEST("Server: many Workers are compiled in parallel") {
+  constexpr uint WORKER_COUNT = 4;
+
+  kj::Vector<kj::String> services;
+  kj::Vector<kj::String> sockets;
+  for (auto i: kj::zeroTo(WORKER_COUNT)) {
+    services.add(kj::str(R"(
+      ( name = "w)", i, R"(",
+        worker = (
+          compatibilityDate = "2022-08-17",
+          serviceWorkerScript =
+              `addEventListener("fetch", event => {
+              `  event.respondWith(new Response("w)", i, R"("));
+              `})
+        )
+      ))"));
+    sockets.add(kj::str(R"(
+      ( name = "w)", i, R"(", address = "w)", i, R"(-addr", service = "w)", i, R"(" ))"));
+  }
+  TestServer test(kj::str("(services = [", kj::strArray(services, ","), "], sockets = [",
+      kj::strArray(sockets, ","), "])"));
+
+  // There's one build thread per core, so that many Workers must be compiled at once.
+  uint threadCount = kj::max(std::thread::hardware_concurrency(), 1u);
+  ParseBarrier barrier{.expected = kj::min(WORKER_COUNT, threadCount)};
+  test.server.overrideIsolateObserver([&](kj::StringPtr name) -> kj::Own<IsolateObserver> {
+    return kj::atomicRefcounted<ParseBarrierObserver>(barrier);
+  });
+  test.start();
+  KJ_EXPECT(barrier.met == WORKER_COUNT);
+
+  for (auto i: kj::zeroTo(WORKER_COUNT)) {
+    auto conn = test.connect(kj::str("w", i, "-addr"));
+    conn.httpGet200("/", kj::str("w", i));
+  }
+}
+
+KJ_TEST("Server: lazy Worker starts on first request and stops when idle") {
+  TestServer test(singleWorker(R"((
+    compatibilityDate = "2022-08-17",
+    lazy = true,
+    lazyIdleTimeoutMs = 10000,
+    serviceWorkerScript =
+        `let count = 0;
+        `addEventListener("fetch", event => {
+        `  event.respondWith(new Response("count: " + ++count));
+        `})
+  ))"_kj));
+
+  test.start();
+  auto conn = test.connect("test-addr");
+  conn.httpGet200("/", "count: 1");
+  conn.httpGet200("/", "count: 2");
+
+  // Once the Worker has been idle for long enough it's stopped, so the next request starts it
+  // afresh.
+  test.wait(11);
+  conn.httpGet200("/", "count: 1");
+}
+
+KJ_TEST("Server: lazy Worker restarts with the inspector enabled") {
+  TestServer test(singleWorker(R"((
+    compatibilityDate = "2022-08-17",
+    lazy = true,
+    lazyIdleTimeoutMs = 10000,
+    serviceWorkerScript =
+        `let count = 0;
+        `addEventListener("fetch", event => {
+        `  event.respondWith(new Response("count: " + ++count));
+        `})
+  ))"_kj));
+
+  // Each start registers the new isolate with the inspector under the same name.
+  test.server.enableInspector(kj::str("127.0.0.1:0"));
+  test.start();
+  auto conn = test.connect("test-addr");
+  conn.httpGet200("/", "count: 1");
+
+  test.wait(11);
+  conn.httpGet200("/", "count: 1");
+}
+
+KJ_TEST("Server: lazy Worker that failed to start is started again by the next request") {
+  TestServer test(R"((
+    services = [
+      ( name = "front",
+        worker = (
+          compatibilityDate = "2022-08-17",
+          modules = [
+            ( name = "main.js",
+              esModule =
+                `export default {
+                `  async fetch(request, env) {
+                `    try {
+                `      return await env.LAZY.fetch(request);
+                `    } catch (e) {
+                `      let failed = e.message.includes("transient startup failure");
+                `      return new Response(failed ? "start failed" : e.message);
+                `    }
+                `  }
+                `}
+            )
+          ],
+          bindings = [ ( name = "LAZY", service = "lazy" ) ],
+        )
+      ),
+      ( name = "lazy",
+        worker = (
+          compatibilityDate = "2022-08-17",
+          lazy = true,
+          bindings = [ ( name = "FAIL", fromEnvironment = "LAZY_WORKER_TEST_FAIL" ) ],
+          serviceWorkerScript =
+              `if (FAIL === "1") throw new Error("transient startup failure");
+              `addEventListener("fetch", event => {
+              `  event.respondWith(new Response("started"));
+              `})
+        )
+      ),
+    ],
+    sockets = [ ( name = "main", address = "test-addr", service = "front" ) ]
+  ))"_kj);
+
+  test.start();
+  auto conn = test.connect("test-addr");
+
+#if _WIN32
+  _putenv("LAZY_WORKER_TEST_FAIL=1");
+#else
+  setenv("LAZY_WORKER_TEST_FAIL", "1", true);
+#endif
+  conn.httpGet200("/", "start failed");
+
+  // The failure isn't remembered, so once the cause is gone the Worker starts.
+#if _WIN32
+  _putenv("LAZY_WORKER_TEST_FAIL=");
+#else
+  unsetenv("LAZY_WORKER_TEST_FAIL");
+#endif
+  conn.httpGet200("/", "started");
+  conn.httpGet200("/", "started");
+}
+
+KJ_TEST("Server: lazy Worker cannot implement Durable Objects") {
+  TestServer test(singleWorker(R"((
+    compatibilityDate = "2022-08-17",
+    lazy = true,
+    modules = [
+      ( name = "main.js",
+        esModule =
+          `export class MyActorClass {}
+      )
+    ],
+    durableObjectNamespaces = [
+      ( className = "MyActorClass", uniqueKey = "mykey" ),
+    ],
+    durableObjectStorage = (inMemory = void),
+  ))"_kj));
+
+  test.expectErrors(R"(
+    Worker service "hello" is lazy, but lazy Workers cannot implement Durable Object namespaces.
+  )"_blockquote);
+}
+
 KJ_TEST("Server: value bindings") {
 #if _WIN32
   _putenv("TEST_ENVIRONMENT_VAR=Hello from environment variable");
@@ -6,6 +6,11 @@
 
 #include "bundle-fs.h"
 #include "container-client.h"
+#include "dns-cache.h"
+#include "memory-reporter.h"
+#include "queue-broker.h"
+#include "runtime-metrics.h"
+#include "sampling-profiler.h"
 #include "workerd-api.h"
 
 #include <workerd/api/actor-state.h>
@@ -48,9 +53,12 @@
 #include <kj/encoding.h>
 #include <kj/glob-filter.h>
 #include <kj/map.h>
+#include <kj/thread.h>
 
+#include <atomic>
 #include <cstdlib>
 #include <ctime>
+#include <thread>
 
 namespace workerd::server {
 
@@ -984,6 +992,16 @@ kj::Own<Server::Service> Server::makeNetworkService(config::Network::Reader conf
     return a;
   }, KJ_MAP(a, conf.getDeny()) -> kj::StringPtr { return a; });
 
+  if (conf.hasDnsCache()) {
+    auto cacheConf = conf.getDnsCache();
+    restrictedNetwork = kj::heap<DnsCachingNetwork>(kj::mv(restrictedNetwork), timer,
+        DnsCachingNetwork::Options{
+          .positiveTtl = cacheConf.getPositiveTtlMs() * kj::MILLISECONDS,
+          .negativeTtl = cacheConf.getNegativeTtlMs() * kj::MILLISECONDS,
+          .maxEntries = cacheConf.getMaxEntries(),
+        });
+  }
+
   kj::Maybe<kj::Own<kj::Network>> tlsNetwork;
   kj::Maybe<kj::SecureNetworkWrapper&> tlsContext;
   if (conf.hasTlsOptions()) {
@@ -1296,6 +1314,168 @@ kj::Own<Server::Service> Server::makeDiskDirectoryService(kj::StringPtr name,
 
 // =======================================================================================
 
+// A built-in queue. Producers reach it through `queue` bindings, which speak the same HTTP
+// protocol as any other queue broker; the QueueBroker stores the messages and feeds them back to
+// the consumer Worker as `queue` events.
+class Server::QueueService final: public Service, private WorkerInterface {
+ public:
+  QueueService(Server& server,
+      kj::StringPtr name,
+      config::Queue::Reader conf,
+      kj::HttpHeaderTable::Builder& headerTableBuilder)
+      : server(server),
+        conf(conf),
+        broker(kj::str(name),
+            kj::systemPreciseCalendarClock(),
+            server.timer,
+            headerTableBuilder,
+            {
+              .maxBatchSize = kj::max(conf.getMaxBatchSize(), 1u),
+              .maxBatchTimeout = conf.getMaxBatchTimeoutMs() * kj::MILLISECONDS,
+              .maxRetries = conf.getMaxRetries(),
+              .retryDelay = conf.getRetryDelayMs() * kj::MILLISECONDS,
+            }) {}
+
+  void link(Worker::ValidationErrorReporter& errorReporter) override {
+    auto name = broker.getName();
+
+    auto storage = conf.getStorage();
+    kj::Own<SqliteDatabase::Vfs> vfs;
+    if (storage.isLocalDisk()) {
+      kj::StringPtr diskName = storage.getLocalDisk();
+      KJ_IF_SOME(svc, server.services.find(diskName)) {
+        auto diskSvc = dynamic_cast<DiskDirectoryService*>(svc.get());
+        if (diskSvc == nullptr) {
+          errorReporter.addError(kj::str("Queue \"", name, "\" refers to the storage service \"",
+              diskName, "\", but that service is not a local disk service."));
+          return;
+        } else KJ_IF_SOME(dir, diskSvc->getWritable()) {
+          vfs = kj::heap<SqliteDatabase::Vfs>(dir);
+        } else {
+          errorReporter.addError(kj::str("Queue \"", name, "\" refers to the disk service \"",
+              diskName, "\", but that service is defined read-only."));
+          return;
+        }
+      } else {
+        errorReporter.addError(kj::str("Queue \"", name, "\" refers to a storage service \"",
+            diskName, "\", but no such service is defined."));
+        return;
+      }
+    } else {
+      auto dir = kj::newInMemoryDirectory(kj::systemPreciseCalendarClock());
+      vfs = kj::heap<SqliteDatabase::Vfs>(*dir).attach(kj::mv(dir));
+    }
+    broker.open(*vfs, kj::Path({kj::str(name, ".queue.sqlite")}));
+    ownVfs = kj::mv(vfs);
+
+    kj::Maybe<QueueBroker&> deadLetterQueue;
+    if (conf.hasDeadLetterQueue()) {
+      kj::StringPtr dlqName = conf.getDeadLetterQueue();
+      KJ_IF_SOME(svc, server.services.find(dlqName)) {
+        auto queueSvc = dynamic_cast<QueueService*>(svc.get());
+        if (queueSvc == nullptr) {
+          errorReporter.addError(kj::str("Queue \"", name, "\" refers to the dead letter queue \"",
+              dlqName, "\", but that service is not a queue."));
+        } else if (queueSvc == this) {
+          errorReporter.addError(
+              kj::str("Queue \"", name, "\" cannot be its own dead letter queue."));
+        } else {
+          deadLetterQueue = queueSvc->broker;
+        }
+      } else {
+        errorReporter.addError(kj::str("Queue \"", name, "\" refers to a dead letter queue \"",
+            dlqName, "\", but no such service is defined."));
+      }
+    }
+
+    if (conf.hasConsumer()) {
+      consumer = server.lookupService(conf.getConsumer(), kj::str("Queue \"", name, "\""));
+      broker.startDelivery(
+          [this](kj::Array<api::IncomingQueueMessage> batch) { return deliver(kj::mv(batch)); },
+          deadLetterQueue);
+    }
+  }
+
+  void unlink() override {
+    consumer = kj::none;
+  }
+
+  kj::Own<WorkerInterface> startRequest(IoChannelFactory::SubrequestMetadata metadata) override {
+    return {this, kj::NullDisposer::instance};
+  }
+
+  bool hasHandler(kj::StringPtr handlerName) override {
+    return handlerName == "fetch"_kj;
+  }
+
+ private:
+  Server& server;
+  config::Queue::Reader conf;
+  kj::Maybe<kj::Own<SqliteDatabase::Vfs>> ownVfs;
+  kj::Maybe<kj::Own<Service>> consumer;
+  QueueBroker broker;
+
+  kj::Promise<QueueBroker::DeliveryResult> deliver(kj::Array<api::IncomingQueueMessage> batch) {
+    auto& service = *KJ_REQUIRE_NONNULL(consumer, "queue consumer has been unlinked");
+    auto worker = service.startRequest({});
+    auto event = kj::refcounted<api::QueueCustomEventImpl>(api::QueueEvent::Params{
+      .queueName = kj::str(broker.getName()),
+      .messages = kj::mv(batch),
+    });
+
+    auto result = co_await worker->customEvent(kj::addRef(*event));
+    co_return QueueBroker::DeliveryResult{
+      .outcome = result.outcome,
+      .ackAll = event->getAckAll(),
+      .retryBatch = event->getRetryBatch(),
+      .explicitAcks = event->getExplicitAcks(),
+      .retryMessages = event->getRetryMessages(),
+    };
+  }
+
+  kj::Promise<void> request(kj::HttpMethod method,
+      kj::StringPtr url,
+      const kj::HttpHeaders& headers,
+      kj::AsyncInputStream& requestBody,
+      kj::HttpService::Response& response) override {
+    TRACE_EVENT("workerd", "QueueService::request()", "url", url.cStr());
+    return broker.request(method, url, headers, requestBody, response);
+  }
+
+  kj::Promise<void> connect(kj::StringPtr host,
+      const kj::HttpHeaders& headers,
+      kj::AsyncIoStream& connection,
+      kj::HttpService::ConnectResponse& response,
+      kj::HttpConnectSettings settings) override {
+    throwUnsupported();
+  }
+  kj::Promise<void> prewarm(kj::StringPtr url) override {
+    return kj::READY_NOW;
+  }
+  kj::Promise<ScheduledResult> runScheduled(kj::Date scheduledTime, kj::StringPtr cron) override {
+    throwUnsupported();
+  }
+  kj::Promise<AlarmResult> runAlarm(kj::Date scheduledTime, uint32_t retryCount) override {
+    throwUnsupported();
+  }
+  kj::Promise<CustomEvent::Result> customEvent(kj::Own<CustomEvent> event) override {
+    return event->notSupported();
+  }
+
+  [[noreturn]] void throwUnsupported() {
+    JSG_FAIL_REQUIRE(Error, "Queue services don't support this event type.");
+  }
+};
+
+kj::Own<Server::Service> Server::makeQueueService(kj::StringPtr name,
+    config::Queue::Reader conf,
+    kj::HttpHeaderTable::Builder& headerTableBuilder) {
+  TRACE_EVENT("workerd", "Server::makeQueueService()");
+  return kj::refcounted<QueueService>(*this, name, conf, headerTableBuilder);
+}
+
+// =======================================================================================
+
 // This class exists to update the InspectorService's table of isolates when a config
 // has multiple services. The InspectorService exists on the stack of its own thread and
 // initializes state that is bound to the thread, e.g. a http server and an event loop.
@@ -1311,7 +1491,7 @@ class Server::InspectorServiceIsolateRegistrar final {
   InspectorServiceIsolateRegistrar() {}
   ~InspectorServiceIsolateRegistrar() noexcept(true);
 
-  void registerIsolate(kj::StringPtr name, Worker::Isolate* isolate);
+  void registerIsolate(kj::StringPtr name, const Worker::Isolate& isolate);
 
   KJ_DISALLOW_COPY_AND_MOVE(InspectorServiceIsolateRegistrar);
 
@@ -1513,8 +1693,9 @@ class Server::InspectorService final: public kj::HttpService, public kj::HttpSer
     co_return co_await server.listenHttp(*listener);
   }
 
-  void registerIsolate(kj::StringPtr name, Worker::Isolate* isolate) {
-    isolates.insert(kj::str(name), isolate->getWeakRef());
+  void registerIsolate(kj::StringPtr name, const Worker::Isolate& isolate) {
+    // A lazy Worker registers a new isolate under the same name each time it restarts.
+    isolates.upsert(kj::str(name), isolate.getWeakRef());
   }
 
  private:
@@ -1535,7 +1716,7 @@ Server::InspectorServiceIsolateRegistrar::~InspectorServiceIsolateRegistrar() no
 }
 
 void Server::InspectorServiceIsolateRegistrar::registerIsolate(
-    kj::StringPtr name, Worker::Isolate* isolate) {
+    kj::StringPtr name, const Worker::Isolate& isolate) {
   auto lockedInspectorService = this->inspectorService.lockExclusive();
   if (lockedInspectorService != nullptr) {
     auto is = const_cast<InspectorService*>(*lockedInspectorService);
@@ -1677,15 +1858,16 @@ class WorkerTracerSpanObserver: public SpanObserver,
 
   void report(const Span& span) override {
     KJ_IF_SOME(tracer, this->workerTracer) {
-      kj::HashMap<kj::ConstString, tracing::Attribute::Value> tags;
+      tracer->addSpan([&]() {
+        kj::HashMap<kj::ConstString, tracing::Attribute::Value> tags;
 
-      for (const auto& tag: span.tags) {
-        tags.insert(kj::ConstString(kj::str(tag.key)), spanTagClone(tag.value));
-      }
+        for (const auto& tag: span.tags) {
+          tags.insert(kj::ConstString(kj::str(tag.key)), spanTagClone(tag.value));
+        }
 
-      CompleteSpan completeSpan(0, 0, kj::ConstString(kj::str(span.operationName)), span.startTime,
-          span.endTime, kj::mv(tags));
-      tracer->addSpan(kj::mv(completeSpan));
+        return CompleteSpan(0, 0, kj::ConstString(kj::str(span.operationName)), span.startTime,
+            span.endTime, kj::mv(tags));
+      });
     }
   }
 
@@ -1814,6 +1996,17 @@ struct Server::DynamicErrorReporter final: public ErrorReporter {
   }
 };
 
+// Implementation of ErrorReporter for Workers from the config which are built in parallel at
+// startup. The errors are collected and later reported through a ConfigErrorReporter, in config
+// order.
+struct Server::DeferredErrorReporter final: public ErrorReporter {
+  kj::Vector<kj::String> errors;
+
+  void addError(kj::String error) override {
+    errors.add(kj::mv(error));
+  }
+};
+
 class Server::WorkerService final: public Service,
                                    private kj::TaskSet::ErrorHandler,
                                    private IoChannelFactory,
@@ -1861,6 +2054,13 @@ class Server::WorkerService final: public Service,
   // done during the constructor.
   void initActorNamespaces(
       const kj::HashMap<kj::String, ActorConfig>& actorClasses, kj::Network& network) {
+    KJ_IF_SOME(path, dockerPath) {
+      // All container-enabled namespaces in this worker share one Docker API client, and thus
+      // one pool of keep-alive connections to the Docker socket.
+      dockerClient = kj::refcounted<DockerApiClient>(
+          threadContext.getUnsafeTimer(), network, kj::str(path));
+    }
+
     actorNamespaces.reserve(actorClasses.size());
     for (auto& entry: actorClasses) {
       if (!actorClassEntrypoints.contains(entry.key)) {
@@ -1874,9 +2074,9 @@ class Server::WorkerService final: public Service,
       }
 
       auto actorClass = kj::refcounted<ActorClassImpl>(*this, entry.key, Frankenvalue());
-      auto ns =
-          kj::heap<ActorNamespace>(kj::mv(actorClass), entry.value, threadContext.getUnsafeTimer(),
-              threadContext.getByteStreamFactory(), network, dockerPath, waitUntilTasks);
+      auto ns = kj::heap<ActorNamespace>(kj::mv(actorClass), entry.value,
+          threadContext.getUnsafeTimer(), threadContext.getByteStreamFactory(), dockerClient,
+          waitUntilTasks);
       actorNamespaces.insert(entry.key, kj::mv(ns));
     }
   }
@@ -2113,16 +2313,30 @@ class Server::WorkerService final: public Service,
         const ActorConfig& config,
         kj::Timer& timer,
         capnp::ByteStreamFactory& byteStreamFactory,
-        kj::Network& dockerNetwork,
-        kj::Maybe<kj::StringPtr> dockerPath,
+        kj::Maybe<kj::Own<DockerApiClient>>& dockerClient,
         kj::TaskSet& waitUntilTasks)
         : actorClass(kj::mv(actorClass)),
           config(config),
           timer(timer),
           byteStreamFactory(byteStreamFactory),
-          dockerNetwork(dockerNetwork),
-          dockerPath(dockerPath),
-          waitUntilTasks(waitUntilTasks) {}
+          dockerClient(dockerClient.map([](auto& c) { return kj::addRef(*c); })),
+          waitUntilTasks(waitUntilTasks) {
+      KJ_IF_SOME(d, config.tryGet<Durable>()) {
+        KJ_IF_SOME(options, d.containerOptions) {
+          KJ_IF_SOME(docker, this->dockerClient) {
+            if (options.getWarmPoolSize() > 0) {
+              containerPool = kj::refcounted<ContainerPool>(kj::addRef(*docker),
+                  kj::str("workerd-", d.uniqueKey, "-warm-"), kj::str(options.getImageName()),
+                  ContainerPool::Options{
+                    .size = options.getWarmPoolSize(),
+                    .prestart = options.getPrestartWarmContainers(),
+                  },
+                  waitUntilTasks);
+            }
+          }
+        }
+      }
+    }
 
     // Called at link time to provide needed resources.
     void link(kj::Maybe<const kj::Directory&> serviceActorStorage,
@@ -2136,12 +2350,22 @@ class Server::WorkerService final: public Service,
       }
 
       this->alarmScheduler = alarmScheduler;
+
+      KJ_IF_SOME(pool, containerPool) {
+        pool->fill();
+      }
     }
 
     const ActorConfig& getConfig() {
       return config;
     }
 
+    kj::Maybe<const ContainerPool&> getContainerPool() {
+      return containerPool.map([](kj::Own<ContainerPool>& pool) -> const ContainerPool& {
+        return *pool;
+      });
+    }
+
     kj::Own<IoChannelFactory::ActorChannel> getActorChannel(Worker::Actor::Id id) {
       KJ_IF_SOME(doId, id.tryGet<kj::Own<ActorIdFactory::ActorId>>()) {
         // To emulate production, we have to recreate this ID.
@@ -2310,6 +2534,18 @@ class Server::WorkerService final: public Service,
             co_await promise;
           }
 
+          KJ_IF_SOME(index, getFacetTreeIndexForStart()) {
+            // Our facet ID may have just been assigned. It has to be on disk before we create
+            // storage under it, but facets starting in the same turn share one sync.
+            co_await index.whenDurable();
+          }
+
+          if (actor != kj::none) {
+            // Someone else started the actor while we waited.
+            co_return KJ_ASSERT_NONNULL(actor)->addRef();
+          }
+          requireNotBroken();
+
           start(actorClass, id);
         }
 
@@ -2452,6 +2688,16 @@ class Server::WorkerService final: public Service,
         return index.getId(parent.getFacetId(), key);
       }
 
+      // If this is a facet with backing storage, assign its ID and return the index it was
+      // assigned in, so that the caller can wait for the ID to be durable.
+      kj::Maybe<FacetTreeIndex&> getFacetTreeIndexForStart() {
+        if (parent == kj::none || ns.actorStorage == kj::none || !ns.config.is<Durable>()) {
+          return kj::none;
+        }
+        getFacetId();
+        return root.ensureFacetTreeIndex();
+      }
+
       // Get the facet tree index, opening the file if it hasn't been opened yet, and creating it
       // if it hasn't been created yet.
       FacetTreeIndex& ensureFacetTreeIndex() {
@@ -2684,7 +2930,7 @@ class Server::WorkerService final: public Service,
 
         kj::Maybe<rpc::Container::Client> containerClient = kj::none;
         KJ_IF_SOME(config, containerOptions) {
-          auto& dockerPathRef = KJ_ASSERT_NONNULL(ns.dockerPath,
+          auto& docker = KJ_ASSERT_NONNULL(ns.dockerClient,
               "dockerPath needs to be defined in order enable containers on this durable object.");
           KJ_ASSERT(config.hasImageName(), "Image name is required");
           auto imageName = config.getImageName();
@@ -2697,10 +2943,11 @@ class Server::WorkerService final: public Service,
               containerId = kj::str(existingId);
             }
           }
-          containerClient = kj::heap<ContainerClient>(ns.byteStreamFactory, timer, ns.dockerNetwork,
-              kj::str(dockerPathRef),
+          containerClient = kj::heap<ContainerClient>(ns.byteStreamFactory, timer,
+              kj::addRef(*docker),
               kj::str("workerd-", KJ_ASSERT_NONNULL(uniqueKey), "-", containerId),
-              kj::str(imageName), ns.waitUntilTasks);
+              kj::str(imageName), ns.containerPool.map([](auto& p) { return p->addRef(); }),
+              ns.waitUntilTasks);
         }
 
         auto actor = actorClass->newActor(getTracker(), Worker::Actor::cloneId(id),
@@ -2774,9 +3021,9 @@ class Server::WorkerService final: public Service,
     kj::Maybe<kj::Promise<void>> cleanupTask;
     kj::Timer& timer;
     capnp::ByteStreamFactory& byteStreamFactory;
-    kj::Network& dockerNetwork;
-    kj::Maybe<kj::StringPtr> dockerPath;
+    kj::Maybe<kj::Own<DockerApiClient>> dockerClient;
     kj::TaskSet& waitUntilTasks;
+    kj::Maybe<kj::Own<ContainerPool>> containerPool;
     kj::Maybe<AlarmScheduler&> alarmScheduler;
 
     // Removes actors from `actors` after 70 seconds of last access.
@@ -2944,6 +3191,7 @@ class Server::WorkerService final: public Service,
   kj::TaskSet waitUntilTasks;
   AbortActorsCallback abortActorsCallback;
   kj::Maybe<kj::String> dockerPath;
+  kj::Maybe<kj::Own<DockerApiClient>> dockerClient;
 
   class ActorChannelImpl final: public IoChannelFactory::ActorChannel {
    public:
@@ -3432,6 +3680,27 @@ static kj::Maybe<WorkerdApi::Global> createBinding(kj::StringPtr workerName,
       return makeGlobal(Global::KvNamespace{.subrequestChannel = channel});
     }
 
+    case config::Worker::Binding::KV_NAMESPACE_WRITE_BEHIND: {
+      if (!experimental) {
+        errorReporter.addError(kj::str(
+            "Write-behind KV namespace bindings are an experimental feature which may change or go "
+            "away in the future. You must run workerd with `--experimental` to use this feature."));
+        return kj::none;
+      }
+      auto kv = binding.getKvNamespaceWriteBehind();
+      uint channel = (uint)subrequestChannels.size() + IoContext::SPECIAL_SUBREQUEST_CHANNEL_COUNT;
+      subrequestChannels.add(FutureSubrequestChannel{kv.getDesignator(), kj::mv(errorContext)});
+
+      return makeGlobal(Global::KvNamespace{
+        .subrequestChannel = channel,
+        .writeBehind =
+            Global::KvNamespace::WriteBehind{
+              .window = kv.getWindowMillis() * kj::MILLISECONDS,
+              .maxBatchBytes = kv.getMaxBatchBytes(),
+            },
+      });
+    }
+
     case config::Worker::Binding::R2_BUCKET: {
       uint channel = (uint)subrequestChannels.size() + IoContext::SPECIAL_SUBREQUEST_CHANNEL_COUNT;
       subrequestChannels.add(FutureSubrequestChannel{binding.getR2Bucket(), kj::mv(errorContext)});
@@ -3595,6 +3864,7 @@ uint startInspector(
 
 void Server::abortAllActors(kj::Maybe<const kj::Exception&> reason) {
   for (auto& service: services) {
+    // (Lazy Workers are skipped: they can't implement Durable Object namespaces.)
     if (WorkerService* worker = dynamic_cast<WorkerService*>(&*service.value)) {
       for (auto& [className, ns]: worker->getActorNamespaces()) {
         bool isEvictable = true;
@@ -3882,17 +4152,333 @@ kj::Own<WorkerStubChannel> Server::WorkerService::loadIsolate(uint loaderChannel
   return channels.workerLoaders[loaderChannel]->loadIsolate(kj::mv(name), kj::mv(fetchSource));
 }
 
-kj::Own<Server::Service> Server::makeWorker(kj::StringPtr name,
+// A Worker service declared with `lazy = true`. Its isolate isn't created, and its script isn't
+// evaluated, until the first request arrives. Requests that arrive in the meantime wait on the
+// same startup. If the config sets `lazyIdleTimeoutMs`, the Worker is stopped again once that much
+// time has passed with no requests in flight, and restarted by the next request.
+//
+// The Worker's exports aren't known until it starts, so references to its entrypoints can't be
+// checked at startup. A request to an entrypoint that doesn't exist fails instead.
+class Server::LazyWorkerService final: public Service {
+ public:
+  LazyWorkerService(Server& server,
+      kj::StringPtr name,
+      config::Worker::Reader conf,
+      capnp::List<config::Extension>::Reader extensions,
+      kj::Maybe<kj::Duration> idleTimeout)
+      : server(server),
+        name(name),
+        conf(conf),
+        extensions(extensions),
+        idleTimeout(idleTimeout),
+        observer(server.makeIsolateObserver(name)) {}
+
+  void unlink() override {
+    idleTask = kj::none;
+    stop();
+  }
+
+  kj::Own<WorkerInterface> startRequest(IoChannelFactory::SubrequestMetadata metadata) override {
+    return startRequest(kj::mv(metadata), kj::none, {});
+  }
+
+  bool hasHandler(kj::StringPtr handlerName) override {
+    KJ_IF_SOME(s, service) {
+      return s->hasHandler(handlerName);
+    } else {
+      // We don't know until the Worker has started.
+      return false;
+    }
+  }
+
+  kj::Own<Service> getEntrypoint(kj::Maybe<kj::StringPtr> name, Frankenvalue props) {
+    auto ownName = name.map([](kj::StringPtr n) { return kj::str(n); });
+    return kj::refcounted<EntrypointService>(*this, kj::mv(ownName), kj::mv(props));
+  }
+
+  // Starts the Worker, if it isn't running already.
+  kj::Promise<kj::Own<WorkerService>> whenStarted() {
+    if (service == kj::none) {
+      co_await getStartupTask().addBranch();
+    }
+    co_return kj::addRef(*KJ_ASSERT_NONNULL(service));
+  }
+
+ private:
+  class EntrypointService;
+
+  Server& server;
+  kj::StringPtr name;
+  config::Worker::Reader conf;
+  capnp::List<config::Extension>::Reader extensions;
+  kj::Maybe<kj::Duration> idleTimeout;
+
+  // Kept across restarts, so that metrics for the Worker aren't split up.
+  kj::Own<IsolateObserver> observer;
+
+  kj::Maybe<kj::Own<WorkerService>> service;  // null if not started yet
+  kj::Maybe<kj::ForkedPromise<void>> startupTask;  // resolves when `service` is non-null
+
+  // Set if `startupTask` failed, so that the next request tries to start the Worker again rather
+  // than failing the same way for the rest of the process's life.
+  bool startupFailed = false;
+
+  uint requestsInFlight = 0;
+  kj::Maybe<kj::Promise<void>> idleTask;
+
+  kj::ForkedPromise<void>& getStartupTask() {
+    KJ_IF_SOME(t, startupTask) {
+      if (!startupFailed) {
+        return t;
+      }
+    }
+    startupFailed = false;
+    return startupTask.emplace(kj::evalLater([this]() { start(); })
+            .catch_([this](kj::Exception&& e) -> kj::Promise<void> {
+      // Requests already waiting on this attempt see its error, later ones start afresh. (The
+      // failed task can't be dropped here, as we're running inside it.)
+      startupFailed = true;
+      return kj::mv(e);
+    }).fork());
+  }
+
+  kj::Own<WorkerInterface> startRequest(IoChannelFactory::SubrequestMetadata metadata,
+      kj::Maybe<kj::StringPtr> entrypointName,
+      const Frankenvalue& props) {
+    idleTask = kj::none;
+    ++requestsInFlight;
+    auto done = kj::defer([this]() {
+      if (--requestsInFlight == 0) {
+        KJ_IF_SOME(timeout, idleTimeout) {
+          idleTask = server.timer.afterDelay(timeout).then([this]() { stop(); }).eagerlyEvaluate(
+              [](kj::Exception&& e) { KJ_LOG(ERROR, "failed to stop idle Worker", e); });
+        }
+      }
+    });
+
+    KJ_IF_SOME(s, service) {
+      return startRequestImpl(*s, kj::mv(metadata), entrypointName, props).attach(kj::mv(done));
+    }
+
+    return newPromisedWorkerInterface(getStartupTask().addBranch().then(
+        [this, metadata = kj::mv(metadata),
+            entrypointName = entrypointName.map([](kj::StringPtr n) { return kj::str(n); }),
+            props = props.clone()]() mutable {
+      return startRequestImpl(*KJ_ASSERT_NONNULL(service), kj::mv(metadata), entrypointName, props);
+    })).attach(kj::mv(done));
+  }
+
+  kj::Own<WorkerInterface> startRequestImpl(WorkerService& worker,
+      IoChannelFactory::SubrequestMetadata metadata,
+      kj::Maybe<kj::StringPtr> entrypointName,
+      const Frankenvalue& props) {
+    KJ_IF_SOME(ep, worker.getEntrypoint(entrypointName, props.clone())) {
+      return ep->startRequest(kj::mv(metadata)).attach(kj::mv(ep));
+    }
+    // (getEntrypoint() only returns null for named entrypoints.)
+    JSG_FAIL_REQUIRE(Error, "Worker \"", name, "\" has no such entrypoint: ",
+        KJ_ASSERT_NONNULL(entrypointName));
+  }
+
+  void start() {
+    DynamicErrorReporter errorReporter;
+    capnp::MallocMessageBuilder arena;
+    auto def = server.makeWorkerDef(
+        name, conf, arena.initRoot<CompatibilityFlags>(), errorReporter);
+    auto worker = server.createWorker(
+        name, def, kj::atomicAddRef(*observer), extensions, errorReporter);
+    errorReporter.throwIfErrors();
+
+    auto service = server.makeWorkerService(name, kj::mv(def), kj::mv(worker), errorReporter);
+    service->link(errorReporter);
+    errorReporter.throwIfErrors();
+
+    this->service = kj::mv(service);
+  }
+
+  void stop() {
+    KJ_IF_SOME(s, service) {
+      s->unlink();
+    }
+    service = kj::none;
+    startupTask = kj::none;
+    startupFailed = false;
+  }
+};
+
+class Server::LazyWorkerService::EntrypointService final: public Service {
+ public:
+  EntrypointService(
+      LazyWorkerService& lazy, kj::Maybe<kj::String> entrypointName, Frankenvalue props)
+      : lazy(kj::addRef(lazy)),
+        entrypointName(kj::mv(entrypointName)),
+        props(kj::mv(props)) {}
+
+  kj::Own<WorkerInterface> startRequest(IoChannelFactory::SubrequestMetadata metadata) override {
+    return lazy->startRequest(kj::mv(metadata), entrypointName, props);
+  }
+
+  bool hasHandler(kj::StringPtr handlerName) override {
+    return false;
+  }
+
+  Service* service() override {
+    return lazy;
+  }
+
+ private:
+  kj::Own<LazyWorkerService> lazy;
+  kj::Maybe<kj::String> entrypointName;
+  Frankenvalue props;
+};
+
+kj::Own<Server::Service> Server::makeLazyWorker(kj::StringPtr name,
     config::Worker::Reader conf,
     capnp::List<config::Extension>::Reader extensions) {
-  TRACE_EVENT("workerd", "Server::makeWorker()", "name", name.cStr());
-  auto& localActorConfigs = KJ_ASSERT_NONNULL(actorConfigs.find(name));
+  if (conf.getDurableObjectNamespaces().size() > 0) {
+    reportConfigError(kj::str("Worker service \"", name,
+        "\" is lazy, but lazy Workers cannot implement Durable Object namespaces."));
+    return makeInvalidConfigService();
+  }
 
-  ConfigErrorReporter errorReporter(*this, name);
+  // Check the parts of the config which can be checked without starting the Worker now, so that
+  // mistakes are still reported at startup.
+  {
+    ConfigErrorReporter errorReporter(*this, name);
+    capnp::MallocMessageBuilder arena;
+    makeWorkerDef(name, conf, arena.initRoot<CompatibilityFlags>(), errorReporter);
+  }
 
-  capnp::MallocMessageBuilder arena;
+  kj::Maybe<kj::Duration> idleTimeout;
+  if (conf.getLazyIdleTimeoutMs() > 0) {
+    idleTimeout = conf.getLazyIdleTimeoutMs() * kj::MILLISECONDS;
+  }
+  return kj::refcounted<LazyWorkerService>(*this, name, conf, extensions, idleTimeout);
+}
+
+// A Worker from the config on its way to becoming a WorkerService. Creating its isolate and
+// compiling its script are a large part of startup, and touch no state shared with other
+// Workers. So startServices() prepares each Worker on the main thread, compiles them all in
+// parallel with `runWorkerBuilds()`, and then finishes them on the main thread in config order.
+//
+// Evaluating the script's top level is left to finishWorker(), as the script may create
+// promises that the Worker keeps, and those must belong to the main thread's event loop.
+struct Server::WorkerBuild {
+  WorkerBuild(kj::StringPtr name, capnp::List<config::Extension>::Reader extensions)
+      : name(name),
+        extensions(extensions) {}
+
+  kj::StringPtr name;
+  capnp::List<config::Extension>::Reader extensions;
+
+  // Holds `def.featureFlags`.
   // TODO(beta): Factor out FeatureFlags from WorkerBundle.
-  auto featureFlags = arena.initRoot<CompatibilityFlags>();
+  capnp::MallocMessageBuilder arena;
+
+  // Errors are held until the Worker is finished, so that they are reported in the same order
+  // regardless of which Workers happened to be built first.
+  DeferredErrorReporter errorReporter;
+
+  kj::Maybe<WorkerDef> def;
+  kj::Own<IsolateObserver> observer;
+
+  // Set once the Worker's script has been compiled.
+  kj::Maybe<kj::Own<const Worker::Script>> script;
+
+  // Set if preparing or compiling the Worker threw. Rethrown when the Worker is finished.
+  kj::Maybe<kj::Exception> exception;
+};
+
+kj::Own<Server::Service> Server::makeWorker(kj::StringPtr name,
+    config::Worker::Reader conf,
+    capnp::List<config::Extension>::Reader extensions) {
+  auto build = prepareWorker(name, conf, extensions);
+  runWorkerBuild(*build);
+  return finishWorker(*build);
+}
+
+kj::Own<Server::WorkerBuild> Server::prepareWorker(kj::StringPtr name,
+    config::Worker::Reader conf,
+    capnp::List<config::Extension>::Reader extensions) {
+  auto build = kj::heap<WorkerBuild>(name, extensions);
+  KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() {
+    auto featureFlags = build->arena.initRoot<CompatibilityFlags>();
+    build->def.emplace(makeWorkerDef(name, conf, featureFlags, build->errorReporter));
+    build->observer = makeIsolateObserver(name);
+  })) {
+    build->exception = kj::mv(exception);
+  }
+  return build;
+}
+
+void Server::runWorkerBuild(WorkerBuild& build) {
+  if (build.exception != kj::none) return;
+
+  KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() {
+    build.script = compileWorker(build.name, KJ_ASSERT_NONNULL(build.def), kj::mv(build.observer),
+        build.extensions, build.errorReporter);
+  })) {
+    build.exception = kj::mv(exception);
+  }
+}
+
+void Server::runWorkerBuilds(kj::ArrayPtr<kj::Own<WorkerBuild>> builds) {
+  TRACE_EVENT("workerd", "Server::runWorkerBuilds()", "count", builds.size());
+  if (builds.size() <= 1) {
+    for (auto& build: builds) {
+      runWorkerBuild(*build);
+    }
+    return;
+  }
+
+  size_t threadCount = kj::min(builds.size(), kj::max(std::thread::hardware_concurrency(), 1u));
+  std::atomic<size_t> next = 0;
+  {
+    auto threads = kj::heapArrayBuilder<kj::Own<kj::Thread>>(threadCount);
+    for (auto i KJ_UNUSED: kj::zeroTo(threadCount)) {
+      // The build threads have no event loop: compiling a script doesn't create promises, and if
+      // it ever did, failing here is better than leaving them tied to a loop that is gone.
+      threads.add(kj::heap<kj::Thread>([this, builds, &next]() {
+        for (size_t index; (index = next.fetch_add(1)) < builds.size();) {
+          runWorkerBuild(*builds[index]);
+        }
+      }));
+    }
+
+    // Destroying `threads` waits for them all to finish.
+  }
+}
+
+kj::Own<Server::Service> Server::finishWorker(WorkerBuild& build) {
+  kj::Maybe<kj::Own<Worker>> worker;
+  if (build.exception == kj::none) {
+    KJ_IF_SOME(exception, kj::runCatchingExceptions([&]() {
+      worker = instantiateWorker(build.name, KJ_ASSERT_NONNULL(build.def),
+          kj::mv(KJ_ASSERT_NONNULL(build.script)), build.errorReporter);
+    })) {
+      build.exception = kj::mv(exception);
+    }
+  }
+
+  ConfigErrorReporter configErrorReporter(*this, build.name);
+  for (auto& error: build.errorReporter.errors) {
+    configErrorReporter.addError(kj::mv(error));
+  }
+  KJ_IF_SOME(exception, build.exception) {
+    kj::throwFatalException(kj::mv(exception));
+  }
+
+  auto& def = KJ_ASSERT_NONNULL(build.def);
+  return makeWorkerService(
+      build.name, kj::mv(def), kj::mv(KJ_ASSERT_NONNULL(worker)), build.errorReporter);
+}
+
+Server::WorkerDef Server::makeWorkerDef(kj::StringPtr name,
+    config::Worker::Reader conf,
+    CompatibilityFlags::Builder featureFlags,
+    ErrorReporter& errorReporter) {
+  TRACE_EVENT("workerd", "Server::makeWorkerDef()", "name", name.cStr());
+  auto& localActorConfigs = KJ_ASSERT_NONNULL(actorConfigs.find(name));
 
   if (conf.hasCompatibilityDate()) {
     compileCompatibilityFlags(conf.getCompatibilityDate(), conf.getCompatibilityFlags(),
@@ -3966,15 +4552,43 @@ kj::Own<Server::Service> Server::makeWorker(kj::StringPtr name,
     // clang-format on
   };
 
-  return makeWorkerImpl(name, kj::mv(def), extensions, errorReporter);
+  return def;
 }
 
 kj::Own<Server::WorkerService> Server::makeWorkerImpl(kj::StringPtr name,
     WorkerDef def,
     capnp::List<config::Extension>::Reader extensions,
     ErrorReporter& errorReporter) {
+  auto worker = createWorker(name, def, makeIsolateObserver(name), extensions, errorReporter);
+  return makeWorkerService(name, kj::mv(def), kj::mv(worker), errorReporter);
+}
+
+kj::Own<IsolateObserver> Server::makeIsolateObserver(kj::StringPtr name) {
+  KJ_IF_SOME(makeObserver, isolateObserverOverride) {
+    return makeObserver(name);
+  } else KJ_IF_SOME(metrics, runtimeMetrics) {
+    return metrics->makeIsolateObserver(name);
+  } else {
+    return kj::atomicRefcounted<IsolateObserver>();
+  }
+}
+
+kj::Own<Worker> Server::createWorker(kj::StringPtr name,
+    WorkerDef& def,
+    kj::Own<IsolateObserver> observer,
+    capnp::List<config::Extension>::Reader extensions,
+    ErrorReporter& errorReporter) {
+  auto script = compileWorker(name, def, kj::mv(observer), extensions, errorReporter);
+  return instantiateWorker(name, def, kj::mv(script), errorReporter);
+}
+
+kj::Own<const Worker::Script> Server::compileWorker(kj::StringPtr name,
+    WorkerDef& def,
+    kj::Own<IsolateObserver> observer,
+    capnp::List<config::Extension>::Reader extensions,
+    ErrorReporter& errorReporter) {
+  TRACE_EVENT("workerd", "Server::compileWorker()", "name", name.cStr());
   auto jsgobserver = kj::atomicRefcounted<JsgIsolateObserver>();
-  auto observer = kj::atomicRefcounted<IsolateObserver>();
   auto limitEnforcer = kj::refcounted<NullIsolateLimitEnforcer>();
 
   // Create the FsMap that will be used to map known file system
@@ -4036,12 +4650,6 @@ kj::Own<Server::WorkerService> Server::makeWorkerImpl(kj::StringPtr name,
           : consoleMode,
       structuredLogging);
 
-  // If we are using the inspector, we need to register the Worker::Isolate
-  // with the inspector service.
-  KJ_IF_SOME(isolateRegistrar, inspectorIsolateRegistrar) {
-    isolateRegistrar->registerIsolate(name, isolate.get());
-  }
-
   if (!def.featureFlags.getNewModuleRegistry()) {
     KJ_IF_SOME(moduleFallback, def.moduleFallback) {
       KJ_REQUIRE(experimental,
@@ -4095,9 +4703,15 @@ kj::Own<Server::WorkerService> Server::makeWorkerImpl(kj::StringPtr name,
             .attach(kj::mv(pyodidePackageManager))
       : ArtifactBundler::makeDisabledBundler();
 
-  auto script = isolate->newScript(name, kj::mv(def.source), IsolateObserver::StartType::COLD,
+  return isolate->newScript(name, kj::mv(def.source), IsolateObserver::StartType::COLD,
       SpanParent(nullptr), false, errorReporter, kj::mv(artifactBundler));
+}
 
+kj::Own<Worker> Server::instantiateWorker(kj::StringPtr name,
+    WorkerDef& def,
+    kj::Own<const Worker::Script> script,
+    ErrorReporter& errorReporter) {
+  TRACE_EVENT("workerd", "Server::instantiateWorker()", "name", name.cStr());
   using Global = WorkerdApi::Global;
   jsg::V8Ref<v8::Object> ctxExportsHandle = nullptr;
   auto worker = kj::atomicRefcounted<Worker>(kj::mv(script), kj::atomicRefcounted<WorkerObserver>(),
@@ -4164,6 +4778,26 @@ kj::Own<Server::WorkerService> Server::makeWorkerImpl(kj::StringPtr name,
     { auto drop = kj::mv(ctxExportsHandle); }
   });
 
+  return worker;
+}
+
+kj::Own<Server::WorkerService> Server::makeWorkerService(kj::StringPtr name,
+    WorkerDef def,
+    kj::Own<Worker> worker,
+    ErrorReporter& errorReporter) {
+  // If we are using the inspector, we need to register the Worker::Isolate
+  // with the inspector service.
+  auto& isolate = worker->getIsolate();
+  KJ_IF_SOME(isolateRegistrar, inspectorIsolateRegistrar) {
+    isolateRegistrar->registerIsolate(name, isolate);
+  }
+  KJ_IF_SOME(profiler, cpuProfiler) {
+    profiler->registerIsolate(name, isolate);
+  }
+  KJ_IF_SOME(reporter, memoryReporter) {
+    reporter->registerIsolate(name, isolate);
+  }
+
   auto linkCallback = [this, def = kj::mv(def)](WorkerService& workerService,
                           Worker::ValidationErrorReporter& errorReporter) mutable {
     WorkerService::LinkedIoChannels result{.alarmScheduler = *alarmScheduler};
@@ -4224,7 +4858,7 @@ kj::Own<Server::WorkerService> Server::makeWorkerImpl(kj::StringPtr name,
         });
         targetService = dynamic_cast<WorkerService*>(svc.get());
         if (targetService == nullptr) {
-          // error was reported earlier
+          // error was reported earlier (this includes lazy Workers, which define no namespaces)
           linkedActorChannels.add(kj::none);
           continue;
         }
@@ -4349,10 +4983,16 @@ kj::Own<Server::Service> Server::makeService(config::Service::Reader conf,
       return makeNetworkService(conf.getNetwork());
 
     case config::Service::WORKER:
+      if (conf.getWorker().getLazy()) {
+        return makeLazyWorker(name, conf.getWorker(), extensions);
+      }
       return makeWorker(name, conf.getWorker(), extensions);
 
     case config::Service::DISK:
       return makeDiskDirectoryService(name, conf.getDisk(), headerTableBuilder);
+
+    case config::Service::QUEUE:
+      return makeQueueService(name, conf.getQueue(), headerTableBuilder);
   }
 
   reportConfigError(kj::str("Service named \"", name,
@@ -4393,7 +5033,10 @@ kj::Own<Server::Service> Server::lookupService(
     return {};
   }();
 
-  if (WorkerService* worker = dynamic_cast<WorkerService*>(service)) {
+  if (LazyWorkerService* lazy = dynamic_cast<LazyWorkerService*>(service)) {
+    // Entrypoints are checked when the Worker starts.
+    return lazy->getEntrypoint(entrypointName, kj::mv(props));
+  } else if (WorkerService* worker = dynamic_cast<WorkerService*>(service)) {
     KJ_IF_SOME(ep, worker->getEntrypoint(entrypointName, kj::mv(props))) {
       return kj::mv(ep);
     } else KJ_IF_SOME(ep, entrypointName) {
@@ -4452,7 +5095,12 @@ kj::Own<Server::ActorClass> Server::lookupActorClass(
     return {};
   }();
 
-  if (WorkerService* worker = dynamic_cast<WorkerService*>(service)) {
+  if (dynamic_cast<LazyWorkerService*>(service) != nullptr) {
+    reportConfigError(kj::str(errorContext, " refers to service \"", targetName,
+        "\" as a Durable Object class, but \"", targetName,
+        "\" is a lazy Worker, so cannot be used as a class."));
+    return kj::addRef(*invalidConfigActorClassSingleton);
+  } else if (WorkerService* worker = dynamic_cast<WorkerService*>(service)) {
     KJ_IF_SOME(ep, worker->getActorClass(entrypointName, kj::mv(props))) {
       return kj::mv(ep);
     } else KJ_IF_SOME(ep, entrypointName) {
@@ -4824,6 +5472,39 @@ kj::Promise<void> Server::handleDrain(kj::Promise<void> drainWhen) {
   }
 }
 
+void Server::sendControlMessage(kj::StringPtr message) {
+  KJ_IF_SOME(stream, controlOverride) {
+    try {
+      stream->write(message.asBytes());
+    } catch (kj::Exception& e) {
+      KJ_LOG(ERROR, e);
+    }
+  }
+}
+
+kj::Promise<void> Server::cpuProfilerToggleLoop(kj::Function<kj::Promise<void>()>& nextToggle) {
+  auto& profiler = *KJ_ASSERT_NONNULL(cpuProfiler);
+  for (;;) {
+    co_await nextToggle();
+    profiler.toggle();
+    sendControlMessage(kj::str("{\"event\":\"cpu-profiler\",\"running\":",
+        profiler.isRunning() ? "true" : "false", "}\n"));
+  }
+}
+
+kj::Promise<void> Server::listenRuntimeMetrics(kj::StringPtr addr) {
+  auto& metrics = *KJ_ASSERT_NONNULL(runtimeMetrics);
+  auto parsed = co_await network.parseAddress(addr, 9101);
+  auto listener = parsed->listen();
+  sendControlMessage(
+      kj::str("{\"event\":\"listen-metrics\",\"port\":", listener->getPort(), "}\n"));
+
+  kj::HttpHeaderTable headerTable;
+  auto service = metrics.makeHttpService(headerTable);
+  kj::HttpServer server(timer, headerTable, *service);
+  co_await server.listenHttp(*listener);
+}
+
 kj::Promise<void> Server::run(
     jsg::V8System& v8System, config::Config::Reader config, kj::Promise<void> drainWhen) {
   TRACE_EVENT("workerd", "Server.run");
@@ -4841,6 +5522,50 @@ kj::Promise<void> Server::run(
 
   auto forkedDrainWhen = handleDrain(kj::mv(drainWhen)).fork();
 
+  // The profiler must exist before services are started so that each isolate can register itself.
+  KJ_IF_SOME(profilerConfig, cpuProfilerOverride) {
+    cpuProfiler = kj::heap<SamplingProfiler>(timer, kj::mv(profilerConfig.dir),
+        SamplingProfiler::Options{}, [this](kj::StringPtr fileName) {
+      sendControlMessage(kj::str("{\"event\":\"cpu-profile\",\"file\":\"", fileName, "\"}\n"));
+    });
+    tasks.add(cpuProfilerToggleLoop(profilerConfig.nextToggle));
+  }
+
+  // Likewise, isolates pick up their lock timing observer from the runtime metrics.
+  KJ_IF_SOME(metricsAddr, runtimeMetricsOverride) {
+    auto& metrics = *runtimeMetrics.emplace(
+        kj::heap<RuntimeMetrics>(timer, RuntimeMetrics::Options{}, [this](kj::StringPtr json) {
+      sendControlMessage(kj::str("{\"event\":\"runtime-metrics\",\"metrics\":", json, "}\n"));
+    }));
+    tasks.add(metrics.run());
+
+    auto& reporter = *memoryReporter.emplace(kj::heap<MemoryReporter>(
+        timer, MemoryReporter::Options{}, [this](kj::StringPtr json) {
+      sendControlMessage(kj::str("{\"event\":\"memory-report\",\"report\":", json, "}\n"));
+    }));
+    metrics.addPrometheusSource(
+        [&reporter](kj::Vector<kj::String>& lines) { reporter.renderPrometheus(lines); });
+    tasks.add(reporter.run());
+
+    metrics.addPrometheusSource([this](kj::Vector<kj::String>& lines) {
+      kj::Vector<ContainerPool::NamedPool> pools;
+      for (auto& service: services) {
+        // Lazy Workers are skipped, as only Durable Object namespaces have container pools.
+        if (WorkerService* worker = dynamic_cast<WorkerService*>(&*service.value)) {
+          for (auto& [className, ns]: worker->getActorNamespaces()) {
+            KJ_IF_SOME(pool, ns->getContainerPool()) {
+              auto& durable = KJ_ASSERT_NONNULL(ns->getConfig().tryGet<Durable>());
+              pools.add(ContainerPool::NamedPool{durable.uniqueKey, pool});
+            }
+          }
+        }
+      }
+      ContainerPool::renderPrometheus(lines, pools);
+    });
+
+    tasks.add(listenRuntimeMetrics(metricsAddr));
+  }
+
   startServices(v8System, config, headerTableBuilder, forkedDrainWhen);
 
   auto listenPromise = listenOnSockets(config, headerTableBuilder, forkedDrainWhen);
@@ -4998,21 +5723,29 @@ void Server::startServices(jsg::V8System& v8System,
   KJ_IF_SOME(inspectorAddress, inspectorOverride) {
     auto registrar = kj::heap<InspectorServiceIsolateRegistrar>();
     auto port = startInspector(inspectorAddress, *registrar);
-    KJ_IF_SOME(stream, controlOverride) {
-      auto message = kj::str("{\"event\":\"listen-inspector\",\"port\":", port, "}\n");
-      try {
-        stream->write(message.asBytes());
-      } catch (kj::Exception& e) {
-        KJ_LOG(ERROR, e);
-      }
-    }
+    sendControlMessage(kj::str("{\"event\":\"listen-inspector\",\"port\":", port, "}\n"));
     inspectorIsolateRegistrar = kj::mv(registrar);
   }
 
-  // Second pass: Build services.
+  // Second pass: Build services. Workers are built in parallel first; see WorkerBuild.
+  auto isEagerWorker = [](config::Service::Reader serviceConf) {
+    return serviceConf.isWorker() && !serviceConf.getWorker().getLazy();
+  };
+  kj::Vector<kj::Own<WorkerBuild>> workerBuilds;
+  for (auto serviceConf: config.getServices()) {
+    if (isEagerWorker(serviceConf)) {
+      workerBuilds.add(
+          prepareWorker(serviceConf.getName(), serviceConf.getWorker(), config.getExtensions()));
+    }
+  }
+  runWorkerBuilds(workerBuilds);
+
+  auto nextWorkerBuild = workerBuilds.begin();
   for (auto serviceConf: config.getServices()) {
     kj::StringPtr name = serviceConf.getName();
-    auto service = makeService(serviceConf, headerTableBuilder, config.getExtensions());
+    auto service = isEagerWorker(serviceConf)
+        ? finishWorker(**nextWorkerBuild++)
+        : makeService(serviceConf, headerTableBuilder, config.getExtensions());
 
     services.upsert(kj::str(name), kj::mv(service), [&](auto&&...) {
       reportConfigError(kj::str("Config defines multiple services named \"", name, "\"."));
@@ -5135,15 +5868,8 @@ kj::Promise<void> Server::listenOnSockets(config::Config::Reader config,
             kj::Promise<kj::Own<kj::ConnectionReceiver>> promise) mutable -> kj::Promise<void> {
       TRACE_EVENT("workerd", "setup listenHttp");
       auto listener = co_await promise;
-      KJ_IF_SOME(stream, controlOverride) {
-        auto message = kj::str("{\"event\":\"listen\",\"socket\":\"", name,
-            "\",\"port\":", listener->getPort(), "}\n");
-        try {
-          stream->write(message.asBytes());
-        } catch (kj::Exception& e) {
-          KJ_LOG(ERROR, e);
-        }
-      }
+      sendControlMessage(kj::str("{\"event\":\"listen\",\"socket\":\"", name,
+          "\",\"port\":", listener->getPort(), "}\n"));
       co_await listenHttp(kj::mv(listener), kj::mv(service), physicalProtocol, kj::mv(rewriter));
     });
     tasks.add(handle(kj::mv(listener)).exclusiveJoin(forkedDrainWhen.addBranch()));
@@ -5250,11 +5976,19 @@ kj::Promise<bool> Server::test(jsg::V8System& v8System,
 
   for (auto& service: services) {
     if (serviceGlob.matches(service.key)) {
-      if (service.value->hasHandler("test"_kj) && entrypointGlob.matches("default"_kj)) {
-        co_await doTest(*service.value, service.key);
+      Service* target = service.value.get();
+      kj::Own<WorkerService> started;
+      if (LazyWorkerService* lazy = dynamic_cast<LazyWorkerService*>(target)) {
+        // We can't tell which tests a lazy Worker has without starting it.
+        started = co_await lazy->whenStarted();
+        target = started.get();
+      }
+
+      if (target->hasHandler("test"_kj) && entrypointGlob.matches("default"_kj)) {
+        co_await doTest(*target, service.key);
       }
 
-      if (WorkerService* worker = dynamic_cast<WorkerService*>(service.value.get())) {
+      if (WorkerService* worker = dynamic_cast<WorkerService*>(target)) {
         for (auto& name: worker->getEntrypointNames()) {
           if (entrypointGlob.matches(name)) {
             kj::Own<Service> ep = KJ_ASSERT_NONNULL(worker->getEntrypoint(name, /*props=*/{}));
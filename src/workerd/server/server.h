@@ -28,6 +28,10 @@ namespace workerd::server {
 
 using api::pyodide::PythonConfig;
 
+class MemoryReporter;
+class RuntimeMetrics;
+class SamplingProfiler;
+
 // Implements the single-tenant Workers Runtime server / CLI.
 //
 // The purpose of this class is to implement the core logic independently of the CLI itself,
@@ -66,6 +70,23 @@ class Server final: private kj::TaskSet::ErrorHandler {
   void enableControl(uint fd) {
     controlOverride = kj::heap<kj::FdOutputStream>(fd);
   }
+  // Enable the continuous sampling CPU profiler, writing profiles to `dir`. The profiler starts
+  // stopped; each time the promise returned by `nextToggle` resolves, it is started or stopped.
+  void enableCpuProfiler(
+      kj::Own<const kj::Directory> dir, kj::Function<kj::Promise<void>()> nextToggle) {
+    cpuProfilerOverride = CpuProfilerConfig{kj::mv(dir), kj::mv(nextToggle)};
+  }
+  // Enable event loop and isolate lock metrics, served in Prometheus format at `/metrics` on the
+  // address `addr`.
+  void enableRuntimeMetrics(kj::String addr) {
+    runtimeMetricsOverride = kj::mv(addr);
+  }
+  // Use `makeObserver` to create each Worker's IsolateObserver, in place of the default one or
+  // the one that records runtime metrics. Observers may be used from any thread.
+  void overrideIsolateObserver(
+      kj::Function<kj::Own<IsolateObserver>(kj::StringPtr name)> makeObserver) {
+    isolateObserverOverride = kj::mv(makeObserver);
+  }
   void setPackageDiskCacheRoot(kj::Maybe<kj::Own<const kj::Directory>>&& dkr) {
     pythonConfig.packageDiskCacheRoot = kj::mv(dkr);
   }
@@ -148,6 +169,21 @@ class Server final: private kj::TaskSet::ErrorHandler {
   kj::Maybe<kj::Own<InspectorServiceIsolateRegistrar>> inspectorIsolateRegistrar;
   kj::Maybe<kj::Own<kj::FdOutputStream>> controlOverride;
 
+  struct CpuProfilerConfig {
+    kj::Own<const kj::Directory> dir;
+    kj::Function<kj::Promise<void>()> nextToggle;
+  };
+  kj::Maybe<CpuProfilerConfig> cpuProfilerOverride;
+  kj::Maybe<kj::Own<SamplingProfiler>> cpuProfiler;
+
+  kj::Maybe<kj::String> runtimeMetricsOverride;
+  kj::Maybe<kj::Function<kj::Own<IsolateObserver>(kj::StringPtr name)>> isolateObserverOverride;
+  kj::Maybe<kj::Own<RuntimeMetrics>> runtimeMetrics;
+  kj::Maybe<kj::Own<MemoryReporter>> memoryReporter;
+
+  // Writes a line to the control fd, if one was given.
+  void sendControlMessage(kj::StringPtr message);
+
   struct GlobalContext;
   // General context needed to construct workers. Initialized early in run().
   kj::Own<GlobalContext> globalContext;
@@ -200,6 +236,10 @@ class Server final: private kj::TaskSet::ErrorHandler {
   // Reports an exception thrown by a task in `tasks`.
   void taskFailed(kj::Exception&& exception) override;
 
+  // Starts or stops the CPU profiler every time the configured toggle fires.
+  kj::Promise<void> cpuProfilerToggleLoop(kj::Function<kj::Promise<void>()>& nextToggle);
+  kj::Promise<void> listenRuntimeMetrics(kj::StringPtr addr);
+
   // Tell all HttpServers to drain once the drainWhen promise resolves.
   // This causes them to disconnect any connections that do not have a
   // request in flight.
@@ -221,9 +261,15 @@ class Server final: private kj::TaskSet::ErrorHandler {
   kj::Own<Service> makeDiskDirectoryService(kj::StringPtr name,
       config::DiskDirectory::Reader conf,
       kj::HttpHeaderTable::Builder& headerTableBuilder);
+  kj::Own<Service> makeQueueService(kj::StringPtr name,
+      config::Queue::Reader conf,
+      kj::HttpHeaderTable::Builder& headerTableBuilder);
   kj::Own<Service> makeWorker(kj::StringPtr name,
       config::Worker::Reader conf,
       capnp::List<config::Extension>::Reader extensions);
+  kj::Own<Service> makeLazyWorker(kj::StringPtr name,
+      config::Worker::Reader conf,
+      capnp::List<config::Extension>::Reader extensions);
   kj::Own<Service> makeService(config::Service::Reader conf,
       kj::HttpHeaderTable::Builder& headerTableBuilder,
       capnp::List<config::Extension>::Reader extensions);
@@ -253,18 +299,60 @@ class Server final: private kj::TaskSet::ErrorHandler {
   class ExternalTcpService;
   class NetworkService;
   class DiskDirectoryService;
+  class QueueService;
   class WorkerService;
+  class LazyWorkerService;
   class WorkerEntrypointService;
   class HttpListener;
 
   struct ErrorReporter;
   struct ConfigErrorReporter;
   struct DynamicErrorReporter;
+  struct DeferredErrorReporter;
   struct WorkerDef;
+  struct WorkerBuild;
   kj::Own<WorkerService> makeWorkerImpl(kj::StringPtr name,
       WorkerDef def,
       capnp::List<config::Extension>::Reader extensions,
       ErrorReporter& errorReporter);
+  WorkerDef makeWorkerDef(kj::StringPtr name,
+      config::Worker::Reader conf,
+      CompatibilityFlags::Builder featureFlags,
+      ErrorReporter& errorReporter);
+  kj::Own<IsolateObserver> makeIsolateObserver(kj::StringPtr name);
+
+  // Creates the isolate, compiles and evaluates the script, and validates its handlers.
+  kj::Own<Worker> createWorker(kj::StringPtr name,
+      WorkerDef& def,
+      kj::Own<IsolateObserver> observer,
+      capnp::List<config::Extension>::Reader extensions,
+      ErrorReporter& errorReporter);
+  // The first half of createWorker(): creates the isolate and compiles the script. Only reads
+  // Server state which is never modified after startup, so it's safe to call on any thread.
+  kj::Own<const Worker::Script> compileWorker(kj::StringPtr name,
+      WorkerDef& def,
+      kj::Own<IsolateObserver> observer,
+      capnp::List<config::Extension>::Reader extensions,
+      ErrorReporter& errorReporter);
+  // The second half of createWorker(): evaluates the script's top level and validates its
+  // handlers. Must be called on the main thread, as the script may create promises.
+  kj::Own<Worker> instantiateWorker(kj::StringPtr name,
+      WorkerDef& def,
+      kj::Own<const Worker::Script> script,
+      ErrorReporter& errorReporter);
+  kj::Own<WorkerService> makeWorkerService(kj::StringPtr name,
+      WorkerDef def,
+      kj::Own<Worker> worker,
+      ErrorReporter& errorReporter);
+
+  kj::Own<WorkerBuild> prepareWorker(kj::StringPtr name,
+      config::Worker::Reader conf,
+      capnp::List<config::Extension>::Reader extensions);
+  void runWorkerBuild(WorkerBuild& build);
+
+  // Runs `runWorkerBuild()` for each build on a pool of threads, returning when all are done.
+  void runWorkerBuilds(kj::ArrayPtr<kj::Own<WorkerBuild>> builds);
+  kj::Own<Service> finishWorker(WorkerBuild& build);
 
   void startServices(jsg::V8System& v8System,
       config::Config::Reader config,
@@ -56,6 +56,7 @@
 
 #include <pyodide/generated/pyodide_extra.capnp.h>
 
+#include <capnp/message.h>
 #include <kj/compat/gzip.h>
 #include <kj/compat/http.h>
 #include <kj/compat/tls.h>
@@ -852,9 +853,15 @@ static v8::Local<v8::Value> createBindingValue(JsgWorkerdIsolate::Lock& lock,
     }
 
     KJ_CASE_ONEOF(ns, Global::KvNamespace) {
+      auto writeBehind = ns.writeBehind.map([](const Global::KvNamespace::WriteBehind& wb) {
+        return api::KvNamespace::WriteBehindOptions{
+          .window = wb.window,
+          .maxBatchBytes = wb.maxBatchBytes,
+        };
+      });
       value = lock.wrap(context,
-          lock.alloc<api::KvNamespace>(
-              kj::Array<api::KvNamespace::AdditionalHeader>{}, ns.subrequestChannel));
+          lock.alloc<api::KvNamespace>(kj::Array<api::KvNamespace::AdditionalHeader>{},
+              ns.subrequestChannel, kj::mv(writeBehind)));
     }
 
     KJ_CASE_ONEOF(r2, Global::R2Bucket) {
@@ -1125,6 +1132,9 @@ kj::Own<jsg::modules::ModuleRegistry> WorkerdApi::initializeBundleModuleRegistry
   // etc but no worker bundle modules will be added.
   KJ_IF_SOME(source, maybeSource) {
     jsg::modules::ModuleBundle::BundleBuilder bundleBuilder(bundleBase);
+    // Services built from the same bundle with the same compatibility flags compile each module
+    // only once per process.
+    bundleBuilder.shareCodeCache(capnp::canonicalize(featureFlags).asBytes());
     bool firstEsm = true;
     bool hasPythonModules = false;
     using namespace workerd::api::pyodide;
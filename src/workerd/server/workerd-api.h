@@ -105,6 +105,13 @@ class WorkerdApi final: public Worker::Api {
     struct KvNamespace {
       uint subrequestChannel;
 
+      struct WriteBehind {
+        kj::Duration window;
+        size_t maxBatchBytes;
+      };
+      // Set for a `kvNamespaceWriteBehind` binding.
+      kj::Maybe<WriteBehind> writeBehind;
+
       KvNamespace clone() const {
         return *this;
       }
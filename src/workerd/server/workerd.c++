@@ -768,7 +768,10 @@ class CliMain final: public SchemaFileImpl::ErrorReporter {
         // TODO(later): In the future, we might want to enable providing a perfetto
         // TraceConfig structure here rather than just the categories.
         .addOptionWithArg({"p", "perfetto-trace"}, CLI_METHOD(enablePerfetto),
-            "<path>=<categories>", "Enable perfetto tracing output to the specified file.")
+            "<path>=<categories>",
+            "Enable perfetto tracing output to the specified file. <categories> is a "
+            "comma-separated list such as \"workerd,workerd.lock\"; use \"workerd.*\" to follow "
+            "each request through lock waits, JavaScript execution, subrequests, RPC and storage.")
 #endif
         .addOption({'w', "watch"}, CLI_METHOD(watch),
             "Watch configuration files (and server binary) and reload if they change. "
@@ -813,6 +816,15 @@ class CliMain final: public SchemaFileImpl::ErrorReporter {
         .addOptionWithArg({"control-fd"}, CLI_METHOD(enableControl), "<fd>",
             "Enable sending of control messages on descriptor <fd>. Currently this "
             "only reports the port each socket is listening on when ready.")
+        .addOptionWithArg({"cpu-profile-dir"}, CLI_METHOD(enableCpuProfiler), "<path>",
+            "Enable the continuous sampling CPU profiler, periodically writing collapsed-stack "
+            "profiles of all isolates to the directory <path>. The profiler starts stopped; send "
+            "SIGUSR2 to start or stop it. Profile file names are also reported via --control-fd.")
+        .addOptionWithArg({"metrics-addr"}, CLI_METHOD(enableRuntimeMetrics), "<addr>",
+            "Record event loop lag, event loop turn duration, and isolate lock wait and hold "
+            "times, along with per-isolate heap usage and the memory retained by native "
+            "objects of each type, and serve them in Prometheus format at /metrics on the "
+            "address <addr>. Summaries are also reported via --control-fd once a minute.")
         .callAfterParsing(CLI_METHOD(serve))
         .build();
   }
@@ -1041,12 +1053,30 @@ class CliMain final: public SchemaFileImpl::ErrorReporter {
     server->enableInspector(kj::str(param));
   }
 
+  void enableRuntimeMetrics(kj::StringPtr param) {
+    server->enableRuntimeMetrics(kj::str(param));
+  }
+
   void enableControl(kj::StringPtr param) {
     int fd = KJ_UNWRAP_OR(param.tryParseAs<uint>(),
         CLI_ERROR("Output value must be a file descriptor (non-negative integer)."));
     server->enableControl(fd);
   }
 
+  void enableCpuProfiler(kj::StringPtr pathStr) {
+#if _WIN32
+    CLI_ERROR("The CPU profiler is not supported on Windows.");
+#else
+    kj::Path path = fs->getCurrentPath().eval(pathStr);
+    auto dir = KJ_UNWRAP_OR(fs->getRoot().tryOpenSubdir(path, kj::WriteMode::MODIFY),
+        CLI_ERROR("CPU profile dir must exist"));
+    // Must happen before any threads are started, which is why we do it during argument parsing.
+    kj::UnixEventPort::captureSignal(SIGUSR2);
+    server->enableCpuProfiler(
+        kj::mv(dir), [this]() { return io.unixEventPort.onSignal(SIGUSR2).ignoreResult(); });
+#endif
+  }
+
   void setPackageDiskCacheDir(kj::StringPtr pathStr) {
     kj::Path path = fs->getCurrentPath().eval(pathStr);
     kj::Maybe<kj::Own<const kj::Directory>> dir =
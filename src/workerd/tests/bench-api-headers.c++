@@ -61,5 +61,48 @@ BENCHMARK_F(ApiHeaders, constructor)(benchmark::State& state) {
   });
 }
 
+// The common case: a worker that reads a couple of request headers.
+BENCHMARK_F(ApiHeaders, constructAndGet)(benchmark::State& state) {
+  fixture->runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    for (auto _: state) {
+      for (size_t i = 0; i < 10000; ++i) {
+        auto headers = js.alloc<api::Headers>(js, *kjHeaders, api::Headers::Guard::REQUEST);
+        benchmark::DoNotOptimize(headers->getNoChecks(js, "accept"_kj));
+        benchmark::DoNotOptimize(headers->getNoChecks(js, "x-missing"_kj));
+      }
+    }
+  });
+}
+
+// A worker that forwards the request headers unchanged, e.g. `fetch(request)`.
+BENCHMARK_F(ApiHeaders, constructAndForward)(benchmark::State& state) {
+  fixture->runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    for (auto _: state) {
+      for (size_t i = 0; i < 10000; ++i) {
+        auto headers = js.alloc<api::Headers>(js, *kjHeaders, api::Headers::Guard::REQUEST);
+        kj::HttpHeaders out(*table);
+        headers->shallowCopyTo(out);
+        benchmark::DoNotOptimize(out);
+      }
+    }
+  });
+}
+
+// A worker that modifies the headers, which requires building the full table.
+BENCHMARK_F(ApiHeaders, constructAndSet)(benchmark::State& state) {
+  fixture->runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    for (auto _: state) {
+      for (size_t i = 0; i < 10000; ++i) {
+        auto headers = js.alloc<api::Headers>(js, *kjHeaders, api::Headers::Guard::NONE);
+        headers->setUnguarded(js, "x-foo"_kj, jsg::ByteString(kj::str("bar")));
+        benchmark::DoNotOptimize(headers);
+      }
+    }
+  });
+}
+
 }  // namespace
 }  // namespace workerd
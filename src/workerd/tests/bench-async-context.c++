@@ -0,0 +1,86 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/jsg/async-context.h>
+#include <workerd/jsg/jsg.h>
+#include <workerd/jsg/setup.h>
+#include <workerd/tests/bench-tools.h>
+
+// A benchmark for creating async context frames and looking up values in them, with a varying
+// number of stores already set, as when tracing and logging libraries each keep a store per
+// request.
+
+namespace workerd {
+namespace {
+
+class AsyncContextBenchContext: public jsg::Object, public jsg::ContextGlobal {
+ public:
+  JSG_RESOURCE_TYPE(AsyncContextBenchContext) {}
+};
+
+JSG_DECLARE_ISOLATE_TYPE(AsyncContextBenchIsolate, AsyncContextBenchContext);
+
+jsg::V8System system;
+
+using Keys = kj::ArrayPtr<kj::Own<jsg::AsyncContextFrame::StorageKey>>;
+
+// Runs `func` in a context in which a value has been set for each of `keys`, one nested frame
+// per key.
+void withStores(benchmark::State& state, kj::FunctionParam<void(jsg::Lock& js, Keys keys)> func) {
+  AsyncContextBenchIsolate isolate(system, kj::heap<jsg::IsolateObserver>(), {});
+  isolate.runInLockScope([&](AsyncContextBenchIsolate::Lock& isolateLock) {
+    auto context = isolateLock.newContext<AsyncContextBenchContext>();
+
+    return JSG_WITHIN_CONTEXT_SCOPE(
+        isolateLock, context.getHandle(isolateLock), [&](jsg::Lock& js) {
+      auto keys = KJ_MAP(i, kj::zeroTo(state.range(0))) {
+        return kj::refcounted<jsg::AsyncContextFrame::StorageKey>();
+      };
+
+      kj::Vector<kj::Own<jsg::AsyncContextFrame::StorageScope>> scopes;
+      for (auto i: kj::indices(keys)) {
+        auto value = js.v8Ref(v8::Number::New(js.v8Isolate, i).As<v8::Value>());
+        scopes.add(kj::heap<jsg::AsyncContextFrame::StorageScope>(js, *keys[i], kj::mv(value)));
+      }
+
+      func(js, keys);
+
+      // Leave the frames innermost first.
+      while (scopes.size() > 0) {
+        scopes.removeLast();
+      }
+    });
+  });
+}
+
+// Equivalent of `AsyncLocalStorage.run()`: create a frame with one more value and enter it.
+static void AsyncContext_run(benchmark::State& state) {
+  withStores(state, [&](jsg::Lock& js, Keys keys) {
+    auto value = js.v8Ref(v8::Number::New(js.v8Isolate, -1).As<v8::Value>());
+    for (auto _: state) {
+      js.withinHandleScope([&]() {
+        jsg::AsyncContextFrame::StorageScope scope(js, *keys[0], value.addRef(js));
+        benchmark::DoNotOptimize(&scope);
+      });
+    }
+  });
+}
+
+// Equivalent of `AsyncLocalStorage.getStore()` for every store.
+static void AsyncContext_getStore(benchmark::State& state) {
+  withStores(state, [&](jsg::Lock& js, Keys keys) {
+    auto& frame = KJ_ASSERT_NONNULL(jsg::AsyncContextFrame::current(js));
+    for (auto _: state) {
+      for (auto& key: keys) {
+        benchmark::DoNotOptimize(frame.get(*key));
+      }
+    }
+  });
+}
+
+WD_BENCHMARK(AsyncContext_run)->Arg(1)->Arg(8)->Arg(32);
+WD_BENCHMARK(AsyncContext_getStore)->Arg(1)->Arg(8)->Arg(32);
+
+}  // namespace
+}  // namespace workerd
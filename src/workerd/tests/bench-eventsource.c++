@@ -0,0 +1,69 @@
+// Copyright (c) 2017-2024 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/api/eventsource.h>
+#include <workerd/tests/bench-tools.h>
+
+#include <kj/vector.h>
+
+// A benchmark for parsing a server-sent event stream of the kind streamed by LLM APIs: several
+// megabytes of small messages, each carrying one token as JSON. The argument is the size of the
+// chunks the stream is fed in, small as when each message is flushed separately, or large as when
+// the response body is read in big buffers.
+
+namespace workerd {
+namespace {
+
+constexpr size_t MESSAGE_COUNT = 50000;
+
+kj::String makeStream() {
+  kj::Vector<char> stream;
+  for (auto i: kj::zeroTo(MESSAGE_COUNT)) {
+    auto message = kj::str("id: ", i,
+        "\ndata: {\"id\":\"chatcmpl-123\",\"object\":\"chat.completion.chunk\",\"choices\":"
+        "[{\"index\":0,\"delta\":{\"content\":\"token ",
+        i, "\"},\"finish_reason\":null}]}\n\n");
+    stream.addAll(message);
+  }
+  stream.add('\0');
+  return kj::String(stream.releaseAsArray());
+}
+
+// Copies out each message, as EventSource does to dispatch it.
+struct Listener final: public api::EventStreamParser::Listener {
+  size_t messages = 0;
+
+  void onMessage(
+      kj::Maybe<kj::ArrayPtr<const char>> type, kj::ArrayPtr<const char> data) override {
+    benchmark::DoNotOptimize(kj::heapString(data));
+    ++messages;
+  }
+  void onLastEventId(kj::ArrayPtr<const char> id) override {
+    benchmark::DoNotOptimize(id);
+  }
+  void onReconnectionTime(uint32_t time) override {}
+};
+
+static void EventStreamParser_feed(benchmark::State& state) {
+  auto stream = makeStream();
+  size_t chunkSize = state.range(0);
+
+  for (auto _: state) {
+    Listener listener;
+    api::EventStreamParser parser(listener);
+    auto input = stream.asArray();
+    while (input.size() > 0) {
+      auto chunk = input.first(kj::min(chunkSize, input.size()));
+      parser.feed(chunk);
+      input = input.slice(chunk.size());
+    }
+    KJ_ASSERT(listener.messages == MESSAGE_COUNT);
+  }
+  state.SetBytesProcessed(state.iterations() * stream.size());
+}
+
+WD_BENCHMARK(EventStreamParser_feed)->Arg(64)->Arg(65536);
+
+}  // namespace
+}  // namespace workerd
@@ -0,0 +1,60 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/server/facet-tree-index.h>
+#include <workerd/tests/bench-tools.h>
+
+#include <kj/async.h>
+#include <kj/filesystem.h>
+
+// A benchmark for assigning IDs to many new Durable Object facets at once. The index is backed by
+// a real file so that the cost of syncing it is included.
+
+namespace workerd::server {
+namespace {
+
+kj::Own<const kj::File> makeTempFile(kj::Filesystem& disk) {
+  const char* tmpDir = getenv("TEST_TMPDIR");
+  auto path = disk.getCurrentPath().evalNative(tmpDir != nullptr ? tmpDir : "/var/tmp");
+  return disk.getRoot().openSubdir(path)->createTemporary();
+}
+
+// All facets are created during one turn of the event loop and then awaited together, as when a
+// Durable Object fans out into many new facets at once.
+static void FacetTreeIndex_createBatched(benchmark::State& state) {
+  kj::EventLoop loop;
+  kj::WaitScope waitScope(loop);
+  auto disk = kj::newDiskFilesystem();
+
+  for (auto _: state) {
+    FacetTreeIndex index(makeTempFile(*disk));
+    for (auto i: kj::zeroTo(state.range(0))) {
+      benchmark::DoNotOptimize(index.getId(0, kj::str("facet", i)));
+    }
+    index.whenDurable().wait(waitScope);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Each facet waits for its own ID to be durable before the next is created.
+static void FacetTreeIndex_createSerial(benchmark::State& state) {
+  kj::EventLoop loop;
+  kj::WaitScope waitScope(loop);
+  auto disk = kj::newDiskFilesystem();
+
+  for (auto _: state) {
+    FacetTreeIndex index(makeTempFile(*disk));
+    for (auto i: kj::zeroTo(state.range(0))) {
+      benchmark::DoNotOptimize(index.getId(0, kj::str("facet", i)));
+      index.whenDurable().wait(waitScope);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+WD_BENCHMARK(FacetTreeIndex_createBatched)->Arg(20000)->Arg(60000);
+WD_BENCHMARK(FacetTreeIndex_createSerial)->Arg(1000);
+
+}  // namespace
+}  // namespace workerd::server
@@ -0,0 +1,65 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/api/node/crypto.h>
+#include <workerd/tests/bench-tools.h>
+#include <workerd/tests/test-fixture.h>
+
+// A benchmark for HMACs of 64-byte messages with a key that is used over and over, as when
+// verifying JWTs or webhook signatures. A key object reuses its precomputed key schedule, while raw
+// key bytes are hashed into a new one for every HMAC. The argument is the SHA-2 digest size.
+
+namespace workerd {
+namespace {
+
+using HmacHandle = api::node::CryptoImpl::HmacHandle;
+
+constexpr size_t KEY_SIZE = 32;
+constexpr size_t MESSAGE_SIZE = 64;
+
+kj::StringPtr digestName(benchmark::State& state) {
+  return state.range(0) == 512 ? "sha512"_kj : "sha256"_kj;
+}
+
+// Computes one HMAC per iteration, passing the key as raw bytes or as a key object.
+void runHmac(benchmark::State& state, bool useKeyObject) {
+  TestFixture fixture;
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    auto raw = kj::heapArray<kj::byte>(KEY_SIZE);
+    raw.asPtr().fill('k');
+    auto algorithm = digestName(state);
+
+    auto backing = jsg::BackingStore::alloc<v8::ArrayBuffer>(js, raw.size());
+    backing.asArrayPtr().copyFrom(raw);
+    auto crypto = js.alloc<api::node::CryptoImpl>();
+    auto keyObject = crypto->createSecretKey(js, jsg::BufferSource(js, kj::mv(backing)));
+
+    for (auto _: state) {
+      js.withinHandleScope([&]() {
+        HmacHandle::KeyParam key = useKeyObject ? HmacHandle::KeyParam(keyObject.addRef())
+                                                : HmacHandle::KeyParam(kj::heapArray(raw.asPtr()));
+        auto data = kj::heapArray<kj::byte>(MESSAGE_SIZE);
+        data.asPtr().fill('x');
+        benchmark::DoNotOptimize(
+            HmacHandle::oneshot(js, kj::str(algorithm), kj::mv(key), kj::mv(data)));
+      });
+    }
+  });
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void Hmac_rawKey(benchmark::State& state) {
+  runHmac(state, false);
+}
+
+static void Hmac_keyObject(benchmark::State& state) {
+  runHmac(state, true);
+}
+
+WD_BENCHMARK(Hmac_rawKey)->Arg(256)->Arg(512);
+WD_BENCHMARK(Hmac_keyObject)->Arg(256)->Arg(512);
+
+}  // namespace
+}  // namespace workerd
@@ -0,0 +1,97 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/api/crypto/keys.h>
+#include <workerd/tests/bench-tools.h>
+#include <workerd/tests/test-fixture.h>
+
+#include <openssl/evp.h>
+#include <openssl/mem.h>
+#include <openssl/x509.h>
+
+// A benchmark for `crypto.subtle.importKey()` of SPKI public keys, as done by Workers which verify
+// a token on every request. Importing the same key over and over reuses the parsed key, while
+// cycling through more distinct keys than the isolate's cache holds parses every one. The argument
+// selects the algorithm: 0 for RSA-2048, 1 for ECDSA P-256, 2 for Ed25519.
+
+namespace workerd {
+namespace {
+
+using ImportKeyAlgorithm = api::SubtleCrypto::ImportKeyAlgorithm;
+using HashParam = kj::OneOf<kj::String, api::SubtleCrypto::HashAlgorithm>;
+
+ImportKeyAlgorithm makeAlgorithm(benchmark::State& state) {
+  switch (state.range(0)) {
+    case 0:
+      return {.name = kj::str("RSASSA-PKCS1-v1_5"), .hash = HashParam(kj::str("SHA-256"))};
+    case 1:
+      return {.name = kj::str("ECDSA"), .namedCurve = kj::str("P-256")};
+    default:
+      return {.name = kj::str("Ed25519")};
+  }
+}
+
+// Generates a key pair for the selected algorithm and returns its public key as SPKI.
+kj::Array<kj::byte> generateSpki(benchmark::State& state) {
+  int type = EVP_PKEY_ED25519;
+  if (state.range(0) == 0) {
+    type = EVP_PKEY_RSA;
+  } else if (state.range(0) == 1) {
+    type = EVP_PKEY_EC;
+  }
+  auto ctx = kj::Own<EVP_PKEY_CTX>(EVP_PKEY_CTX_new_id(type, nullptr),
+      api::SslDisposer<EVP_PKEY_CTX, &EVP_PKEY_CTX_free>::INSTANCE);
+  KJ_ASSERT(EVP_PKEY_keygen_init(ctx.get()) == 1);
+  if (type == EVP_PKEY_RSA) {
+    KJ_ASSERT(EVP_PKEY_CTX_set_rsa_keygen_bits(ctx.get(), 2048) == 1);
+  } else if (type == EVP_PKEY_EC) {
+    KJ_ASSERT(EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx.get(), NID_X9_62_prime256v1) == 1);
+  }
+  EVP_PKEY* pkey = nullptr;
+  KJ_ASSERT(EVP_PKEY_keygen(ctx.get(), &pkey) == 1);
+  KJ_DEFER(EVP_PKEY_free(pkey));
+
+  uint8_t* der = nullptr;
+  int size = i2d_PUBKEY(pkey, &der);
+  KJ_ASSERT(size > 0);
+  KJ_DEFER(OPENSSL_free(der));
+  return kj::heapArray<kj::byte>(der, size);
+}
+
+// Imports one key per iteration, cycling through `keyCount` distinct keys.
+void runImport(benchmark::State& state, uint keyCount) {
+  auto keys = KJ_MAP(i, kj::zeroTo(keyCount)) { return generateSpki(state); };
+
+  TestFixture fixture;
+  fixture.runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    api::SubtleCrypto subtle;
+    auto usages = kj::arr(kj::str("verify"));
+    size_t next = 0;
+
+    for (auto _: state) {
+      js.withinHandleScope([&]() {
+        auto& spki = keys[next++ % keys.size()];
+        benchmark::DoNotOptimize(subtle.importKeySync(
+            js, "spki", kj::heapArray(spki.asPtr()), makeAlgorithm(state), false, usages));
+      });
+    }
+  });
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void ImportKey_sameKey(benchmark::State& state) {
+  runImport(state, 1);
+}
+
+static void ImportKey_distinctKeys(benchmark::State& state) {
+  // Least-recently-used eviction means that cycling through one more key than fits never hits.
+  runImport(state, api::ImportedKeyCache::MAX_ENTRIES + 1);
+}
+
+WD_BENCHMARK(ImportKey_sameKey)->Arg(0)->Arg(1)->Arg(2);
+WD_BENCHMARK(ImportKey_distinctKeys)->Arg(0)->Arg(1)->Arg(2);
+
+}  // namespace
+}  // namespace workerd
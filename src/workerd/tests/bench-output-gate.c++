@@ -0,0 +1,49 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/io/io-gate.h>
+#include <workerd/tests/bench-tools.h>
+
+#include <kj/async.h>
+#include <kj/vector.h>
+
+// A benchmark for output gate locks, as taken by a Durable Object which issues many storage
+// writes in one request. All locks are taken before any is released, with a wait() after every
+// `state.range(0)` locks, as when outgoing messages are sent between writes.
+
+namespace workerd {
+namespace {
+
+constexpr size_t LOCK_COUNT = 100000;
+
+static void OutputGate_lockUnlock(benchmark::State& state) {
+  kj::EventLoop loop;
+  kj::WaitScope waitScope(loop);
+
+  for (auto _: state) {
+    OutputGate gate;
+    kj::Vector<kj::Own<kj::PromiseFulfiller<void>>> fulfillers(LOCK_COUNT);
+    kj::Vector<kj::Promise<void>> promises(LOCK_COUNT + LOCK_COUNT / state.range(0));
+
+    for (auto i: kj::zeroTo(LOCK_COUNT)) {
+      auto paf = kj::newPromiseAndFulfiller<void>();
+      fulfillers.add(kj::mv(paf.fulfiller));
+      promises.add(gate.lockWhile(kj::mv(paf.promise)));
+      if (i % state.range(0) == 0) {
+        promises.add(gate.wait());
+      }
+    }
+
+    for (auto& fulfiller: fulfillers) {
+      fulfiller->fulfill();
+    }
+    kj::joinPromises(promises.releaseAsArray()).wait(waitScope);
+  }
+  state.SetItemsProcessed(state.iterations() * LOCK_COUNT);
+}
+
+WD_BENCHMARK(OutputGate_lockUnlock)->Arg(1)->Arg(16)->Arg(1024);
+
+}  // namespace
+}  // namespace workerd
@@ -0,0 +1,84 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/api/queue.h>
+#include <workerd/tests/bench-tools.h>
+#include <workerd/tests/test-fixture.h>
+
+// A benchmark for dispatching batches of queue messages. Both variants build the same QueueEvent
+// and ack it; they differ only in whether the consumer reads every message body.
+
+namespace workerd {
+namespace {
+
+constexpr size_t BATCH_SIZE = 100;
+
+struct QueueBatch: public benchmark::Fixture {
+  virtual ~QueueBatch() noexcept(true) {}
+
+  void SetUp(benchmark::State& state) noexcept(true) override {
+    fixture = kj::heap<TestFixture>();
+
+    // A JSON body of about 16kB.
+    kj::Vector<kj::String> fields;
+    for (auto i: kj::zeroTo(512)) {
+      fields.add(kj::str("\"field", i, "\":\"some moderately long value\""));
+    }
+    body = kj::str("{", kj::strArray(fields, ","), "}");
+  }
+
+  void TearDown(benchmark::State& state) noexcept(true) override {
+    fixture = nullptr;
+  }
+
+  api::QueueEvent::Params makeParams() {
+    auto messages = kj::heapArrayBuilder<api::IncomingQueueMessage>(BATCH_SIZE);
+    for (auto i: kj::zeroTo(BATCH_SIZE)) {
+      messages.add(api::IncomingQueueMessage{
+        .id = kj::str(i),
+        .timestamp = kj::UNIX_EPOCH,
+        .body = kj::heapArray(body.asBytes()),
+        .contentType = kj::str(api::IncomingQueueMessage::ContentType::JSON),
+        .attempts = 1,
+      });
+    }
+    return {.queueName = kj::str("queue"), .messages = messages.finish()};
+  }
+
+  kj::Own<TestFixture> fixture;
+  kj::String body;
+};
+
+// Consumers that decide what to do from message metadata alone never pay for deserialization.
+BENCHMARK_F(QueueBatch, dispatchAckAll)(benchmark::State& state) {
+  fixture->runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    api::QueueEventResult result;
+    auto resultPtr = env.context.addObject(result);
+    for (auto _: state) {
+      auto event = js.alloc<api::QueueEvent>(js, makeParams(), resultPtr);
+      event->ackAll();
+      benchmark::DoNotOptimize(event);
+    }
+  });
+}
+
+BENCHMARK_F(QueueBatch, dispatchReadBodies)(benchmark::State& state) {
+  fixture->runInIoContext([&](const TestFixture::Environment& env) {
+    auto& js = env.js;
+    api::QueueEventResult result;
+    auto resultPtr = env.context.addObject(result);
+    for (auto _: state) {
+      auto event = js.alloc<api::QueueEvent>(js, makeParams(), resultPtr);
+      for (auto& message: event->getMessageRefs()) {
+        benchmark::DoNotOptimize(message->getBody(js));
+      }
+      event->ackAll();
+      benchmark::DoNotOptimize(event);
+    }
+  });
+}
+
+}  // namespace
+}  // namespace workerd
@@ -0,0 +1,86 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/api/actor-state.h>
+#include <workerd/api/sql.h>
+#include <workerd/tests/bench-tools.h>
+#include <workerd/tests/test-fixture.h>
+
+// A benchmark for bulk inserts into Durable Object SQLite storage, comparing a loop over `exec()`
+// with a single `execBatch()`.
+
+namespace workerd {
+namespace {
+
+constexpr size_t ROW_COUNT = 10000;
+
+using BindingValue = api::SqlStorage::BindingValue;
+
+kj::Array<BindingValue> makeRow(size_t i) {
+  using Value = kj::OneOf<kj::Array<const byte>, kj::String, double>;
+  auto bindings = kj::heapArrayBuilder<BindingValue>(2);
+  bindings.add(Value(static_cast<double>(i)));
+  bindings.add(Value(kj::str("value ", i)));
+  return bindings.finish();
+}
+
+struct SqlInsert: public benchmark::Fixture {
+  virtual ~SqlInsert() noexcept(true) {}
+
+  void SetUp(benchmark::State& state) noexcept(true) override {
+    fixture = kj::heap<TestFixture>(TestFixture::SetupParams{
+      .actorId = Worker::Actor::Id(kj::str("bench-sql")),
+      .actorSqlite = true,
+    });
+  }
+
+  void TearDown(benchmark::State& state) noexcept(true) override {
+    fixture = nullptr;
+  }
+
+  // Runs `insert` against a freshly-emptied table, once per benchmark iteration.
+  void run(benchmark::State& state,
+      kj::FunctionParam<void(jsg::Lock& js, api::SqlStorage& sql, jsg::JsString query)> insert) {
+    for (auto _: state) {
+      fixture->runInIoContext([&](const TestFixture::Environment& env) {
+        auto& js = env.js;
+        auto& actorCache = KJ_ASSERT_NONNULL(env.context.getActorOrThrow().getPersistent());
+        auto storage = js.alloc<api::DurableObjectStorage>(
+            js, env.context.addObject(actorCache), /*enableSql=*/true);
+        auto sql = storage->getSql(js);
+
+        auto create = "CREATE TABLE IF NOT EXISTS bench (id INTEGER PRIMARY KEY, val TEXT)"_kj;
+        sql->exec(js, js.str(create), kj::Array<BindingValue>());
+        sql->exec(js, js.str("DELETE FROM bench"_kj), kj::Array<BindingValue>());
+
+        insert(js, *sql, js.str("INSERT INTO bench VALUES (?, ?)"_kj));
+      });
+    }
+    state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+  }
+
+  kj::Own<TestFixture> fixture;
+};
+
+BENCHMARK_F(SqlInsert, execLoop)(benchmark::State& state) {
+  run(state, [](jsg::Lock& js, api::SqlStorage& sql, jsg::JsString query) {
+    for (auto i: kj::zeroTo(ROW_COUNT)) {
+      benchmark::DoNotOptimize(sql.exec(js, query, makeRow(i)));
+    }
+  });
+}
+
+BENCHMARK_F(SqlInsert, execBatch)(benchmark::State& state) {
+  run(state, [](jsg::Lock& js, api::SqlStorage& sql, jsg::JsString query) {
+    auto rows = kj::heapArrayBuilder<kj::Array<BindingValue>>(ROW_COUNT);
+    for (auto i: kj::zeroTo(ROW_COUNT)) {
+      rows.add(makeRow(i));
+    }
+    auto result = sql.execBatch(js, query, rows.finish());
+    KJ_ASSERT(result.rowsWritten == ROW_COUNT);
+  });
+}
+
+}  // namespace
+}  // namespace workerd
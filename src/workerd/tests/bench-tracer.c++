@@ -0,0 +1,55 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/io/tracer.h>
+#include <workerd/tests/bench-tools.h>
+
+// A benchmark for the tracing done on every fetch request: event info with the request's URL,
+// headers and cf object, a few console.log() lines, the response status and the outcome. With
+// argument 0 the tracer's log level is NONE, so nothing is recorded, with argument 1 it records
+// everything for a tail worker. (Without tail workers, workerd creates no tracer at all.)
+
+namespace workerd {
+namespace {
+
+constexpr size_t HEADER_COUNT = 20;
+constexpr size_t LOG_COUNT = 4;
+
+kj::Own<WorkerTracer> makeTracer(benchmark::State& state) {
+  auto logLevel = state.range(0) == 0 ? PipelineLogLevel::NONE : PipelineLogLevel::FULL;
+  return kj::rc<PipelineTracer>()->makeWorkerTracer(logLevel, ExecutionModel::STATELESS, kj::none,
+      kj::none, kj::none, kj::none, kj::none, nullptr, kj::none, kj::none);
+}
+
+static void Tracer_request(benchmark::State& state) {
+  auto headerNames = KJ_MAP(i, kj::zeroTo(HEADER_COUNT)) { return kj::str("x-header-", i); };
+  auto headerValues = KJ_MAP(i, kj::zeroTo(HEADER_COUNT)) { return kj::str("value ", i); };
+  auto cfJson = kj::str(R"({"colo":"LHR","country":"GB","asn":13335,"httpProtocol":"HTTP/2"})");
+  tracing::InvocationSpanContext context(
+      tracing::TraceId(1, 2), tracing::TraceId(3, 4), tracing::SpanId(5));
+
+  for (auto _: state) {
+    auto tracer = makeTracer(state);
+    tracer->setEventInfo(context, kj::UNIX_EPOCH, [&]() -> tracing::EventInfo {
+      auto traceHeaders = KJ_MAP(i, kj::zeroTo(HEADER_COUNT)) {
+        return tracing::FetchEventInfo::Header(kj::str(headerNames[i]), kj::str(headerValues[i]));
+      };
+      return tracing::FetchEventInfo(kj::HttpMethod::GET,
+          kj::str("https://example.com/some/path?query=1"), kj::str(cfJson),
+          kj::mv(traceHeaders));
+    });
+    for (auto i: kj::zeroTo(LOG_COUNT)) {
+      tracer->addLog(context, kj::UNIX_EPOCH, LogLevel::LOG,
+          [&]() { return kj::str("[\"handling request\", ", i, "]"); });
+    }
+    tracer->setFetchResponseInfo(tracing::FetchResponseInfo(200));
+    tracer->setOutcome(EventOutcome::OK, 0 * kj::MILLISECONDS, 0 * kj::MILLISECONDS);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+WD_BENCHMARK(Tracer_request)->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace workerd
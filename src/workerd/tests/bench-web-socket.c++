@@ -0,0 +1,98 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include <workerd/api/web-socket.h>
+#include <workerd/tests/bench-tools.h>
+#include <workerd/tests/test-fixture.h>
+
+// A benchmark for delivering many small messages from one end of a WebSocketPair to the other, in
+// the same kind of Worker, with up to 1 or up to 128 already-buffered messages delivered under
+// each isolate lock. Each reports the isolate locks it took per message.
+
+namespace workerd {
+namespace {
+
+constexpr size_t MESSAGE_COUNT = 100000;
+
+constexpr kj::StringPtr SCRIPT = R"SCRIPT(
+  export default {
+    async fetch(request) {
+      const count = parseInt(await request.text());
+      const [sender, receiver] = Object.values(new WebSocketPair());
+      sender.accept();
+      receiver.accept();
+
+      const done = new Promise(resolve => {
+        let received = 0;
+        receiver.addEventListener("message", () => {
+          if (++received == count) resolve(received);
+        });
+      });
+      for (let i = 0; i < count; i++) {
+        sender.send("x");
+      }
+      return new Response(String(await done));
+    },
+  };
+)SCRIPT"_kj;
+
+// Counts the isolate locks taken.
+class LockCounter final: public IsolateObserver {
+ public:
+  explicit LockCounter(uint64_t& locks): locks(locks) {}
+
+  kj::Maybe<kj::Own<LockTiming>> tryCreateLockTiming(
+      kj::OneOf<SpanParent, kj::Maybe<RequestObserver&>> parentOrRequest) const override {
+    return kj::Own<LockTiming>(kj::heap<CountingLockTiming>(locks));
+  }
+
+ private:
+  struct CountingLockTiming final: public LockTiming {
+    explicit CountingLockTiming(uint64_t& locks): locks(locks) {}
+    void locked() override {
+      ++locks;
+    }
+    uint64_t& locks;
+  };
+
+  uint64_t& locks;
+};
+
+void runReceive(benchmark::State& state, bool perMessage) {
+  capnp::MallocMessageBuilder message;
+  auto flags = message.initRoot<CompatibilityFlags>();
+  flags.setWorkerdExperimental(true);
+  flags.setWebSocketReceivePerMessage(perMessage);
+
+  uint64_t locks = 0;
+  TestFixture fixture({
+    .featureFlags = flags.asReader(),
+    .mainModuleSource = SCRIPT,
+    .isolateObserver = kj::atomicRefcounted<LockCounter>(locks),
+  });
+
+  auto count = kj::str(MESSAGE_COUNT);
+  locks = 0;
+  for (auto _: state) {
+    auto response = fixture.runRequest(kj::HttpMethod::POST, "http://www.example.com"_kj, count);
+    KJ_ASSERT(response.body == count);
+  }
+  auto messages = state.iterations() * MESSAGE_COUNT;
+  state.SetItemsProcessed(messages);
+  state.counters["locks_per_message"] = double(locks) / messages;
+}
+
+static void WebSocket_receiveBatched(benchmark::State& state) {
+  runReceive(state, false);
+}
+
+static void WebSocket_receivePerMessage(benchmark::State& state) {
+  runReceive(state, true);
+}
+
+WD_BENCHMARK(WebSocket_receiveBatched);
+WD_BENCHMARK(WebSocket_receivePerMessage);
+
+}  // namespace
+}  // namespace workerd
@@ -9,10 +9,12 @@
 #include <workerd/api/memory-cache.h>
 #include <workerd/io/actor-cache.h>
 #include <workerd/io/actor-id.h>
+#include <workerd/io/actor-sqlite.h>
 #include <workerd/io/io-channels.h>
 #include <workerd/io/limit-enforcer.h>
 #include <workerd/io/observer.h>
 #include <workerd/io/tracer.h>
+#include <workerd/io/worker-entrypoint.h>
 #include <workerd/jsg/jsg.h>
 #include <workerd/jsg/setup.h>
 #include <workerd/server/server.h>
@@ -226,6 +228,13 @@ struct MockErrorReporter final: public Worker::ValidationErrorReporter {
   void addActorClass(kj::StringPtr exportName) override {}
 };
 
+kj::Own<IsolateObserver> takeIsolateObserver(TestFixture::SetupParams& params) {
+  KJ_IF_SOME(observer, params.isolateObserver) {
+    return kj::mv(observer);
+  }
+  return kj::atomicRefcounted<IsolateObserver>();
+}
+
 inline server::config::Worker::Reader buildConfig(
     TestFixture::SetupParams& params, capnp::MallocMessageBuilder& arena) {
   auto config = arena.initRoot<server::config::Worker>();
@@ -335,7 +344,7 @@ TestFixture::TestFixture(SetupParams&& params)
           kj::none /* new module registry */,
           newWorkerFileSystem(kj::heap<FsMap>(), getTmpDirectoryImpl()))),
       workerIsolate(kj::atomicRefcounted<Worker::Isolate>(kj::mv(api),
-          kj::atomicRefcounted<IsolateObserver>(),
+          takeIsolateObserver(params),
           scriptId,
           kj::heap<MockIsolateLimitEnforcer>(),
           Worker::Isolate::InspectorPolicy::DISALLOW)),
@@ -359,15 +368,27 @@ TestFixture::TestFixture(SetupParams&& params)
       waitUntilTasks(*errorHandler),
       headerTable(headerTableBuilder.build()) {
   KJ_IF_SOME(id, params.actorId) {
-    auto makeActorCache = [](const ActorCache::SharedLru& sharedLru, OutputGate& outputGate,
-                              ActorCache::Hooks& hooks, SqliteObserver& sqliteObserver) {
+    if (params.actorSqlite) {
+      auto dir = kj::newInMemoryDirectory(kj::nullClock());
+      actorSqliteVfs = kj::heap<SqliteDatabase::Vfs>(*dir).attach(kj::mv(dir));
+    }
+    auto makeActorCache = [this](const ActorCache::SharedLru& sharedLru, OutputGate& outputGate,
+                                 ActorCache::Hooks& hooks,
+                                 SqliteObserver& sqliteObserver) -> kj::Own<ActorCacheInterface> {
+      KJ_IF_SOME(vfs, actorSqliteVfs) {
+        auto db = kj::heap<SqliteDatabase>(
+            *vfs, kj::Path({"actor.sqlite"}), kj::WriteMode::CREATE | kj::WriteMode::MODIFY);
+        db->run("PRAGMA journal_mode=WAL;");
+        return kj::heap<ActorSqlite>(
+            kj::mv(db), outputGate, []() -> kj::Promise<void> { return kj::READY_NOW; });
+      }
       return kj::heap<ActorCache>(
           server::newEmptyReadOnlyActorStorage(), sharedLru, outputGate, hooks);
     };
-    auto makeStorage = [](jsg::Lock& js, const Worker::Api& api,
+    auto makeStorage = [enableSql = params.actorSqlite](jsg::Lock& js, const Worker::Api& api,
                            ActorCacheInterface& actorCache) -> jsg::Ref<api::DurableObjectStorage> {
       return js.alloc<api::DurableObjectStorage>(
-          js, IoContext::current().addObject(actorCache), /*enableSql=*/false);
+          js, IoContext::current().addObject(actorCache), enableSql);
     };
     actor = kj::refcounted<Worker::Actor>(*worker, /*tracker=*/kj::none, kj::mv(id),
         /*hasTransient=*/false, makeActorCache,
@@ -433,4 +454,18 @@ TestFixture::Response TestFixture::runRequest(
   return {.statusCode = response.statusCode, .body = response.body->str()};
 }
 
+kj::Promise<void> TestFixture::startRequest(kj::StringPtr url, kj::Own<RequestObserver> observer) {
+  auto entrypoint = newWorkerEntrypoint(threadContext, kj::atomicAddRef(*worker), kj::none, {},
+      kj::none, kj::heap<MockLimitEnforcer>(), {}, kj::heap<DummyIoChannelFactory>(*timerChannel),
+      kj::mv(observer), waitUntilTasks, false, kj::none, kj::none);
+  auto requestHeaders = kj::heap<kj::HttpHeaders>(*headerTable);
+  auto requestBody = newMemoryInputStream(""_kj);
+  auto response = kj::heap<MockResponse>();
+
+  auto promise =
+      entrypoint->request(kj::HttpMethod::GET, url, *requestHeaders, *requestBody, *response);
+  return promise.attach(
+      kj::mv(entrypoint), kj::mv(requestHeaders), kj::mv(requestBody), kj::mv(response));
+}
+
 }  // namespace workerd
@@ -9,6 +9,7 @@
 #include <workerd/io/worker.h>
 #include <workerd/jsg/jsg.h>
 #include <workerd/server/workerd.capnp.h>
+#include <workerd/util/sqlite.h>
 
 #include <capnp/message.h>
 #include <kj/function.h>
@@ -26,6 +27,11 @@ struct TestFixture {
     kj::Maybe<kj::StringPtr> mainModuleSource;
     // If set, make a stub of an Actor with the given id.
     kj::Maybe<Worker::Actor::Id> actorId;
+    // If set along with `actorId`, back the actor's storage with an in-memory SQLite database
+    // rather than empty read-only storage.
+    bool actorSqlite = false;
+    // If set, observes the isolate, e.g. to count the isolate locks taken.
+    kj::Maybe<kj::Own<IsolateObserver>> isolateObserver;
   };
 
   TestFixture(SetupParams&& params = {});
@@ -88,6 +94,14 @@ struct TestFixture {
   // Performs HTTP request on the default module handler, and waits for full response.
   Response runRequest(kj::HttpMethod method, kj::StringPtr url, kj::StringPtr body);
 
+  // Delivers an HTTP GET request to the default module handler through a WorkerEntrypoint, as the
+  // server does, reporting to `observer`. Canceling the returned promise disconnects the client.
+  kj::Promise<void> startRequest(kj::StringPtr url, kj::Own<RequestObserver> observer);
+
+  const Worker::Isolate& getIsolate() const {
+    return *workerIsolate;
+  }
+
  private:
   kj::Maybe<kj::WaitScope&> waitScope;
   capnp::MallocMessageBuilder configArena;
@@ -97,6 +111,7 @@ struct TestFixture {
   kj::Own<kj::Timer> timer;
   kj::Own<TimerChannel> timerChannel;
   kj::Own<kj::EntropySource> entropySource;
+  kj::Maybe<kj::Own<SqliteDatabase::Vfs>> actorSqliteVfs;
   kj::Maybe<kj::Own<Worker::Actor>> actor;
   capnp::ByteStreamFactory byteStreamFactory;
   kj::HttpHeaderTable::Builder headerTableBuilder;
@@ -93,6 +93,13 @@ class RefcountedCanceler: public kj::Refcounted {
     return reason != kj::none;
   }
 
+  kj::Maybe<const kj::Exception&> getReason() const {
+    KJ_IF_SOME(ex, reason) {
+      return ex;
+    }
+    return kj::none;
+  }
+
   void addListener(Listener& listener) {
     listeners.add(listener);
   }
@@ -0,0 +1,59 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#include "histogram.h"
+
+#include <kj/test.h>
+
+namespace workerd::util {
+namespace {
+
+KJ_TEST("DurationHistogram buckets by powers of two microseconds") {
+  DurationHistogram histogram;
+  histogram.record(0 * kj::MICROSECONDS);
+  histogram.record(1 * kj::MICROSECONDS);
+  histogram.record(3 * kj::MICROSECONDS);
+  histogram.record(1 * kj::MILLISECONDS);
+
+  auto snapshot = histogram.snapshot();
+  KJ_EXPECT(snapshot.count == 4);
+  KJ_EXPECT(snapshot.buckets[0] == 1);
+  KJ_EXPECT(snapshot.buckets[1] == 1);  // [1us, 2us)
+  KJ_EXPECT(snapshot.buckets[2] == 1);  // [2us, 4us)
+  KJ_EXPECT(snapshot.buckets[10] == 1);  // [512us, 1024us)
+  KJ_EXPECT(snapshot.sum == 1004 * kj::MICROSECONDS);
+  KJ_EXPECT(snapshot.max == 1 * kj::MILLISECONDS);
+}
+
+KJ_TEST("DurationHistogram clamps outliers into the last bucket") {
+  DurationHistogram histogram;
+  histogram.record(365 * 24 * 3600 * kj::SECONDS);
+  histogram.record(-5 * kj::MICROSECONDS);
+
+  auto snapshot = histogram.snapshot();
+  KJ_EXPECT(snapshot.buckets[DurationHistogram::BUCKET_COUNT - 1] == 1);
+  KJ_EXPECT(snapshot.buckets[0] == 1);
+}
+
+KJ_TEST("DurationHistogram percentiles") {
+  DurationHistogram histogram;
+  KJ_EXPECT(histogram.snapshot().percentile(99) == 0 * kj::NANOSECONDS);
+
+  for (auto i KJ_UNUSED: kj::zeroTo(99)) {
+    histogram.record(10 * kj::MICROSECONDS);
+  }
+  histogram.record(100 * kj::MILLISECONDS);
+
+  auto snapshot = histogram.snapshot();
+  // 10us lands in [8us, 16us).
+  KJ_EXPECT(snapshot.percentile(50) == 16 * kj::MICROSECONDS);
+  KJ_EXPECT(snapshot.percentile(98) == 16 * kj::MICROSECONDS);
+  // The outlier's bucket bound is past the observed maximum, so the maximum is reported.
+  KJ_EXPECT(snapshot.percentile(100) == 100 * kj::MILLISECONDS);
+  KJ_EXPECT(snapshot.toJson() ==
+      "{\"count\":100,\"sumUs\":100990,\"p50Us\":16,\"p99Us\":100000,\"maxUs\":100000}");
+}
+
+}  // namespace
+}  // namespace workerd::util
@@ -0,0 +1,101 @@
+// Copyright (c) 2017-2022 Cloudflare, Inc.
+// Licensed under the Apache 2.0 license found in the LICENSE file or at:
+//     https://opensource.org/licenses/Apache-2.0
+
+#pragma once
+
+#include <kj/common.h>
+#include <kj/string.h>
+#include <kj/time.h>
+
+#include <atomic>
+
+namespace workerd::util {
+
+// A histogram of durations with fixed power-of-two buckets, measured in microseconds: bucket 0
+// counts durations under 1us, and bucket `i` counts durations in [2^(i-1), 2^i) microseconds.
+// The last bucket also absorbs anything longer.
+//
+// record() is a handful of relaxed atomic operations and never allocates, so a histogram can be
+// shared between threads and updated on hot paths (every lock acquisition, every event loop
+// turn). Readers take a snapshot, which is not atomic with respect to concurrent writers but is
+// good enough for metrics.
+class DurationHistogram {
+ public:
+  // 2^38 microseconds is over three days; nothing we measure should take longer.
+  static constexpr uint BUCKET_COUNT = 40;
+
+  DurationHistogram() = default;
+  KJ_DISALLOW_COPY_AND_MOVE(DurationHistogram);
+
+  void record(kj::Duration duration) {
+    int64_t us = duration / kj::MICROSECONDS;
+    if (us < 0) us = 0;
+    buckets[bucketFor(us)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sumUs.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t prevMax = maxUs.load(std::memory_order_relaxed);
+    while (static_cast<uint64_t>(us) > prevMax &&
+        !maxUs.compare_exchange_weak(prevMax, us, std::memory_order_relaxed)) {
+    }
+  }
+
+  // Exclusive upper bound of bucket `i`, i.e. the `le` label of a Prometheus histogram bucket.
+  static kj::Duration bucketUpperBound(uint i) {
+    return static_cast<int64_t>(1ull << i) * kj::MICROSECONDS;
+  }
+
+  struct Snapshot {
+    uint64_t buckets[BUCKET_COUNT] = {};
+    uint64_t count = 0;
+    kj::Duration sum = 0 * kj::NANOSECONDS;
+    kj::Duration max = 0 * kj::NANOSECONDS;
+
+    // Estimates the given percentile (0-100) as the upper bound of the bucket containing it,
+    // capped at the observed maximum.
+    kj::Duration percentile(double p) const {
+      if (count == 0) return 0 * kj::NANOSECONDS;
+      uint64_t rank = static_cast<uint64_t>(p / 100.0 * count);
+      if (rank >= count) rank = count - 1;
+      uint64_t seen = 0;
+      for (uint i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i];
+        if (seen > rank) return kj::min(bucketUpperBound(i), max);
+      }
+      return max;
+    }
+
+    // Renders as a single-line JSON object, for structured logs.
+    kj::String toJson() const {
+      return kj::str("{\"count\":", count, ",\"sumUs\":", sum / kj::MICROSECONDS,
+          ",\"p50Us\":", percentile(50) / kj::MICROSECONDS, ",\"p99Us\":",
+          percentile(99) / kj::MICROSECONDS, ",\"maxUs\":", max / kj::MICROSECONDS, "}");
+    }
+  };
+
+  Snapshot snapshot() const {
+    Snapshot result;
+    for (uint i = 0; i < BUCKET_COUNT; i++) {
+      result.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+    }
+    result.count = count.load(std::memory_order_relaxed);
+    result.sum = static_cast<int64_t>(sumUs.load(std::memory_order_relaxed)) * kj::MICROSECONDS;
+    result.max = static_cast<int64_t>(maxUs.load(std::memory_order_relaxed)) * kj::MICROSECONDS;
+    return result;
+  }
+
+ private:
+  std::atomic<uint64_t> buckets[BUCKET_COUNT] = {};
+  std::atomic<uint64_t> count = 0;
+  std::atomic<uint64_t> sumUs = 0;
+  std::atomic<uint64_t> maxUs = 0;
+
+  static uint bucketFor(int64_t us) {
+    if (us == 0) return 0;
+    uint bits = 64 - __builtin_clzll(static_cast<uint64_t>(us));
+    return kj::min(bits, BUCKET_COUNT - 1);
+  }
+};
+
+}  // namespace workerd::util
@@ -7,7 +7,18 @@
 // recommended in the full perfetto header (perfetto/tracing.h).
 #include "perfetto/tracing/track_event.h"
 
-PERFETTO_DEFINE_CATEGORIES_IN_NAMESPACE(workerd::traces, perfetto::Category("workerd"));
+// "workerd" covers server and worker lifecycle events. The finer-grained categories below follow
+// a single request through the runtime; they are linked into one flow per incoming request (see
+// IoContext::getPerfettoFlowId()) so each can be enabled on its own, or all with "workerd.*".
+PERFETTO_DEFINE_CATEGORIES_IN_NAMESPACE(workerd::traces,
+    perfetto::Category("workerd"),
+    perfetto::Category("workerd.io").SetDescription(
+        "Request delivery and JavaScript execution within an IoContext"),
+    perfetto::Category("workerd.lock").SetDescription("Waiting for the isolate lock"),
+    perfetto::Category("workerd.subrequest").SetDescription("Outgoing subrequests"),
+    perfetto::Category("workerd.rpc").SetDescription("JS RPC calls, both outgoing and incoming"),
+    perfetto::Category("workerd.storage").SetDescription(
+        "Durable Object storage operations and flushes"));
 
 namespace kj {
 class StringPtr;